@@ -0,0 +1,257 @@
+#include "FileFormats/2da.hpp"
+#include "FileFormats/Bif.hpp"
+#include "FileFormats/Erf.hpp"
+#include "FileFormats/Gff.hpp"
+#include "FileFormats/Key.hpp"
+#include "FileFormats/Tlk.hpp"
+#include "Utility/Assert.hpp"
+
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <string>
+
+#if OS_WINDOWS
+    #include <malloc.h>
+#endif
+
+// Every allocation made through the global operator new is counted here, so loading a file straight from the heap
+// can be compared with loading it from a monotonic arena - which only goes to the heap for each block it grows by.
+namespace {
+
+std::atomic<std::size_t> s_Allocations { 0 };
+
+}
+
+void* operator new(std::size_t size)
+{
+    ++s_Allocations;
+
+    if (void* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// The memory resources in the standard library allocate with the aligned forms.
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++s_Allocations;
+    std::size_t align = static_cast<std::size_t>(alignment);
+
+#if OS_WINDOWS
+    void* ptr = _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc wants a size which is a multiple of the alignment.
+    void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align));
+#endif
+
+    if (ptr)
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+#if OS_WINDOWS
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(ptr, alignment);
+}
+
+namespace {
+
+// Loads the file and builds its friendly form, allocating both from the resource.
+using LoadFunc = bool(*)(char const* path, std::pmr::memory_resource* resource);
+
+bool LoadKey(char const* path, std::pmr::memory_resource* resource)
+{
+    using namespace FileFormats::Key;
+    Raw::Key rawKey(resource);
+
+    if (!Raw::Key::ReadFromFile(path, &rawKey))
+    {
+        return false;
+    }
+
+    Friendly::Key key(rawKey, resource);
+    return true;
+}
+
+bool LoadBif(char const* path, std::pmr::memory_resource* resource)
+{
+    using namespace FileFormats::Bif;
+    Raw::Bif rawBif(resource);
+
+    if (!Raw::Bif::ReadFromFile(path, &rawBif))
+    {
+        return false;
+    }
+
+    Friendly::Bif bif(std::move(rawBif), resource);
+    return true;
+}
+
+bool LoadErf(char const* path, std::pmr::memory_resource* resource)
+{
+    using namespace FileFormats::Erf;
+    Raw::Erf rawErf(resource);
+
+    if (!Raw::Erf::ReadFromFile(path, &rawErf))
+    {
+        return false;
+    }
+
+    Friendly::Erf erf(std::move(rawErf), resource);
+    return true;
+}
+
+bool LoadTlk(char const* path, std::pmr::memory_resource* resource)
+{
+    using namespace FileFormats::Tlk;
+    Raw::Tlk rawTlk(resource);
+
+    if (!Raw::Tlk::ReadFromFile(path, &rawTlk))
+    {
+        return false;
+    }
+
+    Friendly::Tlk tlk(rawTlk, resource);
+    return true;
+}
+
+bool LoadTwoDA(char const* path, std::pmr::memory_resource* resource)
+{
+    using namespace FileFormats::TwoDA;
+    Raw::TwoDA raw2da(resource);
+
+    if (!Raw::TwoDA::ReadFromFile(path, &raw2da))
+    {
+        return false;
+    }
+
+    Friendly::TwoDA twoda(raw2da, resource);
+    return true;
+}
+
+bool LoadGff(char const* path, std::pmr::memory_resource* resource)
+{
+    using namespace FileFormats::Gff;
+    Raw::Gff rawGff(resource);
+
+    if (!Raw::Gff::ReadFromFile(path, &rawGff))
+    {
+        return false;
+    }
+
+    Friendly::Gff gff(rawGff, nullptr, resource);
+    return true;
+}
+
+// Picks the loader by extension. Anything else is taken to be a GFF, which has a dozen extensions of its own.
+LoadFunc LoaderForPath(char const* path)
+{
+    char const* dot = std::strrchr(path, '.');
+    std::string extension = dot ? dot + 1 : "";
+
+    for (char& c : extension)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    if (extension == "key")
+    {
+        return &LoadKey;
+    }
+
+    if (extension == "bif")
+    {
+        return &LoadBif;
+    }
+
+    if (extension == "erf" || extension == "hak" || extension == "mod" || extension == "sav")
+    {
+        return &LoadErf;
+    }
+
+    if (extension == "tlk")
+    {
+        return &LoadTlk;
+    }
+
+    if (extension == "2da")
+    {
+        return &LoadTwoDA;
+    }
+
+    return &LoadGff;
+}
+
+int AllocationsExample(char const* path)
+{
+    LoadFunc load = LoaderForPath(path);
+
+    std::size_t before = s_Allocations;
+    bool loaded = load(path, std::pmr::new_delete_resource());
+    std::size_t heapAllocations = s_Allocations - before;
+
+    if (!loaded)
+    {
+        std::printf("Failed to load %s.\n", path);
+        return 1;
+    }
+
+    before = s_Allocations;
+
+    {
+        // Everything the load allocates is released in one go when the arena goes out of scope.
+        std::pmr::monotonic_buffer_resource arena(std::pmr::new_delete_resource());
+        loaded = load(path, &arena);
+        ASSERT(loaded);
+    }
+
+    std::size_t arenaAllocations = s_Allocations - before;
+
+    std::printf("%s: %zu allocations from the heap, %zu from an arena\n", path, heapAllocations, arenaAllocations);
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    ASSERT(argc >= 2);
+    int result = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        result |= AllocationsExample(argv[i]);
+    }
+
+    return result;
+}
@@ -31,11 +31,15 @@ int BifExample(char* path)
 
     std::printf("\nResources:\n");
 
-    for (auto const& kvp : bif.GetResources())
+    for (std::uint32_t id = 0; id < bif.GetResources().size(); ++id)
     {
-        // kvp.first = id
-        // kvp.second = Friendly::BifResource
-        std::printf("\n%s [%u | %u]: %zu bytes", StringFromResourceType(kvp.second.m_ResType), kvp.first, kvp.second.m_ResId, kvp.second.m_DataBlock->GetDataLength());
+        if (!bif.HasResource(id))
+        {
+            continue;
+        }
+
+        Friendly::BifResource const& res = bif.GetResources()[id];
+        std::printf("\n%s [%u | %u]: %zu bytes", StringFromResourceType(res.m_ResType), id, res.m_ResId, bif.GetResourceData(res).size());
     }
 
     return 0;
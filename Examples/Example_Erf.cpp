@@ -24,7 +24,7 @@ int ErfExample(char* path)
 
     Friendly::Erf erf(std::move(rawErf));
 
-    std::vector<Raw::ErfLocalisedString> const& descriptions = erf.GetDescriptions();
+    std::pmr::vector<Raw::ErfLocalisedString> const& descriptions = erf.GetDescriptions();
 
     if (descriptions.empty())
     {
@@ -41,7 +41,9 @@ int ErfExample(char* path)
     for (Friendly::ErfResource const& resource : erf.GetResources())
     {
         const char* resType = FileFormats::Resource::StringFromResourceType(resource.m_ResType);
-        std::printf("\n %s.%s: %zu bytes [%u] ", resource.m_ResRef.c_str(), resType, resource.m_DataBlock->GetDataLength(), resource.m_ResourceId);
+        std::string_view resref = resource.m_ResRef.GetString();
+        std::printf("\n %.*s.%s: %zu bytes [%u] ", static_cast<int>(resref.size()), resref.data(), resType,
+            resource.m_DataBlock->GetDataLength(), resource.m_ResourceId);
     }
 
     return 0;
@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <cinttypes>
+#include <string>
 
 namespace {
 
@@ -57,25 +58,25 @@ using namespace FileFormats::Gff::Friendly;
 
 void GffExamplePrintVarsAndTag(Gff const& gff)
 {
-    Type_CExoString tag;
+    // GetField and the string_view overload of ReadField point into the Gff rather than copying the value out.
+    std::string_view tag;
     if (gff.GetTopLevelStruct().ReadField("Tag", &tag))
     {
-        std::printf("\nTag: %s\n", tag.m_String.c_str());
+        std::printf("\nTag: %.*s\n", static_cast<int>(tag.size()), tag.data());
     }
 
-    Type_List varTable;
-    if (gff.GetTopLevelStruct().ReadField("VarTable", &varTable))
+    if (Type_List const* varTable = gff.GetTopLevelStruct().GetField<Type_List>("VarTable"))
     {
-        std::vector<Type_Struct> const& entries = varTable.GetStructs();
+        std::pmr::vector<Type_Struct> const& entries = varTable->GetStructs();
 
         for (std::size_t i = 0; i < entries.size(); ++i)
         {
             GffStruct const& entry = entries[i];
             std::printf("\nVariable #%zu\n", i);
 
-            Type_CExoString name;
+            std::string_view name;
             entry.ReadField("Name", &name);
-            std::printf(" Name: %s\n", name.m_String.c_str());
+            std::printf(" Name: %.*s\n", static_cast<int>(name.size()), name.data());
 
             Type_DWORD type;
             entry.ReadField("Type", &type);
@@ -95,9 +96,9 @@ void GffExamplePrintVarsAndTag(Gff const& gff)
             }
             else if (type == 3)
             {
-                Type_CExoString value;
+                std::string_view value;
                 entry.ReadField("Value", &value);
-                std::printf(" Value: %s\n", value.m_String.c_str());
+                std::printf(" Value: %.*s\n", static_cast<int>(value.size()), value.data());
             }
             else if (type == 4)
             {
@@ -128,127 +129,127 @@ void GffExamplePrintGff_r(GffStruct const& element, int depth)
 
     for (auto const& kvp : element.GetFields())
     {
-        // kvp.first = field name
-        // kvp.second.first = Raw::GffField::Type
-        // kvp.second.second = std::any (we don't care about this one as ReadField will extract for us.
+        // kvp.first = field name (GffFieldLabel)
+        // kvp.second = GffFieldValue - GetType() returns the Raw::GffField::Type, and ReadField will extract the value for us.
+        std::string label(kvp.first.GetString());
 
-        if (kvp.second.first == Raw::GffField::Type::BYTE)
+        if (kvp.second.GetType() == Raw::GffField::Type::BYTE)
         {
             Type_BYTE value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [BYTE] %u", depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [BYTE] %u", depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::CHAR)
+        else if (kvp.second.GetType() == Raw::GffField::Type::CHAR)
         {
             Type_CHAR value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [CHAR] %c", depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [CHAR] %c", depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::WORD)
+        else if (kvp.second.GetType() == Raw::GffField::Type::WORD)
         {
             Type_WORD value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [WORD] %u", depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [WORD] %u", depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::SHORT)
+        else if (kvp.second.GetType() == Raw::GffField::Type::SHORT)
         {
             Type_SHORT value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [SHORT] %d", depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [SHORT] %d", depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::DWORD)
+        else if (kvp.second.GetType() == Raw::GffField::Type::DWORD)
         {
             Type_DWORD value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [DWORD] %u", depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [DWORD] %u", depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::INT)
+        else if (kvp.second.GetType() == Raw::GffField::Type::INT)
         {
             Type_INT value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [INT] %d", depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [INT] %d", depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::DWORD64)
+        else if (kvp.second.GetType() == Raw::GffField::Type::DWORD64)
         {
             Type_DWORD64 value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [DWORD64] %" PRIu64, depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [DWORD64] %" PRIu64, depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::INT64)
+        else if (kvp.second.GetType() == Raw::GffField::Type::INT64)
         {
             Type_INT64 value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [INT64] %" PRId64, depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [INT64] %" PRId64, depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::FLOAT)
+        else if (kvp.second.GetType() == Raw::GffField::Type::FLOAT)
         {
             Type_FLOAT value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [FLOAT] %f", depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [FLOAT] %f", depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::DOUBLE)
+        else if (kvp.second.GetType() == Raw::GffField::Type::DOUBLE)
         {
             Type_DOUBLE value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [DOUBLE] %f", depth, ' ', kvp.first.c_str(), value);
+            std::printf("\n%*c%s: [DOUBLE] %f", depth, ' ', label.c_str(), value);
         }
-        else if (kvp.second.first == Raw::GffField::Type::CExoString)
+        else if (kvp.second.GetType() == Raw::GffField::Type::CExoString)
         {
             Type_CExoString value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [CExoString] %s", depth, ' ', kvp.first.c_str(), value.m_String.c_str());
+            std::printf("\n%*c%s: [CExoString] %s", depth, ' ', label.c_str(), value.m_String.c_str());
         }
-        else if (kvp.second.first == Raw::GffField::Type::ResRef)
+        else if (kvp.second.GetType() == Raw::GffField::Type::ResRef)
         {
             Type_CResRef value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [ResRef] %.*s", depth, ' ', kvp.first.c_str(), value.m_Size, value.m_String);
+            std::printf("\n%*c%s: [ResRef] %.*s", depth, ' ', label.c_str(), value.m_Size, value.m_String);
         }
-        else if (kvp.second.first == Raw::GffField::Type::CExoLocString)
+        else if (kvp.second.GetType() == Raw::GffField::Type::CExoLocString)
         {
             Type_CExoLocString value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [CExoLocString] StrRef: %u, SubString count: %zu", depth, ' ', kvp.first.c_str(), value.m_StringRef, value.m_SubStrings.size());
+            std::printf("\n%*c%s: [CExoLocString] StrRef: %u, SubString count: %zu", depth, ' ', label.c_str(), value.m_StringRef, value.m_SubStrings.size());
 
             for (std::size_t i = 0; i < value.m_SubStrings.size(); ++i)
             {
                 Type_CExoLocString::SubString const& substring = value.m_SubStrings[i];
-                std::printf("\n%*c%s #%zu:", depth, ' ', kvp.first.c_str(), i);
+                std::printf("\n%*c%s #%zu:", depth, ' ', label.c_str(), i);
                 std::printf("\n%*cStringID: %u", depth + 1, ' ', substring.m_StringID);
                 std::printf("\n%*cString: %s", depth + 1, ' ', substring.m_String.c_str());
             }
         }
-        else if (kvp.second.first == Raw::GffField::Type::VOID)
+        else if (kvp.second.GetType() == Raw::GffField::Type::VOID)
         {
             Type_VOID value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [VOID] Binary size: %zu", depth, ' ', kvp.first.c_str(), value.m_Data.size());
+            std::printf("\n%*c%s: [VOID] Binary size: %zu", depth, ' ', label.c_str(), value.m_Data.size());
         }
-        else if (kvp.second.first == Raw::GffField::Type::Struct)
+        else if (kvp.second.GetType() == Raw::GffField::Type::Struct)
         {
             Type_Struct value;
             element.ReadField(kvp, &value);
-            std::printf("\n%*c%s: [Struct] Field count: %zu", depth, ' ', kvp.first.c_str(), value.GetFields().size());
+            std::printf("\n%*c%s: [Struct] Field count: %zu", depth, ' ', label.c_str(), value.GetFields().size());
 
             GffExamplePrintGff_r(value, depth + 1);
         }
-        else if (kvp.second.first == Raw::GffField::Type::List)
+        else if (kvp.second.GetType() == Raw::GffField::Type::List)
         {
             Type_List value;
             element.ReadField(kvp, &value);
 
-            std::vector<GffStruct> const& structs = value.GetStructs();
-            std::printf("\n%*c%s: [List] Struct count: %zu", depth, ' ', kvp.first.c_str(), structs.size());
+            std::pmr::vector<GffStruct> const& structs = value.GetStructs();
+            std::printf("\n%*c%s: [List] Struct count: %zu", depth, ' ', label.c_str(), structs.size());
 
             for (std::size_t i = 0; i < structs.size(); ++i)
             {
-                std::printf("\n%*c%s #%zu:", depth, ' ', kvp.first.c_str(), i);
+                std::printf("\n%*c%s #%zu:", depth, ' ', label.c_str(), i);
                 GffExamplePrintGff_r(structs[i], depth + 1);
             }
         }
         else
         {
-            std::printf("\n%*c%s: Unknown gff type: %u", depth, ' ', kvp.first.c_str(), static_cast<std::uint32_t>(kvp.second.first));
+            std::printf("\n%*c%s: Unknown gff type: %u", depth, ' ', label.c_str(), static_cast<std::uint32_t>(kvp.second.GetType()));
             ASSERT_FAIL();
         }
     }
@@ -38,8 +38,9 @@ int KeyExample(char* path)
     {
         ASSERT(res.m_ReferencedBifIndex < key.GetReferencedBifs().size());
         const char* resType = FileFormats::Resource::StringFromResourceType(res.m_ResType);
-        std::string const& bifPath = key.GetReferencedBifs()[res.m_ReferencedBifIndex].m_Path;
-        std::printf("\n %s.%s %s [%zu (%u) | %u] ", res.m_ResRef.c_str(), resType, bifPath.c_str(),
+        std::pmr::string const& bifPath = key.GetReferencedBifs()[res.m_ReferencedBifIndex].m_Path;
+        std::string_view resref = res.m_ResRef.GetString();
+        std::printf("\n %.*s.%s %s [%zu (%u) | %u] ", static_cast<int>(resref.size()), resref.data(), resType, bifPath.c_str(),
             res.m_ReferencedBifIndex, res.m_ReferencedBifResId, res.m_ResId);
     }
 
@@ -13,6 +13,8 @@
 // - You can iterate over the collection: refer to Example_2da.cpp.
 // - You can extract the string, int, or float representation with the appropriate functions.
 //
+// Both the raw and friendly TwoDA can allocate from a std::pmr::memory_resource given on construction.
+//
 // For further information refer to https://wiki.neverwintervault.org/pages/viewpage.action?pageId=327727
 // Specifically, https://wiki.neverwintervault.org/download/attachments/327727/Bioware_Aurora_2DA_Format.pdf?api=v2
 
@@ -4,11 +4,11 @@
 namespace FileFormats::TwoDA::Friendly {
 
 TwoDARow::TwoDARow(std::uint32_t rowId,
-    std::vector<TwoDAEntry>&& data,
-    std::unordered_map<std::string, std::size_t> const& columns)
+    std::pmr::vector<TwoDAEntry>&& data,
+    TwoDAColumnNames const& columns)
     : m_RowId(rowId),
       m_ColumnNames(columns),
-      m_Data(std::forward<std::vector<TwoDAEntry>>(data))
+      m_Data(std::forward<std::pmr::vector<TwoDAEntry>>(data))
 {
 }
 
@@ -108,7 +108,9 @@ std::size_t TwoDARow::Size() const
     return m_Data.size();
 }
 
-TwoDA::TwoDA(Raw::TwoDA const& raw2da)
+TwoDA::TwoDA(Raw::TwoDA const& raw2da, std::pmr::memory_resource* resource)
+    : m_Rows(resource),
+      m_ColumnNames(resource)
 {
     // Line 1 we don't care about ...
     // Line 2 has default values. TODO
@@ -118,15 +120,15 @@ TwoDA::TwoDA(Raw::TwoDA const& raw2da)
     // Iterate over all of the column names and set up the map.
     for (std::size_t i = 0; i < raw2da.m_Lines[2].m_Tokens.size(); ++i)
     {
-        std::string const& token = raw2da.m_Lines[2].m_Tokens[i];
-        m_ColumnNames[token] = i;
+        Raw::TwoDAToken const& token = raw2da.m_Lines[2].m_Tokens[i];
+        m_ColumnNames[std::string(token)] = i;
     }
 
     // Iterate over all of the entries and set them up.
     for (std::size_t i = 3; i < raw2da.m_Lines.size(); ++i)
     {
-        std::vector<TwoDAEntry> entries;
-        std::vector<Raw::TwoDAToken> const& tokens = raw2da.m_Lines[i].m_Tokens;
+        std::pmr::vector<TwoDAEntry> entries(resource);
+        std::pmr::vector<Raw::TwoDAToken> const& tokens = raw2da.m_Lines[i].m_Tokens;
 
         if (tokens.empty())
         {
@@ -136,9 +138,11 @@ TwoDA::TwoDA(Raw::TwoDA const& raw2da)
 
         // We store the row ID - this isn't necessarily to be used by the user,
         // but could store funky stuff that we might want to access.
-        std::uint32_t rowId = std::stoul(tokens[0]);
+        std::uint32_t rowId = std::stoul(std::string(tokens[0]));
 
         // Skip the first token (which is the row number) when setting this up.
+        entries.reserve(m_ColumnNames.size());
+
         for (std::size_t j = 1; j < m_ColumnNames.size() + 1; ++j)
         {
             TwoDAEntry entry;
@@ -202,7 +206,7 @@ TwoDARow& TwoDA::operator[](std::size_t row)
     std::size_t rowsToAdd = row - rowSize;
     for (std::size_t i = 0; i <= rowsToAdd; ++i)
     {
-        std::vector<TwoDAEntry> entries;
+        std::pmr::vector<TwoDAEntry> entries(m_Rows.get_allocator().resource());
 
         for (std::size_t j = 1; j < m_ColumnNames.size() + 1; ++j)
         {
@@ -244,7 +248,7 @@ std::size_t TwoDA::Size() const
     return m_Rows.size();
 }
 
-std::unordered_map<std::string, std::size_t> const& TwoDA::GetColumnNames() const
+TwoDAColumnNames const& TwoDA::GetColumnNames() const
 {
     return m_ColumnNames;
 }
@@ -2,6 +2,7 @@
 
 #include "FileFormats/2da/2da_Raw.hpp"
 
+#include <memory_resource>
 #include <unordered_map>
 
 namespace FileFormats::TwoDA::Friendly {
@@ -15,12 +16,14 @@ struct TwoDAEntry
     bool m_IsEmpty;
 };
 
+using TwoDAColumnNames = std::pmr::unordered_map<std::string, std::size_t>;
+
 class TwoDARow
 {
 public:
     TwoDARow(std::uint32_t rowId,
-        std::vector<TwoDAEntry>&& data,
-        std::unordered_map<std::string, std::size_t> const& columns);
+        std::pmr::vector<TwoDAEntry>&& data,
+        TwoDAColumnNames const& columns);
 
     // Operator[] returns the column directly.
     // Out-of-range access is not supported at this time.
@@ -44,7 +47,7 @@ public:
 
     std::uint32_t RowId() const;
 
-    using TwoDAEntries = std::vector<TwoDAEntry>;
+    using TwoDAEntries = std::pmr::vector<TwoDAEntry>;
     TwoDAEntries::iterator begin();
     TwoDAEntries::iterator end();
     TwoDAEntries::const_iterator begin() const;
@@ -53,14 +56,16 @@ public:
 
 private:
     std::uint32_t m_RowId;
-    std::unordered_map<std::string, std::size_t> const& m_ColumnNames;
-    std::vector<TwoDAEntry> m_Data;
+    TwoDAColumnNames const& m_ColumnNames;
+    TwoDAEntries m_Data;
 };
 
 class TwoDA
 {
 public:
-    TwoDA(Raw::TwoDA const& raw2da);
+    // The rows, their entries and the column map are allocated from the resource, which must outlive the TwoDA.
+    // The entry strings themselves are still allocated from the heap when they don't fit inline.
+    TwoDA(Raw::TwoDA const& raw2da, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     // These functions can be used to extract the value as the specified type.
     std::string const& AsStr(std::size_t row, std::size_t column) const;
@@ -77,7 +82,7 @@ public:
     TwoDARow& operator[](std::size_t row);
 
     // This is just a flat vector of rows.
-    using TwoDARows = std::vector<TwoDARow>;
+    using TwoDARows = std::pmr::vector<TwoDARow>;
     TwoDARows::iterator begin();
     TwoDARows::iterator end();
     TwoDARows::const_iterator begin() const;
@@ -85,13 +90,13 @@ public:
     std::size_t Size() const;
 
     // The column map is a map, where the index contains the name of the column.
-    std::unordered_map<std::string, std::size_t> const& GetColumnNames() const;
+    TwoDAColumnNames const& GetColumnNames() const;
 
     bool WriteToFile(char const* path) const;
 
 private:
     TwoDARows m_Rows;
-    std::unordered_map<std::string, std::size_t> m_ColumnNames;
+    TwoDAColumnNames m_ColumnNames;
 };
 
 }
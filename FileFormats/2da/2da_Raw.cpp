@@ -1,5 +1,6 @@
 #include "FileFormats/2da/2da_Raw.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/FileReader.hpp"
 #include "Utility/MemoryMappedFile.hpp"
 
 #include <algorithm>
@@ -8,6 +9,9 @@
 
 namespace FileFormats::TwoDA::Raw {
 
+TwoDA::TwoDA(std::pmr::memory_resource* resource) : m_Lines(resource)
+{ }
+
 bool TwoDA::ReadFromBytes(std::byte const* bytes, std::size_t bytesCount, TwoDA* out)
 {
     ASSERT(bytes);
@@ -22,13 +26,19 @@ bool TwoDA::ReadFromByteVector(std::vector<std::byte>&& bytes, TwoDA* out)
     return out->ConstructInternal(bytes.data(), bytes.size());
 }
 
-bool TwoDA::ReadFromFile(char const* path, TwoDA* out)
+bool TwoDA::ReadFromFile(char const* path, TwoDA* out, FileReadOptions const& options)
 {
     ASSERT(path);
     ASSERT(out);
 
+    if (options.m_Backend != FileReadBackend::MemoryMap)
+    {
+        std::vector<std::byte> bytes;
+        return ReadEntireFile(path, &bytes) && ReadFromByteVector(std::move(bytes), out);
+    }
+
     MemoryMappedFile memmap;
-    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap);
+    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap, options.m_Hints);
 
     if (!loaded)
     {
@@ -67,7 +77,7 @@ bool TwoDA::WriteToFile(char const* path) const
                 const TwoDALine& line = m_Lines[i];
                 if (j < line.m_Tokens.size())
                 {
-                    const std::string& token = line.m_Tokens[j];
+                    const TwoDAToken& token = line.m_Tokens[j];
                     std::size_t tokenSize = token.size();
                     if (token.find(" ") != std::string::npos)
                     {
@@ -136,11 +146,13 @@ bool TwoDA::ConstructInternal(std::byte const* bytes, std::size_t bytesCount)
     // It is possible to do all the parsing in-place but it is difficult to handle the edge cases
     // where the spec has been violated (e.g. wrong line endings, tab characters, pointless trailing white space).
 
-    std::vector<char> flattenedLines;
+    std::pmr::memory_resource* resource = m_Lines.get_allocator().resource();
+
+    std::pmr::vector<char> flattenedLines(resource);
     flattenedLines.resize(bytesCount);
     std::memcpy(flattenedLines.data(), bytes, bytesCount);
 
-    std::vector<std::string> lines;
+    std::pmr::vector<std::pmr::string> lines(resource);
 
     // First pass - split into lines.
 
@@ -149,7 +161,7 @@ bool TwoDA::ConstructInternal(std::byte const* bytes, std::size_t bytesCount)
         *tail = head; head < end;)
     {
         while (*head++ != '\n' && head < end) {}
-        lines.emplace_back(std::string(tail, head - tail));
+        lines.emplace_back(tail, head - tail);
         tail = head++;
     }
 
@@ -160,7 +172,7 @@ bool TwoDA::ConstructInternal(std::byte const* bytes, std::size_t bytesCount)
     // 2. Remove /r
     // 3. Remove /n
 
-    for (std::string& line : lines)
+    for (std::pmr::string& line : lines)
     {
         for (auto iter = std::rbegin(line); iter != std::rend(line); ++iter)
         {
@@ -180,9 +192,9 @@ bool TwoDA::ConstructInternal(std::byte const* bytes, std::size_t bytesCount)
     // Third pass - now that we have lines set up, we can tokenize them.
     // Anything surrounded by quotes is allowed whitespace, otherwise whitespace is the delimiter.
 
-    for (const std::string& line : lines)
+    for (const std::pmr::string& line : lines)
     {
-        TwoDALine twoDALine;
+        TwoDALine twoDALine { std::pmr::vector<TwoDAToken>(resource) };
 
         for (auto head = std::cbegin(line),
             end = std::cend(line), tail = head;
@@ -221,7 +233,7 @@ bool TwoDA::ConstructInternal(std::byte const* bytes, std::size_t bytesCount)
                     finalHead -= 1;
                 }
 
-                twoDALine.m_Tokens.emplace_back(std::string(finalTail, finalHead));
+                twoDALine.m_Tokens.emplace_back(finalTail, finalHead);
             }
 
             tail = head;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Utility/FileReader.hpp"
+
 #include <cstddef>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -49,7 +52,7 @@ namespace FileFormats::TwoDA::Raw {
 // indicate that the read attempt failed so that that application knows that the entry value is no ordinary ""
 // or 0.
 
-using TwoDAToken = std::string;
+using TwoDAToken = std::pmr::string;
 
 struct TwoDALine
 {
@@ -75,11 +78,17 @@ struct TwoDALine
     // All columns after the first one must have a heading. The heading can be in upper or lower case letters
     // and may contain underscores.
 
-    std::vector<TwoDAToken> m_Tokens;
+    std::pmr::vector<TwoDAToken> m_Tokens;
 };
 
 struct TwoDA
 {
+    TwoDA() = default;
+
+    // The lines and their tokens are allocated from the resource when read into a TwoDA constructed with it, as is
+    // the scratch space used while parsing. The resource must outlive the TwoDA.
+    explicit TwoDA(std::pmr::memory_resource* resource);
+
     // Line 1 - file format version
     // The first line of a 2da file describes the version of the 2da format followed by the 2da file. The current
     // version header at the time of this writing is: 2DA V2.0
@@ -125,7 +134,7 @@ struct TwoDA
     // to belong to the next column. Because of how quotation marks are handled, a string entry in a 2da can
     // never contain actually quotation marks itself
 
-    std::vector<TwoDALine> m_Lines;
+    std::pmr::vector<TwoDALine> m_Lines;
 
     // Constructs a 2da from a non-owning pointer. Memory usage may be high.
     static bool ReadFromBytes(std::byte const* bytes, std::size_t bytesCount, TwoDA* out);
@@ -133,8 +142,9 @@ struct TwoDA
     // Constructs a 2da from a vector of bytes which we have taken ownership of. Memory usage will be moderate.
     static bool ReadFromByteVector(std::vector<std::byte>&& bytes, TwoDA* out);
 
-    // Constructs a 2da from a file. The file with be memory mapped so memory usage will be ideal.
-    static bool ReadFromFile(char const* path, TwoDA* out);
+    // Constructs a 2da from a file. With the MemoryMap backend (the default) the file with be memory mapped so
+    // memory usage will be ideal - the other backends read the whole file into memory.
+    static bool ReadFromFile(char const* path, TwoDA* out, FileReadOptions const& options = FileReadOptions());
 
     // Writes the raw 2da to disk.
     bool WriteToFile(char const* path) const;
@@ -9,10 +9,13 @@
 // Step 1: Load your BIF file into memory.
 // Step 2: Construct a Bif as such: FileFormats::Bif::Raw::Bif::ReadFromBytes(bytes, totalBytes);
 // Step 3: If user friendly access is desired, construct a Bif from FileFormats::Bif::Friendly::Bif(rawBif).
-// - The resources can be accessed with .GetResources(). They are bucketed as such - resources[id] -> type / data.
+// - The resources can be accessed with .GetResources(). This is a flat table indexed by ID - resources[id] -> type /
+//   offset / size - which may have gaps; check with .HasResource(id). The data is accessed with .GetResourceData().
 // - Note that we ignore the fixed resource table in the friendly implementation.
 // - Refer to Example_Bif.cpp if the usage is unclear.
 //
+// Both the raw and friendly Bif can allocate their tables from a std::pmr::memory_resource given on construction.
+//
 // For further information refer to https://wiki.neverwintervault.org/pages/viewpage.action?pageId=327727
 // Specifically, https://wiki.neverwintervault.org/download/attachments/327727/Bioware_Aurora_KeyBIF_Format.pdf?api=v2
 
@@ -2,16 +2,22 @@
 #include "Utility/Assert.hpp"
 #include "Utility/DataBlock.hpp"
 
-#include <cstring>
+#include <algorithm>
 
 namespace FileFormats::Bif::Friendly {
 
-Bif::Bif(Raw::Bif const& rawBif)
+Bif::Bif(Raw::Bif const& rawBif, std::pmr::memory_resource* resource)
+    : m_OwnedData(rawBif.m_DataBlock->GetData(), rawBif.m_DataBlock->GetData() + rawBif.m_DataBlock->GetDataLength()),
+      m_Data(m_OwnedData.data()),
+      m_Resources(resource)
 {
     ConstructInternal(rawBif);
 }
 
-Bif::Bif(Raw::Bif&& rawBif) : m_RawBif(std::forward<Raw::Bif>(rawBif))
+Bif::Bif(Raw::Bif&& rawBif, std::pmr::memory_resource* resource)
+    : m_RawBif(std::forward<Raw::Bif>(rawBif)),
+      m_Data(m_RawBif->m_DataBlock->GetData()),
+      m_Resources(resource)
 {
     ConstructInternal(m_RawBif.value());
 }
@@ -25,53 +31,69 @@ void Bif::ConstructInternal(Raw::Bif const& rawBif)
     offsetToDataBlock += rawBif.m_VariableResourceTable.size() * sizeof(Raw::BifVariableResource);
     offsetToDataBlock += rawBif.m_FixedResourceTable.size() * sizeof(Raw::BifFixedResource);
 
+    // The spec outlines this the m_ReferencedBifResId as (x << 20) + y, where y is the index, and x = y normally and 0
+    // for patch BIFs. However, none of the BIFs present in 1.69 or 1.74 seem to follow this rule - x always equals y.
+    //
+    // There exists no entry that specifies x. In the spec, it also states that the game doesn't care about the mismatch
+    // between x and y.
+    //
+    // Therefore, I'm just going to do what the game does - mask out anything higher than 0x00003FFF
+    // (bottom fourteen bits) so we can just completely ignore the x value.
+    //
+    // We'll use this as the index into the BIF while maintaining the original ID as an entry field. In every BIF
+    // we've seen the indices run from zero without gaps, so this is normally exactly the size of the variable table.
+
+    std::uint32_t indexCount = 0;
+
     for (Raw::BifVariableResource const& rawRes : rawBif.m_VariableResourceTable)
     {
-        ASSERT(m_Resources.find(rawRes.m_Id) == std::end(m_Resources));
+        indexCount = std::max(indexCount, (rawRes.m_Id & 0x00003FFF) + 1);
+    }
 
-        BifResource res;
+    m_Resources.assign(indexCount, BifResource { 0, Resource::ResourceType::INVALID, 0, 0 });
 
-        res.m_ResId = rawRes.m_Id;
-        res.m_ResType = rawRes.m_ResourceType;
+    for (Raw::BifVariableResource const& rawRes : rawBif.m_VariableResourceTable)
+    {
+        std::uint32_t keyAddressableId = rawRes.m_Id & 0x00003FFF;
+        BifResource& res = m_Resources[keyAddressableId];
+        ASSERT(res.m_ResType == Resource::ResourceType::INVALID);
 
         std::size_t offsetToData = rawRes.m_Offset - offsetToDataBlock;
-        ASSERT(offsetToData + rawRes.m_FileSize <= rawBif.m_DataBlock->GetDataLength());
+        bool inBounds = rawRes.m_Offset >= offsetToDataBlock &&
+            offsetToData + rawRes.m_FileSize <= rawBif.m_DataBlock->GetDataLength();
+        ASSERT(inBounds);
 
-        if (m_RawBif.has_value())
-        {
-            std::unique_ptr<NonOwningDataBlock> db = std::make_unique<NonOwningDataBlock>();
-            db->m_Data = rawBif.m_DataBlock->GetData() + offsetToData;
-            db->m_DataLength = rawRes.m_FileSize;
-            res.m_DataBlock = std::move(db);
-        }
-        else
+        if (!inBounds)
         {
-            std::unique_ptr<OwningDataBlock> db = std::make_unique<OwningDataBlock>();
-            db->m_Data.resize(rawRes.m_FileSize);
-            std::memcpy(db->m_Data.data(), rawBif.m_DataBlock->GetData() + offsetToData, rawRes.m_FileSize);
-            res.m_DataBlock = std::move(db);
+            continue;
         }
 
-        // The spec outlines this the m_ReferencedBifResId as (x << 20) + y, where y is the index, and x = y normally and 0
-        // for patch BIFs. However, none of the BIFs present in 1.69 or 1.74 seem to follow this rule - x always equals y.
-        //
-        // There exists no entry that specifies x. In the spec, it also states that the game doesn't care about the mismatch
-        // between x and y.
-        //
-        // Therefore, I'm just going to do what the game does - mask out anything higher than 0x00003FFF
-        // (bottom fourteen bits) so we can just completely ignore the x value.
-        //
-        // We'll use this as the index into the BIF while maintaining the original ID as an entry field.
-
-        std::uint32_t keyAddressableId = rawRes.m_Id & 0x00003FFF;
-
-        m_Resources.insert(std::make_pair(keyAddressableId, std::move(res)));
+        res.m_ResId = rawRes.m_Id;
+        res.m_ResType = rawRes.m_ResourceType;
+        res.m_Offset = static_cast<std::uint32_t>(offsetToData);
+        res.m_Size = rawRes.m_FileSize;
     }
 }
 
-Bif::BifResourceMap const& Bif::GetResources() const
+Bif::BifResourceTable const& Bif::GetResources() const
 {
     return m_Resources;
 }
 
+bool Bif::HasResource(std::uint32_t id) const
+{
+    return id < m_Resources.size() && m_Resources[id].m_ResType != Resource::ResourceType::INVALID;
+}
+
+Span<std::byte const> Bif::GetResourceData(BifResource const& resource) const
+{
+    return { m_Data + resource.m_Offset, resource.m_Size };
+}
+
+Span<std::byte const> Bif::GetResourceData(std::uint32_t id) const
+{
+    ASSERT(HasResource(id));
+    return GetResourceData(m_Resources[id]);
+}
+
 }
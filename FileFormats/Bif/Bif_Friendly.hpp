@@ -1,10 +1,11 @@
 #pragma once
 
 #include "FileFormats/Bif/Bif_Raw.hpp"
+#include "Utility/Span.hpp"
 
-#include <memory>
+#include <memory_resource>
 #include <optional>
-#include <unordered_map>
+#include <vector>
 
 namespace FileFormats::Bif::Friendly {
 
@@ -13,11 +14,13 @@ struct BifResource
     // The actual ID listed in the BIF.
     std::uint32_t m_ResId;
 
-    // The resource type.
+    // The resource type. This is ResourceType::INVALID for a gap in the table - an index no resource in the BIF has.
     Resource::ResourceType m_ResType;
 
-    // The underlying data for this resource.
-    std::unique_ptr<DataBlock> m_DataBlock;
+    // Where the data for this resource is, relative to the start of the BIF's data block.
+    // Use Bif::GetResourceData to access it.
+    std::uint32_t m_Offset;
+    std::uint32_t m_Size;
 };
 
 // This is a user friendly wrapper around the Bif data.
@@ -26,23 +29,39 @@ class Bif
 {
 public:
     // This constructs a friendly BIF from a raw BIF.
-    Bif(Raw::Bif const& rawBif);
+    // The data block is copied once, in one piece. The resource table is allocated from the resource, which must
+    // outlive the Bif.
+    Bif(Raw::Bif const& rawBif, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     // This constructs a friendly BIF from a raw BIF whose ownership has been passed to us.
-    // If ownership of the Bif is passed to us, we construct streamed resources, thus lowering
-    // the memory usage significantly.
-    Bif(Raw::Bif&& rawBif);
+    // If ownership of the Bif is passed to us, the resources point into its data rather than a copy of it, thus
+    // lowering the memory usage significantly.
+    Bif(Raw::Bif&& rawBif, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
-    using BifResourceMap = std::unordered_map<std::uint32_t, BifResource>;
-    BifResourceMap const& GetResources() const;
+    // The resources, indexed by the ID the KEY refers to them with (see the .cpp for how that relates to m_ResId).
+    // Check for gaps with HasResource.
+    using BifResourceTable = std::pmr::vector<BifResource>;
+    BifResourceTable const& GetResources() const;
+
+    bool HasResource(std::uint32_t id) const;
+
+    // Returns the data of the resource. This points into the Bif and is valid for as long as it is.
+    Span<std::byte const> GetResourceData(BifResource const& resource) const;
+    Span<std::byte const> GetResourceData(std::uint32_t id) const;
 
 private:
     std::optional<Raw::Bif> m_RawBif;
 
+    // The copy of the data block made when we don't own the raw BIF.
+    std::vector<std::byte> m_OwnedData;
+
+    // The start of the data block - either in m_RawBif or m_OwnedData.
+    std::byte const* m_Data;
+
     void ConstructInternal(Raw::Bif const& rawBif);
 
     // This maps between ID -> { BifResource }
-    BifResourceMap m_Resources;
+    BifResourceTable m_Resources;
 };
 
 }
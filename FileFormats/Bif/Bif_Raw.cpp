@@ -1,5 +1,6 @@
 #include "FileFormats/Bif/Bif_Raw.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/FileReader.hpp"
 #include "Utility/MemoryMappedFile.hpp"
 #include "Utility/RAIIWrapper.hpp"
 
@@ -9,8 +10,8 @@ namespace FileFormats::Bif::Raw {
 
 namespace {
 
-template <typename T>
-void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T>& out)
+template <typename T, typename Allocator>
+void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T, Allocator>& out)
 {
     out.resize(count);
     std::memcpy(out.data(), bytesWithInitialOffset, count * sizeof(T));
@@ -18,6 +19,11 @@ void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t
 
 }
 
+Bif::Bif(std::pmr::memory_resource* resource)
+    : m_VariableResourceTable(resource),
+      m_FixedResourceTable(resource)
+{ }
+
 bool Bif::ReadFromBytes(std::byte const* bytes, std::size_t bytesCount, Bif* out)
 {
     ASSERT(bytes);
@@ -65,13 +71,19 @@ bool Bif::ReadFromByteVector(std::vector<std::byte>&& bytes, Bif* out)
     return true;
 }
 
-bool Bif::ReadFromFile(char const* path, Bif* out)
+bool Bif::ReadFromFile(char const* path, Bif* out, FileReadOptions const& options)
 {
     ASSERT(path);
     ASSERT(out);
 
+    if (options.m_Backend != FileReadBackend::MemoryMap)
+    {
+        std::vector<std::byte> bytes;
+        return ReadEntireFile(path, &bytes) && ReadFromByteVector(std::move(bytes), out);
+    }
+
     MemoryMappedFile memmap;
-    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap);
+    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap, options.m_Hints);
 
     if (!loaded)
     {
@@ -99,6 +111,39 @@ bool Bif::ReadFromFile(char const* path, Bif* out)
     return true;
 }
 
+bool Bif::ReadTablesFromFile(char const* path, Bif* out, FileReadOptions const& options)
+{
+    ASSERT(path);
+    ASSERT(out);
+
+    // The header says where the tables end, so it's read by itself first. The tables are copied out of the block,
+    // so neither is kept.
+    std::unique_ptr<DataBlock> headerBlock = FileReader::ReadRange(path, { 0, sizeof(BifHeader) }, options);
+
+    if (!headerBlock)
+    {
+        return false;
+    }
+
+    BifHeader header;
+    std::memcpy(&header, headerBlock->GetData(), sizeof(header));
+
+    std::uint64_t tablesEnd = header.m_VariableTableOffset;
+    tablesEnd += static_cast<std::uint64_t>(header.m_VariableResourceCount) * sizeof(BifVariableResource);
+    tablesEnd += static_cast<std::uint64_t>(header.m_FixedResourceCount) * sizeof(BifFixedResource);
+
+    std::unique_ptr<DataBlock> tablesBlock = FileReader::ReadRange(path, { 0, tablesEnd }, options);
+
+    if (!tablesBlock || !out->ConstructInternal(tablesBlock->GetData()))
+    {
+        return false;
+    }
+
+    out->m_DataBlock = std::make_unique<NonOwningDataBlock>();
+
+    return true;
+}
+
 bool Bif::ConstructInternal(std::byte const* bytes)
 {
     ASSERT(bytes);
@@ -2,11 +2,13 @@
 
 #include "FileFormats/Resource.hpp"
 #include "Utility/DataBlock.hpp"
+#include "Utility/FileReader.hpp"
 #include "Utility/VirtualObject.hpp"
 
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
 namespace FileFormats::Bif::Raw {
@@ -96,9 +98,15 @@ using BifDataBlock = DataBlock;
 class Bif
 {
 public:
+    Bif() = default;
+
+    // The resource tables of a Bif constructed with a resource are allocated from it when read, rather than from
+    // the heap. The resource must outlive the Bif.
+    explicit Bif(std::pmr::memory_resource* resource);
+
     BifHeader m_Header;
-    std::vector<BifVariableResource> m_VariableResourceTable;
-    std::vector<BifFixedResource> m_FixedResourceTable;
+    std::pmr::vector<BifVariableResource> m_VariableResourceTable;
+    std::pmr::vector<BifFixedResource> m_FixedResourceTable;
 
     // NOTE: In the spec, this is separated into a variable resource data block and a fixed resource data block.
     // Unfortunately, there's nothing in the header that allows us to observe the size of each of these blocks.
@@ -111,8 +119,14 @@ public:
     // Constructs a Bif from a vector of bytes which we have taken ownership of. Memory usage will be moderate.
     static bool ReadFromByteVector(std::vector<std::byte>&& bytes, Bif* out);
 
-    // Constructs a Bif from a file. The file with be memory mapped so memory usage will be ideal.
-    static bool ReadFromFile(char const* path, Bif* out);
+    // Constructs a Bif from a file. With the MemoryMap backend (the default) the file with be memory mapped so
+    // memory usage will be ideal - the other backends read the whole file into memory.
+    static bool ReadFromFile(char const* path, Bif* out, FileReadOptions const& options = FileReadOptions());
+
+    // Reads just the header and the resource tables of a file, mapping or reading nothing past them, and leaves the
+    // data block empty. This is for finding where resources are in a BIF which will be read some other way - the
+    // data of the largest BIFs runs to gigabytes, and none of it is touched.
+    static bool ReadTablesFromFile(char const* path, Bif* out, FileReadOptions const& options = FileReadOptions());
 
 private:
 
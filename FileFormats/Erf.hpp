@@ -11,8 +11,12 @@
 // Step 3: If user friendly access is desired, construct a Erf from FileFormats::Erf::Friendly::Erf(rawErf).
 // - Localised descriptions can be accessed by .GetDescriptions().
 // - Resources can be accessed by .GetResources().
+// - Resource names are lowercased on construction - see Resource::ResRef.
 // - Refer to Example_Erf.cpp if the usage is unclear.
 //
+// To allocate from a std::pmr::memory_resource rather than the heap - e.g. one arena for a whole batch of loads -
+// construct the raw Erf with the resource before reading into it, and pass the same resource to the friendly Erf.
+//
 // For further information refer to https://wiki.neverwintervault.org/pages/viewpage.action?pageId=327727
 // Specifically, https://wiki.neverwintervault.org/download/attachments/327727/Bioware_Aurora_ERF_Format.pdf?api=v2
 
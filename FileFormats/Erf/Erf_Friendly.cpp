@@ -6,50 +6,54 @@
 
 namespace FileFormats::Erf::Friendly {
 
-Erf::Erf(Raw::Erf const& rawErf)
+Erf::Erf(Raw::Erf const& rawErf, std::pmr::memory_resource* resource)
+    : m_Descriptions(resource),
+      m_Resources(resource)
 {
     ConstructInternal(rawErf);
 }
 
-Erf::Erf(Raw::Erf&& rawErf) : m_RawErf(std::forward<Raw::Erf>(rawErf))
+Erf::Erf(Raw::Erf&& rawErf, std::pmr::memory_resource* resource)
+    : m_RawErf(std::forward<Raw::Erf>(rawErf)),
+      m_Descriptions(resource),
+      m_Resources(resource)
 {
     ConstructInternal(m_RawErf.value());
 }
 
-std::vector<Raw::ErfLocalisedString> const& Erf::GetDescriptions() const
+std::pmr::vector<Raw::ErfLocalisedString> const& Erf::GetDescriptions() const
 {
     return m_Descriptions;
 }
 
-std::vector<ErfResource> const& Erf::GetResources() const
+std::pmr::vector<ErfResource> const& Erf::GetResources() const
 {
     return m_Resources;
 }
 
 void Erf::ConstructInternal(Raw::Erf const& rawErf)
 {
-    // First - copy in the descriptions. This one is simple.
-    m_Descriptions = rawErf.m_LocalisedStrings;
+    std::pmr::memory_resource* memoryResource = m_Resources.get_allocator().resource();
+
+    // First - copy in the descriptions. This one is simple, except that copying the strings directly would allocate
+    // them from the default resource rather than ours.
+    for (Raw::ErfLocalisedString const& description : rawErf.m_LocalisedStrings)
+    {
+        m_Descriptions.push_back({ description.m_LanguageId, std::pmr::string(description.m_String, memoryResource) });
+    }
 
     ASSERT(rawErf.m_Resources.size() == rawErf.m_Header.m_EntryCount);
     ASSERT(rawErf.m_Keys.size() == rawErf.m_Header.m_EntryCount);
 
     // Second - iterate over every entry, then set them up in a user friendly way.
+    m_Resources.reserve(rawErf.m_Header.m_EntryCount);
+
     for (std::size_t i = 0; i < rawErf.m_Header.m_EntryCount; ++i)
     {
         Raw::ErfKey const& rawKey = rawErf.m_Keys[i];
         Raw::ErfResource const& rawRes = rawErf.m_Resources[i];
 
-        std::string resref = std::string(rawKey.m_ResRef, rawKey.m_ResRef + strnlen(rawKey.m_ResRef, 16));
-
-        // NWN is case insensitive and cases are mixed like crazy in the official modules.
-        // We just do the conversion to lower here to simplify things.
-        std::transform(std::begin(resref), std::end(resref), std::begin(resref), ::tolower);
-
-        ErfResource resource;
-        resource.m_ResRef = std::move(resref);
-        resource.m_ResType = rawKey.m_ResType;
-        resource.m_ResourceId = rawKey.m_ResId;
+        ErfResource resource { Resource::ResRef::FromRawResRef(rawKey.m_ResRef), rawKey.m_ResType, rawKey.m_ResId, nullptr };
 
         // Per the spec, the resourceID should match exactly the order that the resources are present in the resource block.
         // We assert here to ensure that is actually the case.
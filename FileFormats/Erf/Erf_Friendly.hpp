@@ -1,7 +1,9 @@
 #pragma once
 
 #include "FileFormats/Erf/Erf_Raw.hpp"
+#include "FileFormats/ResRef.hpp"
 
+#include <memory_resource>
 #include <optional>
 
 namespace FileFormats::Erf::Friendly {
@@ -9,7 +11,7 @@ namespace FileFormats::Erf::Friendly {
 struct ErfResource
 {
     // The file name of the resource.
-    std::string m_ResRef;
+    Resource::ResRef m_ResRef;
 
     // The type of the resource.
     Resource::ResourceType m_ResType;
@@ -26,15 +28,16 @@ class Erf
 {
 public:
     // This constructs a friendly Erf from a raw Erf.
-    Erf(Raw::Erf const& rawBif);
+    // The descriptions and resource list are allocated from the resource, which must outlive the Erf.
+    Erf(Raw::Erf const& rawBif, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     // This constructs a friendly Erf from a raw Erf whose ownership has been passed to us.
     // If ownership of the Erf is passed to us, we construct streamed resources, thus lowering
     // the memory usage significantly.
-    Erf(Raw::Erf&& rawBif);
+    Erf(Raw::Erf&& rawBif, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
-    std::vector<Raw::ErfLocalisedString> const& GetDescriptions() const;
-    std::vector<ErfResource> const& GetResources() const;
+    std::pmr::vector<Raw::ErfLocalisedString> const& GetDescriptions() const;
+    std::pmr::vector<ErfResource> const& GetResources() const;
 
 private:
     std::optional<Raw::Erf> m_RawErf;
@@ -42,10 +45,10 @@ private:
     void ConstructInternal(Raw::Erf const& rawErf);
 
     // This is a vector of localised descriptions for the ERF resource.
-    std::vector<Raw::ErfLocalisedString> m_Descriptions;
+    std::pmr::vector<Raw::ErfLocalisedString> m_Descriptions;
 
     // A vector of resources contained within this ERF.
-    std::vector<ErfResource> m_Resources;
+    std::pmr::vector<ErfResource> m_Resources;
 };
 
 }
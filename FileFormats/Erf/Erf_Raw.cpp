@@ -1,5 +1,6 @@
 #include "FileFormats/Erf/Erf_Raw.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/FileReader.hpp"
 #include "Utility/MemoryMappedFile.hpp"
 #include "Utility/RAIIWrapper.hpp"
 
@@ -7,8 +8,8 @@
 
 namespace {
 
-template <typename T>
-void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T>& out)
+template <typename T, typename Allocator>
+void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T, Allocator>& out)
 {
     out.resize(count);
     std::memcpy(out.data(), bytesWithInitialOffset, count * sizeof(T));
@@ -18,6 +19,12 @@ void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t
 
 namespace FileFormats::Erf::Raw {
 
+Erf::Erf(std::pmr::memory_resource* resource)
+    : m_LocalisedStrings(resource),
+      m_Keys(resource),
+      m_Resources(resource)
+{ }
+
 bool Erf::ReadFromBytes(std::byte const* bytes, std::size_t bytesCount, Erf* out)
 {
     ASSERT(bytes);
@@ -61,13 +68,19 @@ bool Erf::ReadFromByteVector(std::vector<std::byte>&& bytes, Erf* out)
     return true;
 }
 
-bool Erf::ReadFromFile(char const* path, Erf* out)
+bool Erf::ReadFromFile(char const* path, Erf* out, FileReadOptions const& options)
 {
     ASSERT(path);
     ASSERT(out);
 
+    if (options.m_Backend != FileReadBackend::MemoryMap)
+    {
+        std::vector<std::byte> bytes;
+        return ReadEntireFile(path, &bytes) && ReadFromByteVector(std::move(bytes), out);
+    }
+
     MemoryMappedFile memmap;
-    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap);
+    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap, options.m_Hints);
 
     if (!loaded)
     {
@@ -118,7 +131,7 @@ void Erf::ReadLocalisedStrings(std::byte const* data)
 
     for (std::size_t i = 0; i < m_Header.m_LanguageCount; ++i)
     {
-        ErfLocalisedString str;
+        ErfLocalisedString str { 0, std::pmr::string(m_LocalisedStrings.get_allocator()) };
         std::memcpy(&str.m_LanguageId, ptr, sizeof(str.m_LanguageId));
         ptr += sizeof(str.m_LanguageId);
 
@@ -126,9 +139,10 @@ void Erf::ReadLocalisedStrings(std::byte const* data)
         std::memcpy(&strSize, ptr, sizeof(strSize));
         ptr += sizeof(strSize);
 
-        str.m_String = std::string(reinterpret_cast<char const*>(ptr), strSize);
+        str.m_String.assign(reinterpret_cast<char const*>(ptr), strSize);
+        ptr += strSize;
 
-        m_LocalisedStrings.emplace_back(str);
+        m_LocalisedStrings.emplace_back(std::move(str));
     }
 }
 
@@ -2,11 +2,13 @@
 
 #include "FileFormats/Resource.hpp"
 #include "Utility/DataBlock.hpp"
+#include "Utility/FileReader.hpp"
 #include "Utility/VirtualObject.hpp"
 
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -56,7 +58,7 @@ struct ErfLocalisedString
     std::uint32_t m_LanguageId;
     //std::uint32_t m_StringSize;
     //char m_String[m_StringSize];
-    std::string m_String;
+    std::pmr::string m_String;
 };
 
 struct ErfKey
@@ -106,10 +108,16 @@ using ErfResourceData = DataBlock;
 
 struct Erf
 {
+    Erf() = default;
+
+    // The tables are allocated from the resource rather than the heap - construct the Erf with the resource, then
+    // read into it. The resource must outlive the Erf.
+    explicit Erf(std::pmr::memory_resource* resource);
+
     ErfHeader m_Header;
-    std::vector<ErfLocalisedString> m_LocalisedStrings;
-    std::vector<ErfKey> m_Keys;
-    std::vector<ErfResource> m_Resources;
+    std::pmr::vector<ErfLocalisedString> m_LocalisedStrings;
+    std::pmr::vector<ErfKey> m_Keys;
+    std::pmr::vector<ErfResource> m_Resources;
     std::unique_ptr<ErfResourceData> m_ResourceData;
 
     // Constructs an Erf from a non-owning pointer. Memory usage may be high.
@@ -118,8 +126,9 @@ struct Erf
     // Constructs an Erf from a vector of bytes which we have taken ownership of. Memory usage will be moderate.
     static bool ReadFromByteVector(std::vector<std::byte>&& bytes, Erf* out);
 
-    // Constructs an Erf from a file. The file with be memory mapped so memory usage will be ideal.
-    static bool ReadFromFile(char const* path, Erf* out);
+    // Constructs an Erf from a file. With the MemoryMap backend (the default) the file with be memory mapped so
+    // memory usage will be ideal - the other backends read the whole file into memory.
+    static bool ReadFromFile(char const* path, Erf* out, FileReadOptions const& options = FileReadOptions());
 
 private:
 
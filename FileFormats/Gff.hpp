@@ -1,6 +1,7 @@
 #pragma once
 
-// This file provides read-only access to GFF data.
+// This file provides access to GFF data - reading it, building and writing it, patching it in place, and converting it
+// to and from JSON.
 // In the FileFormats::Gff::Raw namespace is located Gff, which wraps the raw data structure.
 // In the FileFormats::Gff::Friendly namespace is located Gff, which exposes a much more user friendly structure.
 //
@@ -9,12 +10,44 @@
 // Step 1: Load your GFF file into memory.
 // Step 2: Construct a Gff as such: FileFormats::Gff::Raw::Gff::ReadFromBytes(bytes);
 // - You can browse the loaded field format and extract fields using the ConstructX functions.
-// Step 3: If user friendly access to fields is desired, construct a Gff from FileFormats::Gff::Friendly::Gff(rawGff).
+// - If you don't need to modify the raw structure, FileFormats::Gff::Raw::GffView::ReadFromFile(path, &view) avoids
+//   copying the file into memory. The same ConstructX functions are available on the view.
+// - If you only need a few fields, parse a FileFormats::Gff::Raw::GffProjection from their paths
+//   (e.g. "Str", "ItemList[0]/Tag") and call Project on the Gff or view. Nothing off those paths is read.
+// - If you need one pass over the whole file - indexing, exporting, validating - derive from
+//   FileFormats::Gff::Raw::GffEventHandler and call ReadEvents on the Gff or view. Nothing is built or allocated.
+// Step 3: If user friendly access to fields is desired, construct a Gff from FileFormats::Gff::Friendly::Gff(rawGff) (or rawView).
 // - You can access the top level struct with GetTopLevelStruct().
 // - You can access fields with GetTopLevelStruct().ReadField<Type_CExoString>("FIELD_NAME").
+// - GetField<Type_List>("FIELD_NAME") returns a pointer to the stored value instead of a copy, and
+//   Visit(struct, callback) calls a generic callback with every field as its Type_*.
+// - FileFormats::Gff::Friendly::Gff::Lazy(std::move(rawView)) takes the view and decodes structs and lists lazily, on
+//   first access.
+// - For files with very large lists, pass a ThreadPool (Utility/ThreadPool.hpp) as the second argument to decode the
+//   lists across it. The result is the same as without one.
+// - Raw::Gff and the friendly Gff can both allocate from a std::pmr::memory_resource given on construction, so a
+//   batch of files can be loaded into one arena and released together. See GffStruct for the caveats.
+// Alternatively, if you know which fields you want ahead of time, decode straight into a typed struct with
+// FileFormats::Gff::Schema::Decode(rawGff, &utc). Schemas for UTC, UTI, UTP and BIC are in Gff_Blueprints.hpp,
+// and Gff_Schema.hpp describes how to declare your own.
+//
+// To write a GFF, either build a friendly Gff and call WriteToFile, or - for large generated files - push the fields
+// straight into a FileFormats::Gff::Friendly::GffBuilder, which never holds more than the raw sections in memory.
+// If the bytes need to depend only on the contents - for hashing or syncing - write with
+// GffWriter(GffWriter::Mode::Canonical), which also shares identical strings and binary data within the file.
+// To keep GFFs under source control, convert them to and from JSON with FileFormats::Gff::Json - see Gff_Json.hpp.
+// To compare two GFFs, FileFormats::Gff::Friendly::DiffGff lists the edits between two friendly structs, and
+// Json::WriteEditScriptToJson writes them out - see Gff_Diff.hpp.
+// To change a BYTE, DWORD, FLOAT or other fixed-size field in an existing file, open it with
+// FileFormats::Gff::Raw::GffPatcher::ReadFromFile and patch the field in place - nothing else is read or written.
 //
 // For further information refer to https://wiki.neverwintervault.org/pages/viewpage.action?pageId=327727
 // Specifically, https://wiki.neverwintervault.org/download/attachments/327727/Bioware_Aurora_GFF_Format.pdf?api=v2
 
 #include "FileFormats/Gff/Gff_Raw.hpp"
 #include "FileFormats/Gff/Gff_Friendly.hpp"
+#include "FileFormats/Gff/Gff_Builder.hpp"
+#include "FileFormats/Gff/Gff_Diff.hpp"
+#include "FileFormats/Gff/Gff_Json.hpp"
+#include "FileFormats/Gff/Gff_Schema.hpp"
+#include "FileFormats/Gff/Gff_Blueprints.hpp"
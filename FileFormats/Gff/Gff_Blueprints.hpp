@@ -0,0 +1,549 @@
+#pragma once
+
+#include "FileFormats/Gff/Gff_Schema.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+// Typed schemas for the common blueprint and character GFFs - UTC (creature blueprint), UTI (item blueprint),
+// UTP (placeable blueprint) and BIC (player character).
+//
+// These cover the fields that tools commonly care about rather than every field the game knows about. Anything not
+// listed here is skipped while decoding; if you need it, add a member and a binding (or use the Friendly::Gff).
+//
+// Field names and types are taken from the Bioware Aurora Creature, Item and Situated Object format documents.
+
+namespace FileFormats::Gff::Schema {
+
+using Friendly::GffFieldValue;
+using Friendly::Type_BYTE;
+using Friendly::Type_WORD;
+using Friendly::Type_SHORT;
+using Friendly::Type_DWORD;
+using Friendly::Type_INT;
+using Friendly::Type_FLOAT;
+using Friendly::Type_CExoString;
+using Friendly::Type_CResRef;
+using Friendly::Type_CExoLocString;
+
+// An entry of a VarTable. The type of Value depends on Type (1 = INT, 2 = FLOAT, 3 = CExoString, ...).
+struct Variable
+{
+    Type_CExoString m_Name;
+    Type_DWORD m_Type = 0;
+    GffFieldValue m_Value;
+};
+
+struct ItemProperty
+{
+    Type_WORD m_PropertyName = 0;
+    Type_WORD m_Subtype = 0;
+    Type_BYTE m_CostTable = 0;
+    Type_WORD m_CostValue = 0;
+    Type_BYTE m_Param1 = 0;
+    Type_BYTE m_Param1Value = 0;
+    Type_BYTE m_ChanceAppear = 0;
+};
+
+// The fields shared between an item blueprint and an item instance (in a BIC inventory).
+struct Item
+{
+    Type_CResRef m_TemplateResRef = {};
+    Type_CExoString m_Tag;
+    Type_CExoLocString m_LocalizedName;
+    Type_CExoLocString m_Description;
+    Type_CExoLocString m_DescIdentified;
+    Type_INT m_BaseItem = 0;
+    Type_WORD m_StackSize = 0;
+    Type_BYTE m_Charges = 0;
+    Type_DWORD m_Cost = 0;
+    Type_DWORD m_AddCost = 0;
+    Type_BYTE m_Plot = 0;
+    Type_BYTE m_Stolen = 0;
+    Type_BYTE m_Cursed = 0;
+    Type_BYTE m_Identified = 0;
+    Type_BYTE m_ModelPart1 = 0;
+    Type_BYTE m_ModelPart2 = 0;
+    Type_BYTE m_ModelPart3 = 0;
+    Type_BYTE m_Cloth1Color = 0;
+    Type_BYTE m_Cloth2Color = 0;
+    Type_BYTE m_Leather1Color = 0;
+    Type_BYTE m_Leather2Color = 0;
+    Type_BYTE m_Metal1Color = 0;
+    Type_BYTE m_Metal2Color = 0;
+    std::vector<ItemProperty> m_PropertiesList;
+    std::vector<Variable> m_VarTable;
+};
+
+struct Uti : Item
+{
+    Type_BYTE m_PaletteID = 0;
+    Type_CExoString m_Comment;
+};
+
+// An item in a BIC inventory or placeable/creature instance inventory.
+struct InventoryItem : Item
+{
+    Type_WORD m_ReposPosX = 0;
+    Type_WORD m_ReposPosY = 0;
+    Type_BYTE m_Dropable = 0;
+    Type_BYTE m_Pickpocketable = 0;
+};
+
+// An equipped item on a BIC. The struct ID is the equipment slot bit.
+struct EquippedItem : Item
+{
+    std::uint32_t m_Slot = 0;
+};
+
+// A reference to an item blueprint in a UTC or UTP inventory.
+struct InventoryItemRef
+{
+    Type_CResRef m_InventoryRes = {};
+    Type_WORD m_ReposPosX = 0;
+    Type_WORD m_ReposPosY = 0;
+    Type_BYTE m_Dropable = 0;
+    Type_BYTE m_Pickpocketable = 0;
+};
+
+// A reference to an item blueprint equipped on a UTC. The struct ID is the equipment slot bit.
+struct EquippedItemRef
+{
+    std::uint32_t m_Slot = 0;
+    Type_CResRef m_EquippedRes = {};
+};
+
+struct CreatureClass
+{
+    Type_INT m_Class = 0;
+    Type_SHORT m_ClassLevel = 0;
+};
+
+struct CreatureFeat
+{
+    Type_WORD m_Feat = 0;
+};
+
+struct CreatureSkill
+{
+    Type_BYTE m_Rank = 0;
+};
+
+struct CreatureSpecialAbility
+{
+    Type_WORD m_Spell = 0;
+    Type_BYTE m_SpellCasterLevel = 0;
+    Type_BYTE m_SpellFlags = 0;
+};
+
+// The fields shared between a creature blueprint and a player character.
+struct Creature
+{
+    Type_CExoLocString m_FirstName;
+    Type_CExoLocString m_LastName;
+    Type_CExoLocString m_Description;
+    Type_CExoString m_Tag;
+    Type_CExoString m_Subrace;
+    Type_CExoString m_Deity;
+    Type_BYTE m_Race = 0;
+    Type_BYTE m_Gender = 0;
+    Type_WORD m_AppearanceType = 0;
+    Type_INT m_Phenotype = 0;
+    Type_WORD m_PortraitId = 0;
+    Type_WORD m_SoundSetFile = 0;
+    Type_CResRef m_Conversation = {};
+    Type_BYTE m_Str = 0;
+    Type_BYTE m_Dex = 0;
+    Type_BYTE m_Con = 0;
+    Type_BYTE m_Int = 0;
+    Type_BYTE m_Wis = 0;
+    Type_BYTE m_Cha = 0;
+    Type_BYTE m_NaturalAC = 0;
+    Type_SHORT m_HitPoints = 0;
+    Type_SHORT m_CurrentHitPoints = 0;
+    Type_SHORT m_MaxHitPoints = 0;
+    Type_SHORT m_FortBonus = 0;
+    Type_SHORT m_RefBonus = 0;
+    Type_SHORT m_WillBonus = 0;
+    Type_BYTE m_GoodEvil = 0;
+    Type_BYTE m_LawfulChaotic = 0;
+    Type_FLOAT m_ChallengeRating = 0.0f;
+    Type_INT m_CRAdjust = 0;
+    Type_WORD m_FactionID = 0;
+    Type_BYTE m_PerceptionRange = 0;
+    Type_INT m_WalkRate = 0;
+    Type_BYTE m_StartingPackage = 0;
+    Type_DWORD m_DecayTime = 0;
+    Type_BYTE m_BodyBag = 0;
+    Type_BYTE m_Plot = 0;
+    Type_BYTE m_IsImmortal = 0;
+    Type_BYTE m_NoPermDeath = 0;
+    Type_BYTE m_IsPC = 0;
+    Type_BYTE m_Disarmable = 0;
+    Type_BYTE m_Lootable = 0;
+    Type_BYTE m_Interruptable = 0;
+    Type_CResRef m_ScriptAttacked = {};
+    Type_CResRef m_ScriptDamaged = {};
+    Type_CResRef m_ScriptDeath = {};
+    Type_CResRef m_ScriptDialogue = {};
+    Type_CResRef m_ScriptDisturbed = {};
+    Type_CResRef m_ScriptEndRound = {};
+    Type_CResRef m_ScriptHeartbeat = {};
+    Type_CResRef m_ScriptOnBlocked = {};
+    Type_CResRef m_ScriptOnNotice = {};
+    Type_CResRef m_ScriptRested = {};
+    Type_CResRef m_ScriptSpawn = {};
+    Type_CResRef m_ScriptSpellAt = {};
+    Type_CResRef m_ScriptUserDefine = {};
+    std::vector<CreatureClass> m_ClassList;
+    std::vector<CreatureFeat> m_FeatList;
+    std::vector<CreatureSkill> m_SkillList;
+    std::vector<CreatureSpecialAbility> m_SpecAbilityList;
+    std::vector<Variable> m_VarTable;
+};
+
+struct Utc : Creature
+{
+    Type_CResRef m_TemplateResRef = {};
+    Type_BYTE m_PaletteID = 0;
+    Type_CExoString m_Comment;
+    std::vector<EquippedItemRef> m_EquipItemList;
+    std::vector<InventoryItemRef> m_ItemList;
+};
+
+struct Bic : Creature
+{
+    Type_DWORD m_Experience = 0;
+    Type_DWORD m_Gold = 0;
+    Type_INT m_Age = 0;
+    std::vector<EquippedItem> m_EquipItemList;
+    std::vector<InventoryItem> m_ItemList;
+};
+
+struct Utp
+{
+    Type_CResRef m_TemplateResRef = {};
+    Type_CExoString m_Tag;
+    Type_CExoLocString m_LocName;
+    Type_CExoLocString m_Description;
+    Type_DWORD m_Appearance = 0;
+    Type_BYTE m_AnimationState = 0;
+    Type_WORD m_PortraitId = 0;
+    Type_CResRef m_Conversation = {};
+    Type_DWORD m_Faction = 0;
+    Type_SHORT m_HP = 0;
+    Type_SHORT m_CurrentHP = 0;
+    Type_BYTE m_Hardness = 0;
+    Type_BYTE m_Fort = 0;
+    Type_BYTE m_Ref = 0;
+    Type_BYTE m_Will = 0;
+    Type_BYTE m_Plot = 0;
+    Type_BYTE m_Static = 0;
+    Type_BYTE m_Useable = 0;
+    Type_BYTE m_HasInventory = 0;
+    Type_BYTE m_BodyBag = 0;
+    Type_BYTE m_Interruptable = 0;
+    Type_BYTE m_Type = 0;
+    Type_BYTE m_Lockable = 0;
+    Type_BYTE m_Locked = 0;
+    Type_BYTE m_OpenLockDC = 0;
+    Type_BYTE m_CloseLockDC = 0;
+    Type_BYTE m_KeyRequired = 0;
+    Type_CExoString m_KeyName;
+    Type_BYTE m_AutoRemoveKey = 0;
+    Type_BYTE m_TrapFlag = 0;
+    Type_BYTE m_TrapType = 0;
+    Type_BYTE m_TrapDetectable = 0;
+    Type_BYTE m_TrapDetectDC = 0;
+    Type_BYTE m_TrapDisarmable = 0;
+    Type_BYTE m_DisarmDC = 0;
+    Type_BYTE m_TrapOneShot = 0;
+    Type_CResRef m_OnClosed = {};
+    Type_CResRef m_OnDamaged = {};
+    Type_CResRef m_OnDeath = {};
+    Type_CResRef m_OnDisarm = {};
+    Type_CResRef m_OnHeartbeat = {};
+    Type_CResRef m_OnInvDisturbed = {};
+    Type_CResRef m_OnLock = {};
+    Type_CResRef m_OnMeleeAttacked = {};
+    Type_CResRef m_OnOpen = {};
+    Type_CResRef m_OnSpellCastAt = {};
+    Type_CResRef m_OnTrapTriggered = {};
+    Type_CResRef m_OnUnlock = {};
+    Type_CResRef m_OnUsed = {};
+    Type_CResRef m_OnUserDefined = {};
+    Type_BYTE m_PaletteID = 0;
+    Type_CExoString m_Comment;
+    std::vector<InventoryItemRef> m_ItemList;
+    std::vector<Variable> m_VarTable;
+};
+
+namespace Detail {
+
+template <typename Owner>
+constexpr auto ItemFields()
+{
+    return std::make_tuple(
+        Bind<Owner>("TemplateResRef", &Item::m_TemplateResRef),
+        Bind<Owner>("Tag", &Item::m_Tag),
+        Bind<Owner>("LocalizedName", &Item::m_LocalizedName),
+        Bind<Owner>("Description", &Item::m_Description),
+        Bind<Owner>("DescIdentified", &Item::m_DescIdentified),
+        Bind<Owner>("BaseItem", &Item::m_BaseItem),
+        Bind<Owner>("StackSize", &Item::m_StackSize),
+        Bind<Owner>("Charges", &Item::m_Charges),
+        Bind<Owner>("Cost", &Item::m_Cost),
+        Bind<Owner>("AddCost", &Item::m_AddCost),
+        Bind<Owner>("Plot", &Item::m_Plot),
+        Bind<Owner>("Stolen", &Item::m_Stolen),
+        Bind<Owner>("Cursed", &Item::m_Cursed),
+        Bind<Owner>("Identified", &Item::m_Identified),
+        Bind<Owner>("ModelPart1", &Item::m_ModelPart1),
+        Bind<Owner>("ModelPart2", &Item::m_ModelPart2),
+        Bind<Owner>("ModelPart3", &Item::m_ModelPart3),
+        Bind<Owner>("Cloth1Color", &Item::m_Cloth1Color),
+        Bind<Owner>("Cloth2Color", &Item::m_Cloth2Color),
+        Bind<Owner>("Leather1Color", &Item::m_Leather1Color),
+        Bind<Owner>("Leather2Color", &Item::m_Leather2Color),
+        Bind<Owner>("Metal1Color", &Item::m_Metal1Color),
+        Bind<Owner>("Metal2Color", &Item::m_Metal2Color),
+        Bind<Owner>("PropertiesList", &Item::m_PropertiesList),
+        Bind<Owner>("VarTable", &Item::m_VarTable));
+}
+
+template <typename Owner>
+constexpr auto CreatureFields()
+{
+    return std::make_tuple(
+        Bind<Owner>("FirstName", &Creature::m_FirstName),
+        Bind<Owner>("LastName", &Creature::m_LastName),
+        Bind<Owner>("Description", &Creature::m_Description),
+        Bind<Owner>("Tag", &Creature::m_Tag),
+        Bind<Owner>("Subrace", &Creature::m_Subrace),
+        Bind<Owner>("Deity", &Creature::m_Deity),
+        Bind<Owner>("Race", &Creature::m_Race),
+        Bind<Owner>("Gender", &Creature::m_Gender),
+        Bind<Owner>("Appearance_Type", &Creature::m_AppearanceType),
+        Bind<Owner>("Phenotype", &Creature::m_Phenotype),
+        Bind<Owner>("PortraitId", &Creature::m_PortraitId),
+        Bind<Owner>("SoundSetFile", &Creature::m_SoundSetFile),
+        Bind<Owner>("Conversation", &Creature::m_Conversation),
+        Bind<Owner>("Str", &Creature::m_Str),
+        Bind<Owner>("Dex", &Creature::m_Dex),
+        Bind<Owner>("Con", &Creature::m_Con),
+        Bind<Owner>("Int", &Creature::m_Int),
+        Bind<Owner>("Wis", &Creature::m_Wis),
+        Bind<Owner>("Cha", &Creature::m_Cha),
+        Bind<Owner>("NaturalAC", &Creature::m_NaturalAC),
+        Bind<Owner>("HitPoints", &Creature::m_HitPoints),
+        Bind<Owner>("CurrentHitPoints", &Creature::m_CurrentHitPoints),
+        Bind<Owner>("MaxHitPoints", &Creature::m_MaxHitPoints),
+        Bind<Owner>("fortbonus", &Creature::m_FortBonus),
+        Bind<Owner>("refbonus", &Creature::m_RefBonus),
+        Bind<Owner>("willbonus", &Creature::m_WillBonus),
+        Bind<Owner>("GoodEvil", &Creature::m_GoodEvil),
+        Bind<Owner>("LawfulChaotic", &Creature::m_LawfulChaotic),
+        Bind<Owner>("ChallengeRating", &Creature::m_ChallengeRating),
+        Bind<Owner>("CRAdjust", &Creature::m_CRAdjust),
+        Bind<Owner>("FactionID", &Creature::m_FactionID),
+        Bind<Owner>("PerceptionRange", &Creature::m_PerceptionRange),
+        Bind<Owner>("WalkRate", &Creature::m_WalkRate),
+        Bind<Owner>("StartingPackage", &Creature::m_StartingPackage),
+        Bind<Owner>("DecayTime", &Creature::m_DecayTime),
+        Bind<Owner>("BodyBag", &Creature::m_BodyBag),
+        Bind<Owner>("Plot", &Creature::m_Plot),
+        Bind<Owner>("IsImmortal", &Creature::m_IsImmortal),
+        Bind<Owner>("NoPermDeath", &Creature::m_NoPermDeath),
+        Bind<Owner>("IsPC", &Creature::m_IsPC),
+        Bind<Owner>("Disarmable", &Creature::m_Disarmable),
+        Bind<Owner>("Lootable", &Creature::m_Lootable),
+        Bind<Owner>("Interruptable", &Creature::m_Interruptable),
+        Bind<Owner>("ScriptAttacked", &Creature::m_ScriptAttacked),
+        Bind<Owner>("ScriptDamaged", &Creature::m_ScriptDamaged),
+        Bind<Owner>("ScriptDeath", &Creature::m_ScriptDeath),
+        Bind<Owner>("ScriptDialogue", &Creature::m_ScriptDialogue),
+        Bind<Owner>("ScriptDisturbed", &Creature::m_ScriptDisturbed),
+        Bind<Owner>("ScriptEndRound", &Creature::m_ScriptEndRound),
+        Bind<Owner>("ScriptHeartbeat", &Creature::m_ScriptHeartbeat),
+        Bind<Owner>("ScriptOnBlocked", &Creature::m_ScriptOnBlocked),
+        Bind<Owner>("ScriptOnNotice", &Creature::m_ScriptOnNotice),
+        Bind<Owner>("ScriptRested", &Creature::m_ScriptRested),
+        Bind<Owner>("ScriptSpawn", &Creature::m_ScriptSpawn),
+        Bind<Owner>("ScriptSpellAt", &Creature::m_ScriptSpellAt),
+        Bind<Owner>("ScriptUserDefine", &Creature::m_ScriptUserDefine),
+        Bind<Owner>("ClassList", &Creature::m_ClassList),
+        Bind<Owner>("FeatList", &Creature::m_FeatList),
+        Bind<Owner>("SkillList", &Creature::m_SkillList),
+        Bind<Owner>("SpecAbilityList", &Creature::m_SpecAbilityList),
+        Bind<Owner>("VarTable", &Creature::m_VarTable));
+}
+
+}
+
+template <> struct GffSchema<Variable>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Bind<Variable>("Name", &Variable::m_Name),
+        Bind<Variable>("Type", &Variable::m_Type),
+        Bind<Variable>("Value", &Variable::m_Value));
+};
+
+template <> struct GffSchema<ItemProperty>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Bind<ItemProperty>("PropertyName", &ItemProperty::m_PropertyName),
+        Bind<ItemProperty>("Subtype", &ItemProperty::m_Subtype),
+        Bind<ItemProperty>("CostTable", &ItemProperty::m_CostTable),
+        Bind<ItemProperty>("CostValue", &ItemProperty::m_CostValue),
+        Bind<ItemProperty>("Param1", &ItemProperty::m_Param1),
+        Bind<ItemProperty>("Param1Value", &ItemProperty::m_Param1Value),
+        Bind<ItemProperty>("ChanceAppear", &ItemProperty::m_ChanceAppear));
+};
+
+template <> struct GffSchema<Uti>
+{
+    static constexpr auto Fields = std::tuple_cat(Detail::ItemFields<Uti>(), std::make_tuple(
+        Bind<Uti>("PaletteID", &Uti::m_PaletteID),
+        Bind<Uti>("Comment", &Uti::m_Comment)));
+};
+
+template <> struct GffSchema<InventoryItem>
+{
+    static constexpr auto Fields = std::tuple_cat(Detail::ItemFields<InventoryItem>(), std::make_tuple(
+        Bind<InventoryItem>("Repos_PosX", &InventoryItem::m_ReposPosX),
+        Bind<InventoryItem>("Repos_Posy", &InventoryItem::m_ReposPosY),
+        Bind<InventoryItem>("Dropable", &InventoryItem::m_Dropable),
+        Bind<InventoryItem>("Pickpocketable", &InventoryItem::m_Pickpocketable)));
+};
+
+template <> struct GffSchema<EquippedItem>
+{
+    static constexpr auto StructId = &EquippedItem::m_Slot;
+    static constexpr auto Fields = Detail::ItemFields<EquippedItem>();
+};
+
+template <> struct GffSchema<InventoryItemRef>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Bind<InventoryItemRef>("InventoryRes", &InventoryItemRef::m_InventoryRes),
+        Bind<InventoryItemRef>("Repos_PosX", &InventoryItemRef::m_ReposPosX),
+        Bind<InventoryItemRef>("Repos_Posy", &InventoryItemRef::m_ReposPosY),
+        Bind<InventoryItemRef>("Dropable", &InventoryItemRef::m_Dropable),
+        Bind<InventoryItemRef>("Pickpocketable", &InventoryItemRef::m_Pickpocketable));
+};
+
+template <> struct GffSchema<EquippedItemRef>
+{
+    static constexpr auto StructId = &EquippedItemRef::m_Slot;
+    static constexpr auto Fields = std::make_tuple(
+        Bind<EquippedItemRef>("EquippedRes", &EquippedItemRef::m_EquippedRes));
+};
+
+template <> struct GffSchema<CreatureClass>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Bind<CreatureClass>("Class", &CreatureClass::m_Class),
+        Bind<CreatureClass>("ClassLevel", &CreatureClass::m_ClassLevel));
+};
+
+template <> struct GffSchema<CreatureFeat>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Bind<CreatureFeat>("Feat", &CreatureFeat::m_Feat));
+};
+
+template <> struct GffSchema<CreatureSkill>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Bind<CreatureSkill>("Rank", &CreatureSkill::m_Rank));
+};
+
+template <> struct GffSchema<CreatureSpecialAbility>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Bind<CreatureSpecialAbility>("Spell", &CreatureSpecialAbility::m_Spell),
+        Bind<CreatureSpecialAbility>("SpellCasterLevel", &CreatureSpecialAbility::m_SpellCasterLevel),
+        Bind<CreatureSpecialAbility>("SpellFlags", &CreatureSpecialAbility::m_SpellFlags));
+};
+
+template <> struct GffSchema<Utc>
+{
+    static constexpr auto Fields = std::tuple_cat(Detail::CreatureFields<Utc>(), std::make_tuple(
+        Bind<Utc>("TemplateResRef", &Utc::m_TemplateResRef),
+        Bind<Utc>("PaletteID", &Utc::m_PaletteID),
+        Bind<Utc>("Comment", &Utc::m_Comment),
+        Bind<Utc>("Equip_ItemList", &Utc::m_EquipItemList),
+        Bind<Utc>("ItemList", &Utc::m_ItemList)));
+};
+
+template <> struct GffSchema<Bic>
+{
+    static constexpr auto Fields = std::tuple_cat(Detail::CreatureFields<Bic>(), std::make_tuple(
+        Bind<Bic>("Experience", &Bic::m_Experience),
+        Bind<Bic>("Gold", &Bic::m_Gold),
+        Bind<Bic>("Age", &Bic::m_Age),
+        Bind<Bic>("Equip_ItemList", &Bic::m_EquipItemList),
+        Bind<Bic>("ItemList", &Bic::m_ItemList)));
+};
+
+template <> struct GffSchema<Utp>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Bind<Utp>("TemplateResRef", &Utp::m_TemplateResRef),
+        Bind<Utp>("Tag", &Utp::m_Tag),
+        Bind<Utp>("LocName", &Utp::m_LocName),
+        Bind<Utp>("Description", &Utp::m_Description),
+        Bind<Utp>("Appearance", &Utp::m_Appearance),
+        Bind<Utp>("AnimationState", &Utp::m_AnimationState),
+        Bind<Utp>("PortraitId", &Utp::m_PortraitId),
+        Bind<Utp>("Conversation", &Utp::m_Conversation),
+        Bind<Utp>("Faction", &Utp::m_Faction),
+        Bind<Utp>("HP", &Utp::m_HP),
+        Bind<Utp>("CurrentHP", &Utp::m_CurrentHP),
+        Bind<Utp>("Hardness", &Utp::m_Hardness),
+        Bind<Utp>("Fort", &Utp::m_Fort),
+        Bind<Utp>("Ref", &Utp::m_Ref),
+        Bind<Utp>("Will", &Utp::m_Will),
+        Bind<Utp>("Plot", &Utp::m_Plot),
+        Bind<Utp>("Static", &Utp::m_Static),
+        Bind<Utp>("Useable", &Utp::m_Useable),
+        Bind<Utp>("HasInventory", &Utp::m_HasInventory),
+        Bind<Utp>("BodyBag", &Utp::m_BodyBag),
+        Bind<Utp>("Interruptable", &Utp::m_Interruptable),
+        Bind<Utp>("Type", &Utp::m_Type),
+        Bind<Utp>("Lockable", &Utp::m_Lockable),
+        Bind<Utp>("Locked", &Utp::m_Locked),
+        Bind<Utp>("OpenLockDC", &Utp::m_OpenLockDC),
+        Bind<Utp>("CloseLockDC", &Utp::m_CloseLockDC),
+        Bind<Utp>("KeyRequired", &Utp::m_KeyRequired),
+        Bind<Utp>("KeyName", &Utp::m_KeyName),
+        Bind<Utp>("AutoRemoveKey", &Utp::m_AutoRemoveKey),
+        Bind<Utp>("TrapFlag", &Utp::m_TrapFlag),
+        Bind<Utp>("TrapType", &Utp::m_TrapType),
+        Bind<Utp>("TrapDetectable", &Utp::m_TrapDetectable),
+        Bind<Utp>("TrapDetectDC", &Utp::m_TrapDetectDC),
+        Bind<Utp>("TrapDisarmable", &Utp::m_TrapDisarmable),
+        Bind<Utp>("DisarmDC", &Utp::m_DisarmDC),
+        Bind<Utp>("TrapOneShot", &Utp::m_TrapOneShot),
+        Bind<Utp>("OnClosed", &Utp::m_OnClosed),
+        Bind<Utp>("OnDamaged", &Utp::m_OnDamaged),
+        Bind<Utp>("OnDeath", &Utp::m_OnDeath),
+        Bind<Utp>("OnDisarm", &Utp::m_OnDisarm),
+        Bind<Utp>("OnHeartbeat", &Utp::m_OnHeartbeat),
+        Bind<Utp>("OnInvDisturbed", &Utp::m_OnInvDisturbed),
+        Bind<Utp>("OnLock", &Utp::m_OnLock),
+        Bind<Utp>("OnMeleeAttacked", &Utp::m_OnMeleeAttacked),
+        Bind<Utp>("OnOpen", &Utp::m_OnOpen),
+        Bind<Utp>("OnSpellCastAt", &Utp::m_OnSpellCastAt),
+        Bind<Utp>("OnTrapTriggered", &Utp::m_OnTrapTriggered),
+        Bind<Utp>("OnUnlock", &Utp::m_OnUnlock),
+        Bind<Utp>("OnUsed", &Utp::m_OnUsed),
+        Bind<Utp>("OnUserDefined", &Utp::m_OnUserDefined),
+        Bind<Utp>("PaletteID", &Utp::m_PaletteID),
+        Bind<Utp>("Comment", &Utp::m_Comment),
+        Bind<Utp>("ItemList", &Utp::m_ItemList),
+        Bind<Utp>("VarTable", &Utp::m_VarTable));
+};
+
+}
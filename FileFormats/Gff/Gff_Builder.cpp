@@ -0,0 +1,287 @@
+#include "FileFormats/Gff/Gff_Builder.hpp"
+#include "Utility/Assert.hpp"
+
+namespace FileFormats::Gff::Friendly {
+
+GffBuilder::GffBuilder(char const* fileType)
+{
+    ASSERT(fileType && std::strlen(fileType) == sizeof(m_FileType));
+    std::memcpy(m_FileType, fileType, sizeof(m_FileType));
+    Reset();
+}
+
+void GffBuilder::BeginStruct(GffFieldLabel const& label, std::uint32_t id)
+{
+    Raw::GffField& field = AddFieldInternal(label, Raw::GffField::Type::Struct);
+    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_Structs.size());
+    OpenStruct(id);
+}
+
+void GffBuilder::BeginStruct(std::uint32_t id)
+{
+    ASSERT_MSG(!m_Open.empty() && m_Open.back().m_IsList, "A struct without a label must be an element of a list.");
+    m_Scratch.emplace_back(static_cast<std::uint32_t>(m_Structs.size()));
+    OpenStruct(id);
+}
+
+void GffBuilder::EndStruct()
+{
+    ASSERT_MSG(m_Open.size() > 1 && !m_Open.back().m_IsList, "EndStruct without a matching BeginStruct.");
+    CloseStruct();
+}
+
+void GffBuilder::BeginList(GffFieldLabel const& label)
+{
+    AddFieldInternal(label, Raw::GffField::Type::List);
+    m_Open.push_back({ static_cast<std::uint32_t>(m_Fields.size() - 1), m_Scratch.size(), true });
+}
+
+void GffBuilder::EndList()
+{
+    ASSERT_MSG(!m_Open.empty() && m_Open.back().m_IsList, "EndList without a matching BeginList.");
+
+    OpenContainer list = m_Open.back();
+    m_Open.pop_back();
+
+    // A list is a count followed by the struct index of each element.
+    std::uint32_t elementCount = static_cast<std::uint32_t>(m_Scratch.size() - list.m_ScratchBase);
+    m_Fields[list.m_Index].m_DataOrDataOffset = static_cast<std::uint32_t>(m_ListIndices.size());
+
+    std::size_t offset = m_ListIndices.size();
+    m_ListIndices.resize(offset + (elementCount + 1) * sizeof(std::uint32_t));
+    std::memcpy(m_ListIndices.data() + offset, &elementCount, sizeof(elementCount));
+    std::memcpy(m_ListIndices.data() + offset + sizeof(elementCount), m_Scratch.data() + list.m_ScratchBase, elementCount * sizeof(std::uint32_t));
+
+    m_Scratch.resize(list.m_ScratchBase);
+}
+
+void GffBuilder::Finish(Raw::Gff* out)
+{
+    ASSERT(out);
+    ASSERT_MSG(m_Open.size() == 1, "Every struct and list must be ended before finishing.");
+    CloseStruct();
+
+    std::vector<GffFieldLabel> const& labels = m_Labels.GetLabels();
+
+    Raw::GffHeader& header = out->m_Header;
+    std::memcpy(header.m_FileType, m_FileType, sizeof(header.m_FileType));
+    std::memcpy(header.m_FileVersion, "V3.2", sizeof(header.m_FileVersion));
+
+    header.m_StructOffset = sizeof(Raw::GffHeader);
+    header.m_StructCount = static_cast<std::uint32_t>(m_Structs.size());
+
+    header.m_FieldOffset = header.m_StructOffset + (header.m_StructCount * sizeof(Raw::GffStruct));
+    header.m_FieldCount = static_cast<std::uint32_t>(m_Fields.size());
+
+    header.m_LabelOffset = header.m_FieldOffset + (header.m_FieldCount * sizeof(Raw::GffField));
+    header.m_LabelCount = static_cast<std::uint32_t>(labels.size());
+
+    header.m_FieldDataOffset = header.m_LabelOffset + (header.m_LabelCount * sizeof(Raw::GffLabel));
+    header.m_FieldDataCount = static_cast<std::uint32_t>(m_FieldData.size());
+
+    header.m_FieldIndicesOffset = header.m_FieldDataOffset + header.m_FieldDataCount;
+    header.m_FieldIndicesCount = static_cast<std::uint32_t>(m_FieldIndices.size() * sizeof(Raw::GffFieldIndex));
+
+    header.m_ListIndicesOffset = header.m_FieldIndicesOffset + header.m_FieldIndicesCount;
+    header.m_ListIndicesCount = static_cast<std::uint32_t>(m_ListIndices.size());
+
+    out->m_Labels.clear();
+    out->m_Labels.reserve(labels.size());
+
+    for (GffFieldLabel const& label : labels)
+    {
+        out->m_Labels.emplace_back(label.ToRawLabel());
+    }
+
+    out->m_Structs = std::move(m_Structs);
+    out->m_Fields = std::move(m_Fields);
+    out->m_FieldData = std::move(m_FieldData);
+    out->m_FieldIndices = std::move(m_FieldIndices);
+    out->m_ListIndices = std::move(m_ListIndices);
+
+    Reset();
+}
+
+bool GffBuilder::WriteToBytes(std::vector<std::byte>* out)
+{
+    ASSERT(out);
+
+    Raw::Gff gff;
+    Finish(&gff);
+
+    out->resize(gff.m_Header.m_ListIndicesOffset + gff.m_Header.m_ListIndicesCount);
+    std::byte* ptr = out->data();
+
+    auto append = [&ptr](void const* data, std::size_t length)
+    {
+        if (length)
+        {
+            std::memcpy(ptr, data, length);
+            ptr += length;
+        }
+    };
+
+    append(&gff.m_Header, sizeof(gff.m_Header));
+    append(gff.m_Structs.data(), gff.m_Structs.size() * sizeof(Raw::GffStruct));
+    append(gff.m_Fields.data(), gff.m_Fields.size() * sizeof(Raw::GffField));
+    append(gff.m_Labels.data(), gff.m_Labels.size() * sizeof(Raw::GffLabel));
+    append(gff.m_FieldData.data(), gff.m_FieldData.size());
+    append(gff.m_FieldIndices.data(), gff.m_FieldIndices.size() * sizeof(Raw::GffFieldIndex));
+    append(gff.m_ListIndices.data(), gff.m_ListIndices.size());
+
+    ASSERT(ptr == out->data() + out->size());
+    return true;
+}
+
+bool GffBuilder::WriteToFile(char const* path)
+{
+    ASSERT(path);
+
+    Raw::Gff gff;
+    Finish(&gff);
+    return gff.WriteToFile(path);
+}
+
+Raw::GffField& GffBuilder::AddFieldInternal(GffFieldLabel const& label, Raw::GffField::Type type)
+{
+    ASSERT_MSG(!m_Open.empty() && !m_Open.back().m_IsList, "Fields can only be added to a struct.");
+
+    m_Scratch.emplace_back(static_cast<std::uint32_t>(m_Fields.size()));
+
+    Raw::GffField& field = m_Fields.emplace_back();
+    field.m_Type = type;
+    field.m_LabelIndex = m_Labels.FindOrAdd(label);
+    field.m_DataOrDataOffset = 0;
+    return field;
+}
+
+void GffBuilder::OpenStruct(std::uint32_t id)
+{
+    m_Open.push_back({ static_cast<std::uint32_t>(m_Structs.size()), m_Scratch.size(), false });
+
+    Raw::GffStruct& gffStruct = m_Structs.emplace_back();
+    gffStruct.m_Type = id;
+    gffStruct.m_DataOrDataOffset = 0;
+    gffStruct.m_FieldCount = 0;
+}
+
+void GffBuilder::CloseStruct()
+{
+    OpenContainer open = m_Open.back();
+    m_Open.pop_back();
+
+    // The fields of a struct aren't contiguous when it contains other structs, so always go through the field
+    // indices unless there's only one field.
+    std::uint32_t fieldCount = static_cast<std::uint32_t>(m_Scratch.size() - open.m_ScratchBase);
+    Raw::GffStruct& gffStruct = m_Structs[open.m_Index];
+    gffStruct.m_FieldCount = fieldCount;
+
+    if (fieldCount == 1)
+    {
+        gffStruct.m_DataOrDataOffset = m_Scratch[open.m_ScratchBase];
+    }
+    else if (fieldCount > 1)
+    {
+        gffStruct.m_DataOrDataOffset = static_cast<std::uint32_t>(m_FieldIndices.size() * sizeof(Raw::GffFieldIndex));
+        m_FieldIndices.insert(std::end(m_FieldIndices), std::begin(m_Scratch) + open.m_ScratchBase, std::end(m_Scratch));
+    }
+
+    m_Scratch.resize(open.m_ScratchBase);
+}
+
+void GffBuilder::Reset()
+{
+    m_Labels.Clear();
+    m_Structs.clear();
+    m_Fields.clear();
+    m_FieldData.clear();
+    m_FieldIndices.clear();
+    m_ListIndices.clear();
+    m_Open.clear();
+    m_Scratch.clear();
+
+    OpenStruct(0xFFFFFFFF);
+}
+
+std::uint32_t GffBuilder::AppendFieldData(Type_DWORD64 const& value)
+{
+    std::uint32_t offset = static_cast<std::uint32_t>(m_FieldData.size());
+    AppendBytes(&value, sizeof(value));
+    return offset;
+}
+
+std::uint32_t GffBuilder::AppendFieldData(Type_INT64 const& value)
+{
+    std::uint32_t offset = static_cast<std::uint32_t>(m_FieldData.size());
+    AppendBytes(&value, sizeof(value));
+    return offset;
+}
+
+std::uint32_t GffBuilder::AppendFieldData(Type_DOUBLE const& value)
+{
+    std::uint32_t offset = static_cast<std::uint32_t>(m_FieldData.size());
+    AppendBytes(&value, sizeof(value));
+    return offset;
+}
+
+std::uint32_t GffBuilder::AppendFieldData(Type_CExoString const& value)
+{
+    std::uint32_t offset = static_cast<std::uint32_t>(m_FieldData.size());
+    std::uint32_t size = static_cast<std::uint32_t>(value.m_String.size());
+    AppendBytes(&size, sizeof(size));
+    AppendBytes(value.m_String.data(), size);
+    return offset;
+}
+
+std::uint32_t GffBuilder::AppendFieldData(Type_CResRef const& value)
+{
+    ASSERT(value.m_Size <= sizeof(value.m_String));
+
+    std::uint32_t offset = static_cast<std::uint32_t>(m_FieldData.size());
+    AppendBytes(&value.m_Size, sizeof(value.m_Size));
+    AppendBytes(value.m_String, value.m_Size);
+    return offset;
+}
+
+std::uint32_t GffBuilder::AppendFieldData(Type_CExoLocString const& value)
+{
+    std::uint32_t offset = static_cast<std::uint32_t>(m_FieldData.size());
+    std::uint32_t stringCount = static_cast<std::uint32_t>(value.m_SubStrings.size());
+    std::uint32_t totalSize = sizeof(value.m_StringRef) + sizeof(stringCount);
+
+    for (Type_CExoLocString::SubString const& substring : value.m_SubStrings)
+    {
+        totalSize += static_cast<std::uint32_t>(sizeof(substring.m_StringID) + sizeof(std::uint32_t) + substring.m_String.size());
+    }
+
+    AppendBytes(&totalSize, sizeof(totalSize));
+    AppendBytes(&value.m_StringRef, sizeof(value.m_StringRef));
+    AppendBytes(&stringCount, sizeof(stringCount));
+
+    for (Type_CExoLocString::SubString const& substring : value.m_SubStrings)
+    {
+        std::uint32_t length = static_cast<std::uint32_t>(substring.m_String.size());
+        AppendBytes(&substring.m_StringID, sizeof(substring.m_StringID));
+        AppendBytes(&length, sizeof(length));
+        AppendBytes(substring.m_String.data(), length);
+    }
+
+    return offset;
+}
+
+std::uint32_t GffBuilder::AppendFieldData(Type_VOID const& value)
+{
+    std::uint32_t offset = static_cast<std::uint32_t>(m_FieldData.size());
+    std::uint32_t size = static_cast<std::uint32_t>(value.m_Data.size());
+    AppendBytes(&size, sizeof(size));
+    AppendBytes(value.m_Data.data(), size);
+    return offset;
+}
+
+void GffBuilder::AppendBytes(void const* data, std::size_t length)
+{
+    std::byte const* bytes = static_cast<std::byte const*>(data);
+    m_FieldData.insert(std::end(m_FieldData), bytes, bytes + length);
+}
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "FileFormats/Gff/Gff_Friendly.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace FileFormats::Gff::Friendly {
+
+// GffBuilder writes a GFF from a sequence of calls, without building a friendly Gff first. Each field is encoded
+// into the raw sections as soon as it is added, so memory use is proportional to the size of the output rather than
+// to the object graph which would otherwise describe it. This is the one to use when generating large files, such as
+// a .git with thousands of placeables.
+//
+// The top level struct is open from construction, and fields are added to whichever struct was opened last:
+//
+//     GffBuilder builder("GIT ");
+//     builder.BeginList("Placeable List");
+//     for (Placeable const& placeable : placeables)
+//     {
+//         builder.BeginStruct(9);
+//         builder.AddField("Tag", placeable.m_Tag); // Type_CExoString
+//         builder.AddField<Type_FLOAT>("X", placeable.m_X);
+//         builder.EndStruct();
+//     }
+//     builder.EndList();
+//     builder.WriteToFile("area.git");
+//
+// Fields are written in the order they are added. Labels must be unique within a struct - this is not checked.
+class GffBuilder
+{
+public:
+    // fileType is the four character type written to the header, e.g. "GIT " or "UTC ".
+    explicit GffBuilder(char const* fileType);
+
+    // Adds a field to the current struct. T is any of the Type_* defines other than Type_Struct and Type_List.
+    // The CExoLocString size is calculated from its substrings - m_TotalSize is ignored.
+    template <typename T>
+    void AddField(GffFieldLabel const& label, T const& value);
+
+    // Adds a struct field to the current struct and opens the new struct.
+    void BeginStruct(GffFieldLabel const& label, std::uint32_t id);
+
+    // Adds an element to the current list and opens it.
+    void BeginStruct(std::uint32_t id);
+
+    void EndStruct();
+
+    // Adds a list field to the current struct and opens it. Elements are added with BeginStruct(id).
+    void BeginList(GffFieldLabel const& label);
+
+    void EndList();
+
+    // Closes the top level struct and moves the sections into out. Every other struct and list must have been ended.
+    // Afterwards, the builder is empty and ready to build another file of the same type.
+    void Finish(Raw::Gff* out);
+
+    // Finishes, then writes the file into out.
+    bool WriteToBytes(std::vector<std::byte>* out);
+
+    // Finishes, then writes every section straight to disk in a single write.
+    bool WriteToFile(char const* path);
+
+private:
+    // A struct or list which has been begun but not ended.
+    struct OpenContainer
+    {
+        // For a struct, the index into m_Structs. For a list, the index of the list's field in m_Fields.
+        std::uint32_t m_Index;
+
+        // Where the container's children start in m_Scratch - field indices for a struct, struct indices for a list.
+        std::size_t m_ScratchBase;
+
+        bool m_IsList;
+    };
+
+    // Appends the field to the current struct. The returned reference is valid until the next field is added.
+    Raw::GffField& AddFieldInternal(GffFieldLabel const& label, Raw::GffField::Type type);
+
+    void OpenStruct(std::uint32_t id);
+    void CloseStruct();
+    void Reset();
+
+    // Each returns the offset of the value in the field data section.
+    std::uint32_t AppendFieldData(Type_DWORD64 const& value);
+    std::uint32_t AppendFieldData(Type_INT64 const& value);
+    std::uint32_t AppendFieldData(Type_DOUBLE const& value);
+    std::uint32_t AppendFieldData(Type_CExoString const& value);
+    std::uint32_t AppendFieldData(Type_CResRef const& value);
+    std::uint32_t AppendFieldData(Type_CExoLocString const& value);
+    std::uint32_t AppendFieldData(Type_VOID const& value);
+    void AppendBytes(void const* data, std::size_t length);
+
+    char m_FileType[4];
+
+    // These are the same types as the sections of Raw::Gff, so Finish can hand them over without copying.
+    GffLabelTable m_Labels;
+    std::pmr::vector<Raw::GffStruct> m_Structs;
+    std::pmr::vector<Raw::GffField> m_Fields;
+    std::pmr::vector<Raw::GffFieldData> m_FieldData;
+    std::pmr::vector<Raw::GffFieldIndex> m_FieldIndices;
+    std::pmr::vector<Raw::GffListIndex> m_ListIndices;
+
+    std::vector<OpenContainer> m_Open;
+
+    // The children of every open container, used as a stack as containers nest.
+    std::vector<std::uint32_t> m_Scratch;
+};
+
+template <typename T>
+void GffBuilder::AddField(GffFieldLabel const& label, T const& value)
+{
+    constexpr Raw::GffField::Type type = GffFieldTypeOf<T>::Value;
+    static_assert(type != Raw::GffField::Type::Struct && type != Raw::GffField::Type::List,
+        "Structs and lists are added with BeginStruct and BeginList.");
+
+    Raw::GffField& field = AddFieldInternal(label, type);
+
+    if constexpr (std::is_arithmetic_v<T> && sizeof(T) <= sizeof(field.m_DataOrDataOffset))
+    {
+        std::memcpy(&field.m_DataOrDataOffset, &value, sizeof(value));
+    }
+    else
+    {
+        field.m_DataOrDataOffset = AppendFieldData(value);
+    }
+}
+
+}
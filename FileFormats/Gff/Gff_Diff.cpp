@@ -0,0 +1,406 @@
+#include "FileFormats/Gff/Gff_Diff.hpp"
+#include "Utility/Assert.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace FileFormats::Gff::Friendly {
+
+namespace {
+
+// Fixed size values are compared by their bits, so that a float which changed from 0.0 to -0.0 is a change, and a
+// NaN which didn't change isn't.
+template <typename T>
+bool ValuesEqual(T const& lhs, T const& rhs)
+{
+    static_assert(std::is_arithmetic_v<T>, "Only fixed size types can be compared by their bits.");
+    return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+}
+
+bool ValuesEqual(Type_CExoString const& lhs, Type_CExoString const& rhs)
+{
+    return lhs.m_String == rhs.m_String;
+}
+
+bool ValuesEqual(Type_CResRef const& lhs, Type_CResRef const& rhs)
+{
+    return lhs.m_Size == rhs.m_Size && std::memcmp(lhs.m_String, rhs.m_String, lhs.m_Size) == 0;
+}
+
+bool ValuesEqual(Type_CExoLocString const& lhs, Type_CExoLocString const& rhs)
+{
+    if (lhs.m_StringRef != rhs.m_StringRef || lhs.m_SubStrings.size() != rhs.m_SubStrings.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < lhs.m_SubStrings.size(); ++i)
+    {
+        if (lhs.m_SubStrings[i].m_StringID != rhs.m_SubStrings[i].m_StringID ||
+            lhs.m_SubStrings[i].m_String != rhs.m_SubStrings[i].m_String)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ValuesEqual(Type_VOID const& lhs, Type_VOID const& rhs)
+{
+    return lhs.m_Data == rhs.m_Data;
+}
+
+bool ValuesEqual(Type_Struct const& lhs, Type_Struct const& rhs)
+{
+    return lhs.GetHash() == rhs.GetHash();
+}
+
+bool ValuesEqual(Type_List const& lhs, Type_List const& rhs)
+{
+    return lhs.GetHash() == rhs.GetHash();
+}
+
+bool ValuesEqual(GffFieldValue const& lhs, GffFieldValue const& rhs)
+{
+    if (lhs.GetType() != rhs.GetType())
+    {
+        return false;
+    }
+
+    bool equal = false;
+
+    Visit(lhs, [&rhs, &equal](auto const& value)
+    {
+        equal = ValuesEqual(value, *rhs.Get<std::decay_t<decltype(value)>>());
+    });
+
+    return equal;
+}
+
+GffFieldValue const* FindFieldValue(GffStruct const& gffStruct, GffFieldLabel const& label)
+{
+    GffStruct::FieldMap const& fields = gffStruct.GetFields();
+
+    auto entry = std::lower_bound(std::begin(fields), std::end(fields), label,
+        [](GffStruct::FieldMap::value_type const& kvp, GffFieldLabel const& rhs) { return kvp.first < rhs; });
+
+    return entry != std::end(fields) && entry->first == label ? &entry->second : nullptr;
+}
+
+class GffDiffer
+{
+public:
+    GffDiffer(GffDiffOptions const& options, std::vector<GffEdit>* out);
+
+    void DiffStruct(GffStruct const& from, GffStruct const& to);
+
+private:
+    // Compares a field which is on both sides. The field is pushed onto the path for the duration.
+    void DiffField(GffFieldLabel const& label, GffFieldValue const& from, GffFieldValue const& to);
+
+    // These compare the list at the end of the path.
+    void DiffList(GffList const& from, GffList const& to);
+    void DiffListByPosition(std::pmr::vector<GffStruct> const& from, std::pmr::vector<GffStruct> const& to);
+    void DiffListByKey(std::pmr::vector<GffStruct> const& from, std::pmr::vector<GffStruct> const& to,
+        std::vector<GffFieldLabel> const& keys);
+
+    void PushField(GffFieldLabel const& label);
+
+    // Points the list at the end of the path at one of its elements, until ClearElement.
+    void SetElement(std::uint32_t fromIndex, std::uint32_t toIndex, GffStruct const& element,
+        std::vector<GffFieldLabel> const* keys);
+    void ClearElement();
+
+    void AddEdit(GffEdit::Type type, GffFieldValue from, GffFieldValue to);
+
+    std::vector<GffFieldLabel> const* FindKeys(GffFieldLabel const& listLabel) const;
+
+    static std::uint64_t HashKeys(GffStruct const& element, std::vector<GffFieldLabel> const& keys);
+    static bool KeysEqual(GffStruct const& lhs, GffStruct const& rhs, std::vector<GffFieldLabel> const& keys);
+
+    GffDiffOptions const& m_Options;
+    std::vector<GffEdit>& m_Out;
+    std::vector<GffEditPathSegment> m_Path;
+};
+
+GffDiffer::GffDiffer(GffDiffOptions const& options, std::vector<GffEdit>* out) : m_Options(options), m_Out(*out)
+{ }
+
+void GffDiffer::DiffStruct(GffStruct const& from, GffStruct const& to)
+{
+    if (from.GetHash() == to.GetHash())
+    {
+        return;
+    }
+
+    if (from.GetUserDefinedId() != to.GetUserDefinedId())
+    {
+        AddEdit(GffEdit::Type::ChangeStructId, GffFieldValue(Type_DWORD(from.GetUserDefinedId())),
+            GffFieldValue(Type_DWORD(to.GetUserDefinedId())));
+    }
+
+    // Both sides are sorted by label, so they can be merged in a single pass.
+    GffStruct::FieldMap const& fromFields = from.GetFields();
+    GffStruct::FieldMap const& toFields = to.GetFields();
+
+    auto fromField = std::begin(fromFields);
+    auto toField = std::begin(toFields);
+
+    while (fromField != std::end(fromFields) || toField != std::end(toFields))
+    {
+        if (toField == std::end(toFields) || (fromField != std::end(fromFields) && fromField->first < toField->first))
+        {
+            PushField(fromField->first);
+            AddEdit(GffEdit::Type::RemoveField, fromField->second, GffFieldValue());
+            m_Path.pop_back();
+            ++fromField;
+        }
+        else if (fromField == std::end(fromFields) || toField->first < fromField->first)
+        {
+            PushField(toField->first);
+            AddEdit(GffEdit::Type::AddField, GffFieldValue(), toField->second);
+            m_Path.pop_back();
+            ++toField;
+        }
+        else
+        {
+            DiffField(toField->first, fromField->second, toField->second);
+            ++fromField;
+            ++toField;
+        }
+    }
+}
+
+void GffDiffer::DiffField(GffFieldLabel const& label, GffFieldValue const& from, GffFieldValue const& to)
+{
+    PushField(label);
+
+    if (from.GetType() == to.GetType() && from.GetType() == Raw::GffField::Type::Struct)
+    {
+        DiffStruct(*from.Get<Type_Struct>(), *to.Get<Type_Struct>());
+    }
+    else if (from.GetType() == to.GetType() && from.GetType() == Raw::GffField::Type::List)
+    {
+        DiffList(*from.Get<Type_List>(), *to.Get<Type_List>());
+    }
+    else if (!ValuesEqual(from, to))
+    {
+        AddEdit(GffEdit::Type::ChangeField, from, to);
+    }
+
+    m_Path.pop_back();
+}
+
+void GffDiffer::DiffList(GffList const& from, GffList const& to)
+{
+    if (from.GetHash() == to.GetHash())
+    {
+        return;
+    }
+
+    if (std::vector<GffFieldLabel> const* keys = FindKeys(m_Path.back().m_Label))
+    {
+        DiffListByKey(from.GetStructs(), to.GetStructs(), *keys);
+    }
+    else
+    {
+        DiffListByPosition(from.GetStructs(), to.GetStructs());
+    }
+}
+
+void GffDiffer::DiffListByPosition(std::pmr::vector<GffStruct> const& from, std::pmr::vector<GffStruct> const& to)
+{
+    std::uint32_t fromCount = static_cast<std::uint32_t>(from.size());
+    std::uint32_t toCount = static_cast<std::uint32_t>(to.size());
+
+    for (std::uint32_t i = 0; i < std::min(fromCount, toCount); ++i)
+    {
+        if (from[i].GetHash() != to[i].GetHash())
+        {
+            SetElement(i, i, to[i], nullptr);
+            DiffStruct(from[i], to[i]);
+        }
+    }
+
+    for (std::uint32_t i = toCount; i < fromCount; ++i)
+    {
+        SetElement(i, GffEditPathSegment::NoElement, from[i], nullptr);
+        AddEdit(GffEdit::Type::RemoveElement, GffFieldValue(from[i]), GffFieldValue());
+    }
+
+    for (std::uint32_t i = fromCount; i < toCount; ++i)
+    {
+        SetElement(GffEditPathSegment::NoElement, i, to[i], nullptr);
+        AddEdit(GffEdit::Type::AddElement, GffFieldValue(), GffFieldValue(to[i]));
+    }
+
+    ClearElement();
+}
+
+void GffDiffer::DiffListByKey(std::pmr::vector<GffStruct> const& from, std::pmr::vector<GffStruct> const& to,
+    std::vector<GffFieldLabel> const& keys)
+{
+    // The from side is sorted by the hash of its keys, so each element on the to side finds its match with a binary
+    // search rather than a scan. Elements with equal keys are matched up in order.
+    struct KeyedElement
+    {
+        std::uint64_t m_KeyHash;
+        std::uint32_t m_Index;
+
+        bool operator<(KeyedElement const& rhs) const
+        {
+            return m_KeyHash < rhs.m_KeyHash || (m_KeyHash == rhs.m_KeyHash && m_Index < rhs.m_Index);
+        }
+    };
+
+    std::vector<KeyedElement> fromKeys;
+    fromKeys.reserve(from.size());
+
+    for (std::uint32_t i = 0; i < from.size(); ++i)
+    {
+        fromKeys.push_back({ HashKeys(from[i], keys), i });
+    }
+
+    std::sort(std::begin(fromKeys), std::end(fromKeys));
+    std::vector<bool> matched(from.size(), false);
+
+    for (std::uint32_t toIndex = 0; toIndex < to.size(); ++toIndex)
+    {
+        GffStruct const& element = to[toIndex];
+        std::uint64_t keyHash = HashKeys(element, keys);
+        std::uint32_t fromIndex = GffEditPathSegment::NoElement;
+
+        for (auto candidate = std::lower_bound(std::begin(fromKeys), std::end(fromKeys), KeyedElement { keyHash, 0 });
+            candidate != std::end(fromKeys) && candidate->m_KeyHash == keyHash;
+            ++candidate)
+        {
+            if (!matched[candidate->m_Index] && KeysEqual(from[candidate->m_Index], element, keys))
+            {
+                fromIndex = candidate->m_Index;
+                break;
+            }
+        }
+
+        if (fromIndex == GffEditPathSegment::NoElement)
+        {
+            SetElement(GffEditPathSegment::NoElement, toIndex, element, &keys);
+            AddEdit(GffEdit::Type::AddElement, GffFieldValue(), GffFieldValue(element));
+            continue;
+        }
+
+        matched[fromIndex] = true;
+
+        if (from[fromIndex].GetHash() != element.GetHash())
+        {
+            SetElement(fromIndex, toIndex, element, &keys);
+            DiffStruct(from[fromIndex], element);
+        }
+    }
+
+    for (std::uint32_t fromIndex = 0; fromIndex < from.size(); ++fromIndex)
+    {
+        if (!matched[fromIndex])
+        {
+            SetElement(fromIndex, GffEditPathSegment::NoElement, from[fromIndex], &keys);
+            AddEdit(GffEdit::Type::RemoveElement, GffFieldValue(from[fromIndex]), GffFieldValue());
+        }
+    }
+
+    ClearElement();
+}
+
+void GffDiffer::PushField(GffFieldLabel const& label)
+{
+    m_Path.emplace_back().m_Label = label;
+}
+
+void GffDiffer::SetElement(std::uint32_t fromIndex, std::uint32_t toIndex, GffStruct const& element,
+    std::vector<GffFieldLabel> const* keys)
+{
+    GffEditPathSegment& segment = m_Path.back();
+    segment.m_FromIndex = fromIndex;
+    segment.m_ToIndex = toIndex;
+    segment.m_Key.clear();
+
+    if (keys)
+    {
+        for (GffFieldLabel const& key : *keys)
+        {
+            if (GffFieldValue const* value = FindFieldValue(element, key))
+            {
+                segment.m_Key.emplace_back(key, *value);
+            }
+        }
+    }
+}
+
+void GffDiffer::ClearElement()
+{
+    GffEditPathSegment& segment = m_Path.back();
+    segment.m_FromIndex = GffEditPathSegment::NoElement;
+    segment.m_ToIndex = GffEditPathSegment::NoElement;
+    segment.m_Key.clear();
+}
+
+void GffDiffer::AddEdit(GffEdit::Type type, GffFieldValue from, GffFieldValue to)
+{
+    GffEdit& edit = m_Out.emplace_back();
+    edit.m_Type = type;
+    edit.m_Path = m_Path;
+    edit.m_From = std::move(from);
+    edit.m_To = std::move(to);
+}
+
+std::vector<GffFieldLabel> const* GffDiffer::FindKeys(GffFieldLabel const& listLabel) const
+{
+    for (auto const& listKeys : m_Options.m_ListKeys)
+    {
+        if (listKeys.first == listLabel)
+        {
+            return &listKeys.second;
+        }
+    }
+
+    return nullptr;
+}
+
+std::uint64_t GffDiffer::HashKeys(GffStruct const& element, std::vector<GffFieldLabel> const& keys)
+{
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (GffFieldLabel const& key : keys)
+    {
+        GffFieldValue const* value = FindFieldValue(element, key);
+        hash = (hash ^ (value ? value->GetHash() : 0)) * 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+bool GffDiffer::KeysEqual(GffStruct const& lhs, GffStruct const& rhs, std::vector<GffFieldLabel> const& keys)
+{
+    for (GffFieldLabel const& key : keys)
+    {
+        GffFieldValue const* lhsValue = FindFieldValue(lhs, key);
+        GffFieldValue const* rhsValue = FindFieldValue(rhs, key);
+
+        if (lhsValue && rhsValue ? !ValuesEqual(*lhsValue, *rhsValue) : lhsValue != rhsValue)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+void DiffGff(GffStruct const& from, GffStruct const& to, GffDiffOptions const& options, std::vector<GffEdit>* out)
+{
+    ASSERT(out);
+    GffDiffer(options, out).DiffStruct(from, to);
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "FileFormats/Gff/Gff_Friendly.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace FileFormats::Gff::Friendly {
+
+// Compares two GFFs field by field and describes the difference as a list of edits, which Json::WriteEditScriptToJson
+// writes out in a machine readable form.
+//
+// Every struct and list is compared by its hash first (see GffStruct::GetHash), so identical subtrees are skipped
+// without being walked - the cost of a diff is the cost of hashing both sides once, plus the size of the changes.
+// Fields are matched by label. List elements are matched by position, unless the list is keyed in the options, in
+// which case they are matched by the values of their key fields and any change of order is ignored.
+
+struct GffDiffOptions
+{
+    // The key fields of each keyed list, by the label of the list. The keys apply to lists with that label at any
+    // depth. For example, { "VarTable", { "Name" } } matches local variables by name.
+    std::vector<std::pair<GffFieldLabel, std::vector<GffFieldLabel>>> m_ListKeys;
+};
+
+// One step along the path to an edit: a field of the struct reached so far and, if the field is a list, an element
+// of it - in which case the step reaches the element.
+struct GffEditPathSegment
+{
+    static constexpr std::uint32_t NoElement = 0xFFFFFFFF;
+
+    GffFieldLabel m_Label;
+
+    // The index of the element in the list on each side. This is NoElement on the side the element is missing from,
+    // or on both sides if the field is not a list.
+    std::uint32_t m_FromIndex = NoElement;
+    std::uint32_t m_ToIndex = NoElement;
+
+    // The key fields of the element in a keyed list, in the order the keys are listed in the options. A key field
+    // the element doesn't have is left out.
+    std::vector<std::pair<GffFieldLabel, GffFieldValue>> m_Key;
+};
+
+struct GffEdit
+{
+    enum class Type
+    {
+        AddField,       // The field at the path was added with the value m_To.
+        RemoveField,    // The field at the path, with the value m_From, was removed.
+        ChangeField,    // The field at the path changed from m_From to m_To - which may be of different types.
+        AddElement,     // The list element at the path was added. m_To is the struct.
+        RemoveElement,  // The list element at the path was removed. m_From is the struct.
+        ChangeStructId  // The ID of the struct at the path changed from m_From to m_To, as DWORDs.
+    };
+
+    Type m_Type;
+
+    // From the top level struct to the edit. A path to a struct (for ChangeStructId) is empty for the top level
+    // struct, and otherwise ends with the struct field or list element.
+    std::vector<GffEditPathSegment> m_Path;
+
+    // Structs and lists are shared rather than copied - see GffStruct.
+    GffFieldValue m_From;
+    GffFieldValue m_To;
+};
+
+// Appends the edits which turn from into to. Nothing is appended if they are the same.
+void DiffGff(GffStruct const& from, GffStruct const& to, GffDiffOptions const& options, std::vector<GffEdit>* out);
+
+}
@@ -1,8 +1,10 @@
 #include "FileFormats/Gff/Gff_Friendly.hpp"
+#include "Utility/FileWriter.hpp"
+#include "Utility/ThreadPool.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
-#include <unordered_map>
 
 namespace FileFormats::Gff::Friendly {
 
@@ -86,501 +88,1568 @@ Raw::GffField::Type GetTypeFromType(const Type_List&)
     return Raw::GffField::Type::List;
 }
 
-GffStruct::GffStruct(Raw::GffStruct const& rawStruct, Raw::Gff const& rawGff)
+namespace {
+
+constexpr std::uint64_t HashSeed = 0xCBF29CE484222325ull;
+
+std::uint64_t HashMix(std::uint64_t hash)
 {
-    ConstructInternal(rawStruct, rawGff);
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
 }
 
-GffStruct::GffStruct(Raw::GffField const& rawField, Raw::Gff const& rawGff)
+std::uint64_t HashCombine(std::uint64_t hash, std::uint64_t value)
 {
-    ConstructInternal(rawGff.ConstructStruct(rawField), rawGff);
+    return HashMix(hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2)));
 }
 
-GffStruct::FieldMap const& GffStruct::GetFields() const
+// Hashes the length and then the bytes, eight at a time.
+std::uint64_t HashBytes(std::uint64_t hash, void const* data, std::size_t length)
+{
+    char const* bytes = static_cast<char const*>(data);
+    hash = HashCombine(hash, length);
+
+    for (; length >= sizeof(std::uint64_t); bytes += sizeof(std::uint64_t), length -= sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        hash = HashCombine(hash, word);
+    }
+
+    if (length)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes, length);
+        hash = HashCombine(hash, word);
+    }
+
+    return hash;
+}
+
+template <typename T>
+std::uint64_t HashBits(std::uint64_t hash, T value)
+{
+    static_assert(sizeof(T) <= sizeof(std::uint64_t), "Only fixed size types can be hashed by their bits.");
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(value));
+    return HashCombine(hash, bits);
+}
+
+}
+
+GffFieldValue::GffFieldValue(GffFieldValue const& rhs)
 {
-    return m_Fields;
+    CopyFrom(rhs);
 }
 
-bool GffStruct::DeleteField(std::string const& fieldName)
+static_assert(std::is_nothrow_move_constructible_v<GffFieldValue> && std::is_nothrow_move_assignable_v<GffFieldValue>,
+    "Field vectors copy values which can't be moved without throwing when they grow.");
+
+GffFieldValue::GffFieldValue(GffFieldValue&& rhs) noexcept
 {
-    auto iter = m_Fields.find(fieldName);
+    MoveFrom(std::move(rhs));
+}
 
-    if (iter != std::end(m_Fields))
+GffFieldValue& GffFieldValue::operator=(GffFieldValue const& rhs)
+{
+    if (this != &rhs)
     {
-        m_Fields.erase(iter);
-        return true;
+        Destroy();
+        CopyFrom(rhs);
     }
 
-    return false;
+    return *this;
 }
 
-std::uint32_t GffStruct::GetUserDefinedId() const
+GffFieldValue& GffFieldValue::operator=(GffFieldValue&& rhs) noexcept
 {
-    return m_UserDefinedId;
+    if (this != &rhs)
+    {
+        Destroy();
+        MoveFrom(std::move(rhs));
+    }
+
+    return *this;
 }
 
-void GffStruct::SetUserDefinedId(std::uint32_t id)
+GffFieldValue::~GffFieldValue()
 {
-    m_UserDefinedId = id;
+    Destroy();
 }
 
-void GffStruct::ConstructInternal(Raw::GffStruct const& rawStruct, Raw::Gff const& rawGff)
+std::uint64_t GffFieldValue::GetHash() const
 {
-    m_UserDefinedId = rawStruct.m_Type;
-
-    std::vector<Raw::GffField> fields;
+    std::uint64_t hash = HashCombine(HashSeed, static_cast<std::uint64_t>(m_Type));
 
-    // Sometimes NWN (toolset?) produces ill-formed structures - whether a non-root structure with data offset as 0xFFFFFFFF
-    // or an empty struct. This check guards against these cases.
-    if (rawStruct.m_FieldCount && rawStruct.m_DataOrDataOffset != 0xFFFFFFFF)
+    switch (m_Type)
     {
-        if (rawStruct.m_FieldCount == 1)
+        case Raw::GffField::Type::BYTE:    return HashBits(hash, m_BYTE);
+        case Raw::GffField::Type::CHAR:    return HashBits(hash, m_CHAR);
+        case Raw::GffField::Type::WORD:    return HashBits(hash, m_WORD);
+        case Raw::GffField::Type::SHORT:   return HashBits(hash, m_SHORT);
+        case Raw::GffField::Type::DWORD:   return HashBits(hash, m_DWORD);
+        case Raw::GffField::Type::INT:     return HashBits(hash, m_INT);
+        case Raw::GffField::Type::DWORD64: return HashBits(hash, m_DWORD64);
+        case Raw::GffField::Type::INT64:   return HashBits(hash, m_INT64);
+        case Raw::GffField::Type::FLOAT:   return HashBits(hash, m_FLOAT);
+        case Raw::GffField::Type::DOUBLE:  return HashBits(hash, m_DOUBLE);
+
+        case Raw::GffField::Type::CExoString:
         {
-            fields.emplace_back(rawGff.m_Fields[rawStruct.m_DataOrDataOffset]);
+            std::string const& string = Get<Type_CExoString>()->m_String;
+            return HashBytes(hash, string.data(), string.size());
         }
-        else
+
+        case Raw::GffField::Type::ResRef:
         {
-            std::uint32_t offsetIntoFieldIndexArray = rawStruct.m_DataOrDataOffset / sizeof(Raw::GffFieldIndex);
-            ASSERT(offsetIntoFieldIndexArray < rawGff.m_FieldIndices.size());
+            Type_CResRef const& resref = *Get<Type_CResRef>();
+            ASSERT(resref.m_Size <= sizeof(resref.m_String));
+            return HashBytes(hash, resref.m_String, resref.m_Size);
+        }
 
-            for (std::size_t i = 0; i < rawStruct.m_FieldCount; ++i)
+        case Raw::GffField::Type::CExoLocString:
+        {
+            // The total size is derived from the substrings, so it doesn't need hashing.
+            Type_CExoLocString const& locString = *Get<Type_CExoLocString>();
+            hash = HashCombine(hash, locString.m_StringRef);
+
+            for (Type_CExoLocString::SubString const& substring : locString.m_SubStrings)
             {
-                std::uint32_t offsetIntoFieldArray = rawGff.m_FieldIndices[offsetIntoFieldIndexArray + i];
-                ASSERT(offsetIntoFieldArray < rawGff.m_Fields.size());
-                fields.emplace_back(rawGff.m_Fields[offsetIntoFieldArray]);
+                hash = HashBits(hash, substring.m_StringID);
+                hash = HashBytes(hash, substring.m_String.data(), substring.m_String.size());
             }
-        }
-    }
-
-    ConstructInternal(fields, rawGff);
-}
 
-void GffStruct::ConstructInternal(std::vector<Raw::GffField> const& rawFields, Raw::Gff const& rawGff)
-{
-    for (Raw::GffField const& rawField : rawFields)
-    {
-        char const* rawLabel = rawGff.m_Labels[rawField.m_LabelIndex].m_Label;
-        std::string label = std::string(rawLabel, rawLabel + strnlen(rawLabel, 16));
-        ASSERT(m_Fields.find(label) == std::end(m_Fields));
+            return hash;
+        }
 
-        switch (rawField.m_Type)
+        case Raw::GffField::Type::VOID:
         {
-            case Raw::GffField::Type::BYTE:          m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructBYTE(rawField)); break;
-            case Raw::GffField::Type::CHAR:          m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructCHAR(rawField)); break;
-            case Raw::GffField::Type::WORD:          m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructWORD(rawField)); break;
-            case Raw::GffField::Type::SHORT:         m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructSHORT(rawField)); break;
-            case Raw::GffField::Type::DWORD:         m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructDWORD(rawField)); break;
-            case Raw::GffField::Type::INT:           m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructINT(rawField)); break;
-            case Raw::GffField::Type::DWORD64:       m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructDWORD64(rawField)); break;
-            case Raw::GffField::Type::INT64:         m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructINT64(rawField)); break;
-            case Raw::GffField::Type::FLOAT:         m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructFLOAT(rawField)); break;
-            case Raw::GffField::Type::DOUBLE:        m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructDOUBLE(rawField)); break;
-            case Raw::GffField::Type::CExoString:    m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructCExoString(rawField)); break;
-            case Raw::GffField::Type::ResRef:        m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructResRef(rawField)); break;
-            case Raw::GffField::Type::CExoLocString: m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructCExoLocString(rawField)); break;
-            case Raw::GffField::Type::VOID:          m_Fields[label] = std::make_pair(rawField.m_Type, rawGff.ConstructVOID(rawField)); break;
-            case Raw::GffField::Type::Struct:        m_Fields[label] = std::make_pair(rawField.m_Type, GffStruct(rawField, rawGff)); break;
-            case Raw::GffField::Type::List:          m_Fields[label] = std::make_pair(rawField.m_Type, GffList(rawField, rawGff)); break;
-            default: ASSERT_FAIL_MSG("Unrecognised GFF field type: %d", rawField.m_Type); break;
+            std::vector<std::byte> const& data = Get<Type_VOID>()->m_Data;
+            return HashBytes(hash, data.data(), data.size());
         }
+
+        case Raw::GffField::Type::Struct:  return HashCombine(hash, Get<Type_Struct>()->GetHash());
+        case Raw::GffField::Type::List:    return HashCombine(hash, Get<Type_List>()->GetHash());
+        default:                           ASSERT_FAIL(); return hash;
     }
 }
 
-GffList::GffList(Raw::GffField const& rawField, Raw::Gff const& rawGff)
+void GffFieldValue::CopyFrom(GffFieldValue const& rhs)
 {
-    ASSERT(rawField.m_Type == Raw::GffField::Type::List);
-
-    Raw::GffField::Type_List list = rawGff.ConstructList(rawField);
+    m_Type = rhs.m_Type;
 
-    for (std::uint32_t offsetIntoStructArray : list.m_Elements)
+    switch (m_Type)
     {
-        ASSERT(offsetIntoStructArray < rawGff.m_Structs.size());
-        m_Structs.emplace_back(rawGff.m_Structs[offsetIntoStructArray], rawGff);
+        case Raw::GffField::Type::CExoString:    m_Complex = new Type_CExoString(*rhs.Get<Type_CExoString>()); break;
+        case Raw::GffField::Type::ResRef:        m_Complex = new Type_CResRef(*rhs.Get<Type_CResRef>()); break;
+        case Raw::GffField::Type::CExoLocString: m_Complex = new Type_CExoLocString(*rhs.Get<Type_CExoLocString>()); break;
+        case Raw::GffField::Type::VOID:          m_Complex = new Type_VOID(*rhs.Get<Type_VOID>()); break;
+        case Raw::GffField::Type::Struct:        m_Complex = new Type_Struct(*rhs.Get<Type_Struct>()); break;
+        case Raw::GffField::Type::List:          m_Complex = new Type_List(*rhs.Get<Type_List>()); break;
+        default:                                 std::memcpy(&m_DWORD64, &rhs.m_DWORD64, sizeof(m_DWORD64)); break;
     }
 }
 
-std::vector<GffStruct>& GffList::GetStructs()
+void GffFieldValue::MoveFrom(GffFieldValue&& rhs) noexcept
 {
-    return m_Structs;
+    static_assert(sizeof(m_DWORD64) >= sizeof(m_Complex) && sizeof(m_DWORD64) >= sizeof(m_DOUBLE),
+        "The widest member of the union is used to copy the whole union.");
+
+    // Whatever is stored, copying the union bytes is enough - the pointer to a complex type just changes hands.
+    // The source is left as a BYTE so it no longer owns anything.
+    m_Type = rhs.m_Type;
+    std::memcpy(&m_DWORD64, &rhs.m_DWORD64, sizeof(m_DWORD64));
+    rhs.m_Type = Raw::GffField::Type::BYTE;
+    rhs.m_BYTE = 0;
 }
 
-std::vector<GffStruct> const& GffList::GetStructs() const
+void GffFieldValue::Destroy() noexcept
 {
-    return m_Structs;
+    switch (m_Type)
+    {
+        case Raw::GffField::Type::CExoString:    delete Get<Type_CExoString>(); break;
+        case Raw::GffField::Type::ResRef:        delete Get<Type_CResRef>(); break;
+        case Raw::GffField::Type::CExoLocString: delete Get<Type_CExoLocString>(); break;
+        case Raw::GffField::Type::VOID:          delete Get<Type_VOID>(); break;
+        case Raw::GffField::Type::Struct:        delete Get<Type_Struct>(); break;
+        case Raw::GffField::Type::List:          delete Get<Type_List>(); break;
+        default: break;
+    }
+
+    m_Type = Raw::GffField::Type::BYTE;
+    m_BYTE = 0;
 }
 
-Gff::Gff() : m_TopLevelStruct()
+GffStruct::GffStruct() : m_Node(MakeNode(std::pmr::get_default_resource()))
 { }
 
-Gff::Gff(Raw::Gff const& rawGff) : m_TopLevelStruct(rawGff.m_Structs[0], rawGff)
+GffStruct::GffStruct(std::pmr::memory_resource* resource) : m_Node(MakeNode(resource))
 { }
 
-GffStruct& Gff::GetTopLevelStruct()
+GffStruct::GffStruct(Raw::GffStruct const& rawStruct, Raw::Gff const& rawGff, ThreadPool* pool, std::pmr::memory_resource* resource)
+    : m_Node(MakeNode(resource))
 {
-    return m_TopLevelStruct;
+    ConstructInternal(rawStruct, rawGff, nullptr, pool);
 }
 
-GffStruct const& Gff::GetTopLevelStruct() const
+GffStruct::GffStruct(Raw::GffStruct const& rawStruct, Raw::GffView const& rawGff, ThreadPool* pool, std::pmr::memory_resource* resource)
+    : m_Node(MakeNode(resource))
 {
-    return m_TopLevelStruct;
+    ConstructInternal(rawStruct, rawGff, nullptr, pool);
 }
 
-struct GffCreator
-{
-public:
-    std::unique_ptr<Raw::Gff> Create(const GffStruct& topLevelStruct);
-
-private:
-    template <typename T>
-    Raw::GffField CreateField(const GffStruct& parent,
-        const GffStruct::FieldMap::value_type& kvp);
-
-    std::uint32_t CreateLabel(const std::string& str);
-
-    // Each of these returns an index into the relevant array (either struct or field).
-    Raw::GffField InsertIntoRawGff(const Type_BYTE& type);
-    Raw::GffField InsertIntoRawGff(const Type_CHAR& type);
-    Raw::GffField InsertIntoRawGff(const Type_WORD& type);
-    Raw::GffField InsertIntoRawGff(const Type_SHORT& type);
-    Raw::GffField InsertIntoRawGff(const Type_DWORD& type);
-    Raw::GffField InsertIntoRawGff(const Type_INT& type);
-    Raw::GffField InsertIntoRawGff(const Type_DWORD64& type);
-    Raw::GffField InsertIntoRawGff(const Type_INT64& type);
-    Raw::GffField InsertIntoRawGff(const Type_FLOAT& type);
-    Raw::GffField InsertIntoRawGff(const Type_DOUBLE& type);
-    Raw::GffField InsertIntoRawGff(const Type_CExoString& type);
-    Raw::GffField InsertIntoRawGff(const Type_CResRef& type);
-    Raw::GffField InsertIntoRawGff(const Type_CExoLocString& type);
-    Raw::GffField InsertIntoRawGff(const Type_VOID& type);
-    Raw::GffField InsertIntoRawGff(const Type_Struct& type);
-    Raw::GffField InsertIntoRawGff(const Type_List& type);
-
-private:
-    std::unique_ptr<Raw::Gff> m_RawGff;
-    std::unordered_map<std::string, std::uint32_t> m_LabelCache;
-};
-
-bool Gff::WriteToFile(char const* path) const
+GffStruct::GffStruct(Raw::GffField const& rawField, Raw::Gff const& rawGff, ThreadPool* pool, std::pmr::memory_resource* resource)
+    : m_Node(MakeNode(resource))
 {
-    return GffCreator().Create(m_TopLevelStruct)->WriteToFile(path);
+    ConstructInternal(rawGff.ConstructStruct(rawField), rawGff, nullptr, pool);
 }
 
-std::unique_ptr<Raw::Gff> GffCreator::Create(const GffStruct& topLevelStruct)
+GffStruct::GffStruct(Raw::GffField const& rawField, Raw::GffView const& rawGff, ThreadPool* pool, std::pmr::memory_resource* resource)
+    : m_Node(MakeNode(resource))
 {
-    m_RawGff = std::make_unique<Raw::Gff>();
-    InsertIntoRawGff(topLevelStruct);
-
-    Raw::GffHeader* header = &m_RawGff->m_Header;
-    std::memcpy(header->m_FileType, "UTC ", 4);
-    std::memcpy(header->m_FileVersion, "V3.2", 4);
+    ConstructInternal(rawGff.ConstructStruct(rawField), rawGff, nullptr, pool);
+}
 
-    header->m_StructOffset = sizeof(Raw::GffHeader);
-    header->m_StructCount = static_cast<std::uint32_t>(m_RawGff->m_Structs.size());
+GffStruct::GffStruct(std::shared_ptr<Raw::GffView const> rawGff, std::uint32_t structIndex,
+    std::pmr::memory_resource* resource) : m_Node(MakeNode(resource))
+{
+    ASSERT(rawGff);
+    ASSERT(structIndex < rawGff->m_Structs.size());
+
+    // The ID is available without decoding anything, so we may as well read it now.
+    m_Node->m_UserDefinedId = rawGff->m_Structs[structIndex].m_Type;
+    m_Node->m_Source = std::move(rawGff);
+    m_Node->m_SourceStructIndex = structIndex;
+    m_Node->m_Decoded = false;
+}
 
-    header->m_FieldOffset = header->m_StructOffset + (header->m_StructCount * sizeof(Raw::GffStruct));
-    header->m_FieldCount = static_cast<std::uint32_t>(m_RawGff->m_Fields.size());
+GffStruct::FieldMap const& GffStruct::GetFields() const
+{
+    DecodeIfLazy();
+    return m_Node->m_Fields;
+}
 
-    header->m_LabelOffset = header->m_FieldOffset + (header->m_FieldCount * sizeof(Raw::GffField));
-    header->m_LabelCount = static_cast<std::uint32_t>(m_RawGff->m_Labels.size());
+bool GffStruct::ReadField(GffFieldLabel const& fieldName, std::string_view* out) const
+{
+    ASSERT(out);
+    DecodeIfLazy();
 
-    header->m_FieldDataOffset = header->m_LabelOffset + (header->m_LabelCount * sizeof(Raw::GffLabel));
-    header->m_FieldDataCount = static_cast<std::uint32_t>(m_RawGff->m_FieldData.size());
+    auto entry = FindField(fieldName);
+    if (entry == std::end(m_Node->m_Fields) || entry->first != fieldName)
+    {
+        return false;
+    }
 
-    header->m_FieldIndicesOffset = header->m_FieldDataOffset + header->m_FieldDataCount;
-    header->m_FieldIndicesCount = static_cast<std::uint32_t>(m_RawGff->m_FieldIndices.size()) * 4;
+    if (Type_CExoString const* string = entry->second.Get<Type_CExoString>())
+    {
+        *out = string->m_String;
+        return true;
+    }
 
-    header->m_ListIndicesOffset = header->m_FieldIndicesOffset + header->m_FieldIndicesCount;
-    header->m_ListIndicesCount = static_cast<std::uint32_t>(m_RawGff->m_ListIndices.size());
+    if (Type_CResRef const* resref = entry->second.Get<Type_CResRef>())
+    {
+        ASSERT(resref->m_Size <= sizeof(resref->m_String));
+        *out = std::string_view(resref->m_String, resref->m_Size);
+        return true;
+    }
 
-    return std::move(m_RawGff);
+    ASSERT_FAIL_MSG("Failed to extract field name %.16s as a string. The Gff type stored was %u.",
+        entry->first.GetString().data(), static_cast<std::uint32_t>(entry->second.GetType()));
+    return false;
 }
 
-template <typename T>
-Raw::GffField GffCreator::CreateField(const GffStruct& parent,
-    const GffStruct::FieldMap::value_type& kvp)
+bool GffStruct::ReadField(GffFieldLabel const& fieldName, Span<std::byte const>* out) const
 {
-    T data;
-    bool read = parent.ReadField(kvp, &data);
-    ASSERT(read);
+    ASSERT(out);
 
-    std::uint32_t label = CreateLabel(kvp.first);
-    Raw::GffField field = InsertIntoRawGff(data);
-    field.m_LabelIndex = label;
-    field.m_Type = GetTypeFromType(data);
-    return field;
+    Type_VOID const* binary = GetField<Type_VOID>(fieldName);
+    if (!binary)
+    {
+        return false;
+    }
+
+    out->m_Data = binary->m_Data.data();
+    out->m_Count = binary->m_Data.size();
+    return true;
 }
 
-std::uint32_t GffCreator::CreateLabel(const std::string& str)
+bool GffStruct::DeleteField(GffFieldLabel const& fieldName)
 {
-    auto iter = m_LabelCache.find(str);
-    if (iter == std::end(m_LabelCache))
+    MarkModified();
+    auto iter = FindField(fieldName);
+
+    if (iter != std::end(m_Node->m_Fields) && iter->first == fieldName)
     {
-        iter = m_LabelCache.insert(std::make_pair(str, static_cast<std::uint32_t>(m_RawGff->m_Labels.size()))).first;
-        Raw::GffLabel label = {};
-        std::memcpy(&label.m_Label, str.c_str(), strnlen(str.c_str(), 16));
-        m_RawGff->m_Labels.emplace_back(std::move(label));
+        m_Node->m_Fields.erase(iter);
+        return true;
     }
 
-    return iter->second;
+    return false;
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_BYTE& type)
+std::uint32_t GffStruct::GetUserDefinedId() const
 {
-    Raw::GffField field = {};
-    std::memcpy(&field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    return m_Node->m_UserDefinedId;
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_CHAR& type)
+void GffStruct::SetUserDefinedId(std::uint32_t id)
 {
-    Raw::GffField field = {};
-    std::memcpy(&field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    MarkModified();
+    m_Node->m_UserDefinedId = id;
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_WORD& type)
+std::uint64_t GffStruct::GetHash() const
 {
-    Raw::GffField field = {};
-    std::memcpy(&field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    DecodeIfLazy();
+    Node& node = *m_Node;
+    std::uint64_t hash = node.m_Hash.m_Value.load(std::memory_order_relaxed);
+
+    // A struct which happens to hash to NoHash is just hashed again every time.
+    if (hash == Node::CachedHash::NoHash)
+    {
+        hash = HashCombine(HashSeed, node.m_UserDefinedId);
+
+        for (FieldMap::value_type const& kvp : node.m_Fields)
+        {
+            std::string_view label = kvp.first.GetString();
+            hash = HashBytes(hash, label.data(), label.size());
+            hash = HashCombine(hash, kvp.second.GetHash());
+        }
+
+        node.m_Hash.m_Value.store(hash, std::memory_order_relaxed);
+    }
+
+    return hash;
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_SHORT& type)
+void GffStruct::DecodeIfLazy() const
 {
-    Raw::GffField field = {};
-    std::memcpy(&field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    ASSERT(m_Node);
+    Node& node = *m_Node;
+
+    if (!node.m_Decoded)
+    {
+        // Flag the struct first so it is considered decoded while we decode it.
+        node.m_Decoded = true;
+        const_cast<GffStruct*>(this)->ConstructInternal(node.m_Source->m_Structs[node.m_SourceStructIndex], *node.m_Source, &node.m_Source);
+    }
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_DWORD& type)
+void GffStruct::MarkModified()
 {
-    Raw::GffField field = {};
-    std::memcpy(&field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    DecodeIfLazy();
+
+    if (m_Node.use_count() > 1)
+    {
+        // Copying the node copies the fields, but any structs and lists among them stay shared until they are
+        // modified in turn. The copy is assigned into a new node, rather than copy constructed, so that the fields
+        // stay in the same memory resource.
+        std::shared_ptr<Node> node = MakeNode(GetResource());
+        *node = *m_Node;
+        m_Node = std::move(node);
+    }
+
+    m_Node->m_Source.reset();
+    m_Node->m_Hash.m_Value.store(Node::CachedHash::NoHash, std::memory_order_relaxed);
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_INT& type)
+std::pmr::memory_resource* GffStruct::GetResource() const
 {
-    Raw::GffField field = {};
-    std::memcpy(&field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    return m_Node->m_Fields.get_allocator().resource();
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_DWORD64& type)
+std::shared_ptr<GffStruct::Node> GffStruct::MakeNode(std::pmr::memory_resource* resource)
 {
-    Raw::GffField field = {};
-    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_RawGff->m_FieldData.size());
-    m_RawGff->m_FieldData.resize(field.m_DataOrDataOffset + sizeof(type));
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    return std::allocate_shared<Node>(std::pmr::polymorphic_allocator<Node>(resource), resource);
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_INT64& type)
+GffStruct::FieldMap::iterator GffStruct::FindField(GffFieldLabel const& fieldName) const
 {
-    Raw::GffField field = {};
-    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_RawGff->m_FieldData.size());
-    m_RawGff->m_FieldData.resize(field.m_DataOrDataOffset + sizeof(type));
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    FieldMap& fields = m_Node->m_Fields;
+    return std::lower_bound(std::begin(fields), std::end(fields), fieldName,
+        [](FieldMap::value_type const& kvp, GffFieldLabel const& label) { return kvp.first < label; });
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_FLOAT& type)
+template <typename RawGff>
+void GffStruct::ConstructInternal(Raw::GffStruct const& rawStruct, RawGff const& rawGff,
+    std::shared_ptr<Raw::GffView const> const* lazySource, ThreadPool* pool)
 {
-    Raw::GffField field = {};
-    std::memcpy(&field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    FieldMap& fields = m_Node->m_Fields;
+    m_Node->m_UserDefinedId = rawStruct.m_Type;
+
+    // Sometimes NWN (toolset?) produces ill-formed structures - whether a non-root structure with data offset as 0xFFFFFFFF
+    // or an empty struct. This check guards against these cases.
+    if (rawStruct.m_FieldCount && rawStruct.m_DataOrDataOffset != 0xFFFFFFFF)
+    {
+        fields.reserve(std::min<std::size_t>(rawStruct.m_FieldCount, rawGff.m_Fields.size()));
+
+        if (rawStruct.m_FieldCount == 1)
+        {
+            ASSERT(rawStruct.m_DataOrDataOffset < rawGff.m_Fields.size());
+            ConstructField(rawGff.m_Fields[rawStruct.m_DataOrDataOffset], rawGff, lazySource, pool);
+        }
+        else
+        {
+            std::uint32_t offsetIntoFieldIndexArray = rawStruct.m_DataOrDataOffset / sizeof(Raw::GffFieldIndex);
+            ASSERT(offsetIntoFieldIndexArray < rawGff.m_FieldIndices.size());
+
+            for (std::size_t i = 0; i < rawStruct.m_FieldCount; ++i)
+            {
+                std::uint32_t offsetIntoFieldArray = rawGff.m_FieldIndices[offsetIntoFieldIndexArray + i];
+                ASSERT(offsetIntoFieldArray < rawGff.m_Fields.size());
+                ConstructField(rawGff.m_Fields[offsetIntoFieldArray], rawGff, lazySource, pool);
+            }
+        }
+
+        // Fields are appended in file order, so sort them once here rather than on every insertion.
+        std::sort(std::begin(fields), std::end(fields),
+            [](FieldMap::value_type const& lhs, FieldMap::value_type const& rhs) { return lhs.first < rhs.first; });
+
+        ASSERT(std::adjacent_find(std::begin(fields), std::end(fields),
+            [](FieldMap::value_type const& lhs, FieldMap::value_type const& rhs) { return lhs.first == rhs.first; })
+                == std::end(fields));
+    }
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_DOUBLE& type)
+template <typename RawGff>
+void GffStruct::ConstructField(Raw::GffField const& rawField, RawGff const& rawGff,
+    std::shared_ptr<Raw::GffView const> const* lazySource, ThreadPool* pool)
 {
-    Raw::GffField field = {};
-    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_RawGff->m_FieldData.size());
-    m_RawGff->m_FieldData.resize(field.m_DataOrDataOffset + sizeof(type));
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset, &type, sizeof(type));
-    return field;
+    GffFieldLabel label = rawGff.m_Labels[rawField.m_LabelIndex];
+    FieldMap& fields = m_Node->m_Fields;
+
+    switch (rawField.m_Type)
+    {
+        case Raw::GffField::Type::BYTE:          fields.emplace_back(label, GffFieldValue(rawGff.ConstructBYTE(rawField))); break;
+        case Raw::GffField::Type::CHAR:          fields.emplace_back(label, GffFieldValue(rawGff.ConstructCHAR(rawField))); break;
+        case Raw::GffField::Type::WORD:          fields.emplace_back(label, GffFieldValue(rawGff.ConstructWORD(rawField))); break;
+        case Raw::GffField::Type::SHORT:         fields.emplace_back(label, GffFieldValue(rawGff.ConstructSHORT(rawField))); break;
+        case Raw::GffField::Type::DWORD:         fields.emplace_back(label, GffFieldValue(rawGff.ConstructDWORD(rawField))); break;
+        case Raw::GffField::Type::INT:           fields.emplace_back(label, GffFieldValue(rawGff.ConstructINT(rawField))); break;
+        case Raw::GffField::Type::DWORD64:       fields.emplace_back(label, GffFieldValue(rawGff.ConstructDWORD64(rawField))); break;
+        case Raw::GffField::Type::INT64:         fields.emplace_back(label, GffFieldValue(rawGff.ConstructINT64(rawField))); break;
+        case Raw::GffField::Type::FLOAT:         fields.emplace_back(label, GffFieldValue(rawGff.ConstructFLOAT(rawField))); break;
+        case Raw::GffField::Type::DOUBLE:        fields.emplace_back(label, GffFieldValue(rawGff.ConstructDOUBLE(rawField))); break;
+        case Raw::GffField::Type::CExoString:    fields.emplace_back(label, GffFieldValue(rawGff.ConstructCExoString(rawField))); break;
+        case Raw::GffField::Type::ResRef:        fields.emplace_back(label, GffFieldValue(rawGff.ConstructResRef(rawField))); break;
+        case Raw::GffField::Type::CExoLocString: fields.emplace_back(label, GffFieldValue(rawGff.ConstructCExoLocString(rawField))); break;
+        case Raw::GffField::Type::VOID:          fields.emplace_back(label, GffFieldValue(rawGff.ConstructVOID(rawField))); break;
+        case Raw::GffField::Type::Struct:
+            fields.emplace_back(label, GffFieldValue(lazySource
+                ? GffStruct(*lazySource, rawField.m_DataOrDataOffset, GetResource())
+                : GffStruct(rawField, rawGff, pool, GetResource())));
+            break;
+
+        case Raw::GffField::Type::List:
+            fields.emplace_back(label, GffFieldValue(lazySource
+                ? GffList(rawField, *lazySource, GetResource())
+                : GffList(rawField, rawGff, pool, GetResource())));
+            break;
+
+        default: ASSERT_FAIL_MSG("Unrecognised GFF field type: %d", rawField.m_Type); break;
+    }
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_CExoString& type)
+GffList::GffList() : m_Node(MakeNode(std::pmr::get_default_resource()))
+{ }
+
+GffList::GffList(std::pmr::memory_resource* resource) : m_Node(MakeNode(resource))
+{ }
+
+GffList::GffList(GffList const& rhs) : m_Node(rhs.m_Node)
 {
-    Raw::GffField field = {};
-    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_RawGff->m_FieldData.size());
+    if (m_Node && m_Node->m_Unshareable)
+    {
+        // As in GetStructs, assigned so that the elements stay in the same memory resource. Nothing has handed out a
+        // reference into the new node yet.
+        std::shared_ptr<Node> node = MakeNode(GetResource());
+        *node = *m_Node;
+        node->m_Unshareable = false;
+        m_Node = std::move(node);
+    }
+}
 
-    std::uint32_t stringSize = static_cast<std::uint32_t>(type.m_String.size());
-    const char* string = type.m_String.c_str();
-    m_RawGff->m_FieldData.resize(field.m_DataOrDataOffset + sizeof(stringSize) + stringSize);
+GffList& GffList::operator=(GffList const& rhs)
+{
+    if (this != &rhs)
+    {
+        *this = GffList(rhs);
+    }
 
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset, &stringSize, sizeof(stringSize));
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset + sizeof(stringSize), string, stringSize);
+    return *this;
+}
 
-    return field;
+GffList::GffList(Raw::GffField const& rawField, Raw::Gff const& rawGff, ThreadPool* pool, std::pmr::memory_resource* resource)
+    : m_Node(MakeNode(resource))
+{
+    ConstructInternal(rawField, rawGff, pool);
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_CResRef& type)
+GffList::GffList(Raw::GffField const& rawField, Raw::GffView const& rawGff, ThreadPool* pool, std::pmr::memory_resource* resource)
+    : m_Node(MakeNode(resource))
 {
-    Raw::GffField field = {};
-    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_RawGff->m_FieldData.size());
-    m_RawGff->m_FieldData.resize(field.m_DataOrDataOffset + sizeof(type.m_Size) + type.m_Size);
+    ConstructInternal(rawField, rawGff, pool);
+}
 
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset, &type.m_Size, sizeof(type.m_Size));
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset + sizeof(type.m_Size), &type.m_String, type.m_Size);
+GffList::GffList(Raw::GffField const& rawField, std::shared_ptr<Raw::GffView const> rawGff,
+    std::pmr::memory_resource* resource) : m_Node(MakeNode(resource))
+{
+    ASSERT(rawGff);
+    ASSERT(rawField.m_Type == Raw::GffField::Type::List);
 
-    return field;
+    m_Node->m_Source = std::move(rawGff);
+    m_Node->m_SourceField = rawField;
+    m_Node->m_Materialised = false;
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_CExoLocString& type)
+void GffList::MaterialiseIfLazy() const
 {
-    Raw::GffField field = {};
-    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_RawGff->m_FieldData.size());
-
-    m_RawGff->m_FieldData.resize(field.m_DataOrDataOffset + sizeof(type.m_TotalSize) + type.m_TotalSize);
+    ASSERT(m_Node);
+    Node& node = *m_Node;
 
-    std::byte* ptr = m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset;
-    std::byte* ptrEnd = ptr + sizeof(type.m_TotalSize) + type.m_TotalSize;
+    if (!node.m_Materialised)
+    {
+        node.m_Materialised = true;
+        Raw::GffField::Type_List list = node.m_Source->ConstructList(node.m_SourceField);
+        node.m_Structs.reserve(list.m_Elements.size());
 
-    std::memcpy(ptr, &type.m_TotalSize, sizeof(type.m_TotalSize));
-    ptr += sizeof(type.m_TotalSize);
+        for (std::uint32_t offsetIntoStructArray : list.m_Elements)
+        {
+            node.m_Structs.emplace_back(node.m_Source, offsetIntoStructArray, GetResource());
+        }
+    }
+}
 
-    std::memcpy(ptr, &type.m_StringRef, sizeof(type.m_StringRef));
-    ptr += sizeof(type.m_StringRef);
+template <typename RawGff>
+void GffList::ConstructInternal(Raw::GffField const& rawField, RawGff const& rawGff, ThreadPool* pool)
+{
+    ASSERT(rawField.m_Type == Raw::GffField::Type::List);
 
-    std::uint32_t stringCount = static_cast<std::uint32_t>(type.m_SubStrings.size());
-    std::memcpy(ptr, &stringCount, sizeof(stringCount));
-    ptr += sizeof(stringCount);
+    Raw::GffField::Type_List list = rawGff.ConstructList(rawField);
+    std::pmr::vector<GffStruct>& structs = m_Node->m_Structs;
 
-    for (std::uint32_t i = 0; i < stringCount; ++i)
+    if (pool && pool->GetThreadCount() && list.m_Elements.size() >= ParallelDecodeMinElements)
     {
-        const Raw::GffField::Type_CExoLocString::SubString& substring = type.m_SubStrings[i];
+        // Every element gets an empty struct up front, then each range decodes into its own elements in place.
+        // Small ranges balance better across threads, since elements with nested lists cost far more than others.
+        constexpr std::size_t GrainSize = 32;
+        structs.reserve(list.m_Elements.size());
 
-        std::memcpy(ptr, &substring.m_StringID, sizeof(substring.m_StringID));
-        ptr += sizeof(substring.m_StringID);
+        for (std::size_t i = 0; i < list.m_Elements.size(); ++i)
+        {
+            structs.emplace_back(GetResource());
+        }
 
-        std::uint32_t substringLength = static_cast<std::uint32_t>(substring.m_String.size());
-        std::memcpy(ptr, &substringLength, sizeof(substringLength));
-        ptr += sizeof(substringLength);
+        pool->ParallelFor(structs.size(), GrainSize, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                std::uint32_t offsetIntoStructArray = list.m_Elements[i];
+                ASSERT(offsetIntoStructArray < rawGff.m_Structs.size());
+                structs[i].ConstructInternal(rawGff.m_Structs[offsetIntoStructArray], rawGff, nullptr, pool);
+            }
+        });
 
-        std::memcpy(ptr, substring.m_String.c_str(), substringLength);
-        ptr += substringLength;
+        return;
     }
 
-    ASSERT(ptr == ptrEnd);
+    structs.reserve(list.m_Elements.size());
 
-    return field;
+    for (std::uint32_t offsetIntoStructArray : list.m_Elements)
+    {
+        ASSERT(offsetIntoStructArray < rawGff.m_Structs.size());
+        structs.emplace_back(rawGff.m_Structs[offsetIntoStructArray], rawGff, pool, GetResource());
+    }
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_VOID& type)
+std::pmr::vector<GffStruct>& GffList::GetStructs()
 {
-    Raw::GffField field = {};
-    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_RawGff->m_FieldData.size());
+    MaterialiseIfLazy();
 
-    std::uint32_t size = static_cast<std::uint32_t>(type.m_Data.size());
-    m_RawGff->m_FieldData.resize(field.m_DataOrDataOffset + sizeof(size) + size);
+    if (m_Node.use_count() > 1)
+    {
+        // As for GffStruct::MarkModified, assigned so that the elements stay in the same memory resource.
+        std::shared_ptr<Node> node = MakeNode(GetResource());
+        *node = *m_Node;
+        m_Node = std::move(node);
+    }
 
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset, &size, sizeof(size));
-    std::memcpy(m_RawGff->m_FieldData.data() + field.m_DataOrDataOffset + sizeof(size), type.m_Data.data(), size);
+    m_Node->m_Source.reset();
+    m_Node->m_Unshareable = true;
+    return m_Node->m_Structs;
+}
 
-    return field;
+std::pmr::vector<GffStruct> const& GffList::GetStructs() const
+{
+    MaterialiseIfLazy();
+    return m_Node->m_Structs;
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_Struct& type)
+std::pmr::memory_resource* GffList::GetResource() const
 {
-    std::size_t baseFieldIndex = m_RawGff->m_Fields.size();
-    std::size_t newFields = type.GetFields().size();
-    m_RawGff->m_Fields.resize(baseFieldIndex + newFields);
+    return m_Node->m_Structs.get_allocator().resource();
+}
 
-    std::uint32_t structIndex = static_cast<std::uint32_t>(m_RawGff->m_Structs.size());
-    m_RawGff->m_Structs.resize(structIndex + 1);
+std::shared_ptr<GffList::Node> GffList::MakeNode(std::pmr::memory_resource* resource)
+{
+    return std::allocate_shared<Node>(std::pmr::polymorphic_allocator<Node>(resource), resource);
+}
 
-    Raw::GffStruct rawStruct;
-    rawStruct.m_Type = type.GetUserDefinedId();
-    rawStruct.m_FieldCount = static_cast<std::uint32_t>(newFields);
+std::uint64_t GffList::GetHash() const
+{
+    std::pmr::vector<GffStruct> const& structs = GetStructs();
+    std::uint64_t hash = HashCombine(HashSeed, structs.size());
 
-    if (rawStruct.m_FieldCount > 1)
+    for (GffStruct const& element : structs)
     {
-        std::size_t baseFieldIndicesIndex = m_RawGff->m_FieldIndices.size();
-        rawStruct.m_DataOrDataOffset = static_cast<std::uint32_t>(baseFieldIndicesIndex * sizeof(m_RawGff->m_FieldIndices[0]));
-        m_RawGff->m_FieldIndices.resize(baseFieldIndicesIndex + rawStruct.m_FieldCount);
-
-        for (std::size_t i = baseFieldIndex, index = baseFieldIndicesIndex;
-            index < baseFieldIndicesIndex + rawStruct.m_FieldCount;
-            ++i, ++index)
-        {
-            m_RawGff->m_FieldIndices[index] = static_cast<std::uint32_t>(i);
-        }
+        hash = HashCombine(hash, element.GetHash());
     }
-    else
-    {
-        // Point directly to the head of the field array.
-        // In the case of no fields, this will wrap around to be 0xFFFFFFFF, which is expected.
-        rawStruct.m_DataOrDataOffset = static_cast<std::uint32_t>(baseFieldIndex);
-    }
-
-    m_RawGff->m_Structs[structIndex] = std::move(rawStruct);
-
-    std::size_t fieldProcessing = 0;
-    for (auto& kvp : type.GetFields())
-    {
-        Raw::GffField::Type fieldType = kvp.second.first;
-        Raw::GffField field;
-
-        switch (kvp.second.first)
-        {
-            case Raw::GffField::Type::BYTE:          field = CreateField<Type_BYTE>(type, kvp); break;
-            case Raw::GffField::Type::CHAR:          field = CreateField<Type_CHAR>(type, kvp); break;
-            case Raw::GffField::Type::WORD:          field = CreateField<Type_WORD>(type, kvp); break;
-            case Raw::GffField::Type::SHORT:         field = CreateField<Type_SHORT>(type, kvp); break;
-            case Raw::GffField::Type::DWORD:         field = CreateField<Type_DWORD>(type, kvp); break;
-            case Raw::GffField::Type::INT:           field = CreateField<Type_INT>(type, kvp); break;
-            case Raw::GffField::Type::DWORD64:       field = CreateField<Type_DWORD64>(type, kvp); break;
-            case Raw::GffField::Type::INT64:         field = CreateField<Type_INT64>(type, kvp); break;
-            case Raw::GffField::Type::FLOAT:         field = CreateField<Type_FLOAT>(type, kvp); break;
-            case Raw::GffField::Type::DOUBLE:        field = CreateField<Type_DOUBLE>(type, kvp); break;
-            case Raw::GffField::Type::CExoString:    field = CreateField<Type_CExoString>(type, kvp); break;
-            case Raw::GffField::Type::ResRef:        field = CreateField<Type_CResRef>(type, kvp); break;
-            case Raw::GffField::Type::CExoLocString: field = CreateField<Type_CExoLocString>(type, kvp); break;
-            case Raw::GffField::Type::VOID:          field = CreateField<Type_VOID>(type, kvp); break;
-            case Raw::GffField::Type::Struct:        field = CreateField<Type_Struct>(type, kvp); break;
-            case Raw::GffField::Type::List:          field = CreateField<Type_List>(type, kvp); break;
-            default: ASSERT_FAIL_MSG("Unrecognised GFF field type: %d", fieldType); break;
-        }
 
-        m_RawGff->m_Fields[baseFieldIndex + fieldProcessing++] = field;
-    }
+    return hash;
+}
 
-    Raw::GffField field = {};
-    field.m_DataOrDataOffset = structIndex;
-    return field;
+Gff::Gff() : m_TopLevelStruct()
+{
+    SetFileType("UTC ");
 }
 
-Raw::GffField GffCreator::InsertIntoRawGff(const Type_List& type)
+Gff::Gff(Raw::Gff const& rawGff, ThreadPool* pool, std::pmr::memory_resource* resource)
+    : m_TopLevelStruct(rawGff.m_Structs[0], rawGff, pool, resource)
 {
-    Raw::GffField field = {};
+    std::memcpy(m_FileType, rawGff.m_Header.m_FileType, sizeof(m_FileType));
+}
 
-    std::vector<std::uint32_t> structsInserted;
+Gff::Gff(Raw::GffView const& rawGff, ThreadPool* pool, std::pmr::memory_resource* resource)
+    : m_TopLevelStruct(rawGff.m_Structs[0], rawGff, pool, resource)
+{
+    std::memcpy(m_FileType, rawGff.m_Header.m_FileType, sizeof(m_FileType));
+}
 
-    for (const GffStruct& friendlyStruct : type.GetStructs())
-    {
-        std::uint32_t structIndex = static_cast<std::uint32_t>(m_RawGff->m_Structs.size());
-        structsInserted.emplace_back(structIndex);
-        InsertIntoRawGff(friendlyStruct);
-    }
+Gff::Gff(std::shared_ptr<Raw::GffView const> rawGff, std::pmr::memory_resource* resource)
+    : m_TopLevelStruct(rawGff, 0, resource)
+{
+    std::memcpy(m_FileType, rawGff->m_Header.m_FileType, sizeof(m_FileType));
+}
+
+Gff Gff::Lazy(Raw::GffView&& rawGff, std::pmr::memory_resource* resource)
+{
+    return Gff(std::make_shared<Raw::GffView const>(std::move(rawGff)), resource);
+}
 
-    field.m_DataOrDataOffset = static_cast<std::uint32_t>(m_RawGff->m_ListIndices.size());
+GffStruct& Gff::GetTopLevelStruct()
+{
+    return m_TopLevelStruct;
+}
 
-    std::uint32_t structsInsertedCount = static_cast<std::uint32_t>(structsInserted.size());
-    std::uint32_t sizeByteCount = sizeof(structsInsertedCount);
-    std::uint32_t indicesByteCount = structsInsertedCount * sizeof(structsInserted[0]);
-    m_RawGff->m_ListIndices.resize(field.m_DataOrDataOffset + sizeByteCount + indicesByteCount);
+GffStruct const& Gff::GetTopLevelStruct() const
+{
+    return m_TopLevelStruct;
+}
 
-    std::byte* ptr = m_RawGff->m_ListIndices.data() + field.m_DataOrDataOffset;
+std::string_view Gff::GetFileType() const
+{
+    return std::string_view(m_FileType, sizeof(m_FileType));
+}
 
-    std::memcpy(ptr, &structsInsertedCount, sizeByteCount);
-    ptr += sizeByteCount;
+void Gff::SetFileType(char const* fileType)
+{
+    ASSERT(fileType && std::strlen(fileType) == sizeof(m_FileType));
+    std::memcpy(m_FileType, fileType, sizeof(m_FileType));
+}
 
-    std::memcpy(ptr, structsInserted.data(), indicesByteCount);
+bool Gff::WriteToFile(char const* path) const
+{
+    return GffWriter().WriteToFile(*this, path);
+}
 
-    return field;
+bool Gff::WriteToBytes(std::vector<std::byte>* out) const
+{
+    return GffWriter().WriteToBytes(*this, out);
 }
 
+namespace {
+
+constexpr std::uint32_t EmptySlot = 0xFFFFFFFF;
+
+// Returns the size of the CExoLocString as written to the field data, not including the leading size DWORD.
+std::uint32_t CalculateLocStringSize(Type_CExoLocString const& locString)
+{
+    std::size_t size = sizeof(locString.m_StringRef) + sizeof(std::uint32_t);
+
+    for (Type_CExoLocString::SubString const& substring : locString.m_SubStrings)
+    {
+        size += sizeof(substring.m_StringID) + sizeof(std::uint32_t) + substring.m_String.size();
+    }
 
+    ASSERT_MSG(size == locString.m_TotalSize, "CExoLocString total size is %u, but the substrings add up to %zu.",
+        locString.m_TotalSize, size);
+
+    return static_cast<std::uint32_t>(size);
+}
+
+template <typename T>
+void WriteAt(std::byte* section, std::size_t offset, T const& value)
+{
+    std::memcpy(section + offset, &value, sizeof(value));
+}
+
+bool IsVariableSize(Raw::GffField::Type type)
+{
+    return type == Raw::GffField::Type::CExoString || type == Raw::GffField::Type::ResRef ||
+        type == Raw::GffField::Type::CExoLocString || type == Raw::GffField::Type::VOID;
+}
+
+// Appends the field data of a variable size value, exactly as GffWriter::WriteField writes it.
+void EncodeFieldData(GffFieldValue const& value, std::vector<std::byte>* out)
+{
+    auto append = [out](void const* data, std::size_t length)
+    {
+        std::byte const* bytes = static_cast<std::byte const*>(data);
+        out->insert(std::end(*out), bytes, bytes + length);
+    };
+
+    switch (value.GetType())
+    {
+        case Raw::GffField::Type::CExoString:
+        {
+            Type_CExoString const& string = *value.Get<Type_CExoString>();
+            std::uint32_t stringSize = static_cast<std::uint32_t>(string.m_String.size());
+            append(&stringSize, sizeof(stringSize));
+            append(string.m_String.data(), stringSize);
+            break;
+        }
+
+        case Raw::GffField::Type::ResRef:
+        {
+            Type_CResRef const& resref = *value.Get<Type_CResRef>();
+            ASSERT(resref.m_Size <= sizeof(resref.m_String));
+            append(&resref.m_Size, sizeof(resref.m_Size));
+            append(resref.m_String, resref.m_Size);
+            break;
+        }
+
+        case Raw::GffField::Type::CExoLocString:
+        {
+            Type_CExoLocString const& locString = *value.Get<Type_CExoLocString>();
+            std::uint32_t totalSize = CalculateLocStringSize(locString);
+            std::uint32_t stringCount = static_cast<std::uint32_t>(locString.m_SubStrings.size());
+
+            append(&totalSize, sizeof(totalSize));
+            append(&locString.m_StringRef, sizeof(locString.m_StringRef));
+            append(&stringCount, sizeof(stringCount));
+
+            for (Type_CExoLocString::SubString const& substring : locString.m_SubStrings)
+            {
+                std::uint32_t substringLength = static_cast<std::uint32_t>(substring.m_String.size());
+                append(&substring.m_StringID, sizeof(substring.m_StringID));
+                append(&substringLength, sizeof(substringLength));
+                append(substring.m_String.data(), substringLength);
+            }
+
+            break;
+        }
+
+        case Raw::GffField::Type::VOID:
+        {
+            Type_VOID const& binary = *value.Get<Type_VOID>();
+            std::uint32_t size = static_cast<std::uint32_t>(binary.m_Data.size());
+            append(&size, sizeof(size));
+            append(binary.m_Data.data(), size);
+            break;
+        }
+
+        default: ASSERT_FAIL_MSG("Field type %u is not variable size.", static_cast<std::uint32_t>(value.GetType())); break;
+    }
+}
+
+// Returns the number of fields in the raw struct. Ill-formed structs (see GffStruct::ConstructInternal) have none.
+std::uint32_t GetSourceFieldCount(Raw::GffStruct const& sourceStruct)
+{
+    return sourceStruct.m_DataOrDataOffset != 0xFFFFFFFF ? sourceStruct.m_FieldCount : 0;
+}
+
+template <typename Callback>
+void ForEachSourceField(Raw::GffView const& source, Raw::GffStruct const& sourceStruct, Callback&& callback)
+{
+    std::uint32_t fieldCount = GetSourceFieldCount(sourceStruct);
+
+    if (fieldCount == 1)
+    {
+        ASSERT(sourceStruct.m_DataOrDataOffset < source.m_Fields.size());
+        callback(source.m_Fields[sourceStruct.m_DataOrDataOffset]);
+    }
+    else if (fieldCount > 1)
+    {
+        std::uint32_t offsetIntoFieldIndexArray = sourceStruct.m_DataOrDataOffset / sizeof(Raw::GffFieldIndex);
+        ASSERT(offsetIntoFieldIndexArray + fieldCount <= source.m_FieldIndices.size());
+
+        for (std::uint32_t i = 0; i < fieldCount; ++i)
+        {
+            std::uint32_t offsetIntoFieldArray = source.m_FieldIndices[offsetIntoFieldIndexArray + i];
+            ASSERT(offsetIntoFieldArray < source.m_Fields.size());
+            callback(source.m_Fields[offsetIntoFieldArray]);
+        }
+    }
+}
+
+template <typename Callback>
+void ForEachSourceListElement(Raw::GffView const& source, Raw::GffField const& listField, Callback&& callback)
+{
+    std::uint32_t offsetIntoListIndices = listField.m_DataOrDataOffset;
+    ASSERT(offsetIntoListIndices + sizeof(std::uint32_t) <= source.m_ListIndices.size());
+
+    std::byte const* ptr = source.m_ListIndices.data() + offsetIntoListIndices;
+    std::uint32_t elementCount;
+    std::memcpy(&elementCount, ptr, sizeof(elementCount));
+    ASSERT(offsetIntoListIndices + (elementCount + 1) * sizeof(std::uint32_t) <= source.m_ListIndices.size());
+
+    for (std::uint32_t i = 0; i < elementCount; ++i)
+    {
+        std::uint32_t offsetIntoStructArray;
+        std::memcpy(&offsetIntoStructArray, ptr + (i + 1) * sizeof(std::uint32_t), sizeof(offsetIntoStructArray));
+        callback(offsetIntoStructArray);
+    }
+}
+
+// Returns the number of bytes the field occupies in the field data block.
+std::uint32_t GetSourceFieldDataSize(Raw::GffView const& source, Raw::GffField const& sourceField)
+{
+    std::uint32_t offsetIntoFieldDataArray = sourceField.m_DataOrDataOffset;
+    std::uint32_t size = 0;
+
+    switch (sourceField.m_Type)
+    {
+        case Raw::GffField::Type::DWORD64:
+        case Raw::GffField::Type::INT64:
+        case Raw::GffField::Type::DOUBLE:
+            size = sizeof(std::uint64_t);
+            break;
+
+        case Raw::GffField::Type::CExoString:
+        case Raw::GffField::Type::CExoLocString:
+        case Raw::GffField::Type::VOID:
+        {
+            // Each of these begins with its size, not including the size itself.
+            ASSERT(offsetIntoFieldDataArray + sizeof(std::uint32_t) <= source.m_FieldData.size());
+            std::memcpy(&size, source.m_FieldData.data() + offsetIntoFieldDataArray, sizeof(size));
+            size += sizeof(std::uint32_t);
+            break;
+        }
+
+        case Raw::GffField::Type::ResRef:
+        {
+            ASSERT(offsetIntoFieldDataArray < source.m_FieldData.size());
+            size = std::to_integer<std::uint32_t>(source.m_FieldData[offsetIntoFieldDataArray]) + sizeof(std::uint8_t);
+            break;
+        }
+
+        default:
+            return 0;
+    }
+
+    ASSERT(offsetIntoFieldDataArray + size <= source.m_FieldData.size());
+    return size;
+}
+
+}
+
+GffWriter::GffWriter(Mode mode) : m_Mode(mode)
+{ }
+
+std::size_t GffWriter::Measure(Gff const& gff)
+{
+    m_TopLevelStruct = &gff.GetTopLevelStruct();
+
+    m_Labels.Clear();
+    m_RemapSource = nullptr;
+
+    m_FieldDataPool.Clear();
+    m_PooledFieldData.clear();
+
+    m_StructCount = 0;
+    m_FieldCount = 0;
+    m_FieldIndicesCount = 0;
+    m_FieldDataSize = 0;
+    m_ListIndicesSize = 0;
+
+    MeasureStruct(*m_TopLevelStruct);
+
+    m_Header = {};
+    std::memcpy(m_Header.m_FileType, gff.GetFileType().data(), sizeof(m_Header.m_FileType));
+    std::memcpy(m_Header.m_FileVersion, "V3.2", 4);
+
+    m_Header.m_StructOffset = sizeof(Raw::GffHeader);
+    m_Header.m_StructCount = m_StructCount;
+
+    m_Header.m_FieldOffset = m_Header.m_StructOffset + (m_Header.m_StructCount * sizeof(Raw::GffStruct));
+    m_Header.m_FieldCount = m_FieldCount;
+
+    m_Header.m_LabelOffset = m_Header.m_FieldOffset + (m_Header.m_FieldCount * sizeof(Raw::GffField));
+    m_Header.m_LabelCount = static_cast<std::uint32_t>(m_Labels.GetLabels().size());
+
+    m_Header.m_FieldDataOffset = m_Header.m_LabelOffset + (m_Header.m_LabelCount * sizeof(Raw::GffLabel));
+    m_Header.m_FieldDataCount = m_FieldDataSize;
+
+    m_Header.m_FieldIndicesOffset = m_Header.m_FieldDataOffset + m_Header.m_FieldDataCount;
+    m_Header.m_FieldIndicesCount = m_FieldIndicesCount * sizeof(Raw::GffFieldIndex);
+
+    m_Header.m_ListIndicesOffset = m_Header.m_FieldIndicesOffset + m_Header.m_FieldIndicesCount;
+    m_Header.m_ListIndicesCount = m_ListIndicesSize;
+
+    return m_Header.m_ListIndicesOffset + m_Header.m_ListIndicesCount;
+}
+
+void GffWriter::Write(std::byte* buffer)
+{
+    ASSERT(buffer);
+    ASSERT(m_TopLevelStruct);
+
+    WriteAt(buffer, 0, m_Header);
+
+    std::vector<GffFieldLabel> const& labels = m_Labels.GetLabels();
+
+    for (std::size_t i = 0; i < labels.size(); ++i)
+    {
+        WriteAt(buffer, m_Header.m_LabelOffset + i * sizeof(Raw::GffLabel), labels[i].ToRawLabel());
+    }
+
+    m_Structs = buffer + m_Header.m_StructOffset;
+    m_Fields = buffer + m_Header.m_FieldOffset;
+    m_FieldData = buffer + m_Header.m_FieldDataOffset;
+    m_FieldIndices = buffer + m_Header.m_FieldIndicesOffset;
+    m_ListIndices = buffer + m_Header.m_ListIndicesOffset;
+
+    m_NextStruct = 0;
+    m_NextField = 0;
+    m_NextFieldIndex = 0;
+    m_NextFieldData = 0;
+    m_NextListIndices = 0;
+    m_NextPooledFieldData = 0;
+
+    WriteStruct(*m_TopLevelStruct);
+
+    ASSERT(m_NextStruct == m_StructCount);
+    ASSERT(m_NextField == m_FieldCount);
+    ASSERT(m_NextFieldIndex == m_FieldIndicesCount);
+    ASSERT(m_NextFieldData == m_FieldDataSize);
+    ASSERT(m_NextListIndices == m_ListIndicesSize);
+    ASSERT(m_NextPooledFieldData == m_PooledFieldData.size());
+}
+
+bool GffWriter::WriteToBytes(Gff const& gff, std::vector<std::byte>* out)
+{
+    ASSERT(out);
+    out->resize(Measure(gff));
+    Write(out->data());
+    return true;
+}
+
+bool GffWriter::WriteToFile(Gff const& gff, char const* path)
+{
+    ASSERT(path);
+    WriteToBytes(gff, &m_Buffer);
+    WriteBuffer buffer = { m_Buffer.data(), m_Buffer.size() };
+
+    // A lazily decoded Gff still reads from the file it was loaded from, which is often the one being saved over.
+    // Truncating that file in place would pull the bytes out from under its mapping.
+    return ReplaceFileWithBuffers(path, &buffer, 1);
+}
+
+void GffWriter::MeasureStruct(GffStruct const& gffStruct)
+{
+    if (m_Mode == Mode::Default && IsUnmodified(gffStruct))
+    {
+        MeasureSourceStruct(*gffStruct.m_Node->m_Source, gffStruct.m_Node->m_SourceStructIndex);
+        return;
+    }
+
+    GffStruct::FieldMap const& fields = gffStruct.GetFields();
+
+    ++m_StructCount;
+    m_FieldCount += static_cast<std::uint32_t>(fields.size());
+
+    if (fields.size() > 1)
+    {
+        m_FieldIndicesCount += static_cast<std::uint32_t>(fields.size());
+    }
+
+    for (GffStruct::FieldMap::value_type const& kvp : fields)
+    {
+        MeasureField(kvp);
+    }
+}
+
+void GffWriter::MeasureField(GffStruct::FieldMap::value_type const& kvp)
+{
+    m_Labels.FindOrAdd(kvp.first);
+
+    GffFieldValue const& value = kvp.second;
+
+    if (m_Mode == Mode::Canonical && IsVariableSize(value.GetType()))
+    {
+        MeasurePooledFieldData(value);
+        return;
+    }
+
+    switch (value.GetType())
+    {
+        case Raw::GffField::Type::DWORD64:
+        case Raw::GffField::Type::INT64:
+        case Raw::GffField::Type::DOUBLE:
+            m_FieldDataSize += sizeof(std::uint64_t);
+            break;
+
+        case Raw::GffField::Type::CExoString:
+            m_FieldDataSize += sizeof(std::uint32_t) + static_cast<std::uint32_t>(value.Get<Type_CExoString>()->m_String.size());
+            break;
+
+        case Raw::GffField::Type::ResRef:
+            ASSERT(value.Get<Type_CResRef>()->m_Size <= sizeof(Type_CResRef::m_String));
+            m_FieldDataSize += sizeof(Type_CResRef::m_Size) + value.Get<Type_CResRef>()->m_Size;
+            break;
+
+        case Raw::GffField::Type::CExoLocString:
+            m_FieldDataSize += sizeof(std::uint32_t) + CalculateLocStringSize(*value.Get<Type_CExoLocString>());
+            break;
+
+        case Raw::GffField::Type::VOID:
+            m_FieldDataSize += sizeof(std::uint32_t) + static_cast<std::uint32_t>(value.Get<Type_VOID>()->m_Data.size());
+            break;
+
+        case Raw::GffField::Type::Struct:
+            MeasureStruct(*value.Get<Type_Struct>());
+            break;
+
+        case Raw::GffField::Type::List:
+        {
+            GffList::Node const& list = *value.Get<Type_List>()->m_Node;
+            std::uint32_t elementCount = 0;
+
+            if (m_Mode == Mode::Default && !list.m_Materialised)
+            {
+                ForEachSourceListElement(*list.m_Source, list.m_SourceField, [&](std::uint32_t structIndex)
+                {
+                    MeasureSourceStruct(*list.m_Source, structIndex);
+                    ++elementCount;
+                });
+            }
+            else
+            {
+                for (GffStruct const& element : value.Get<Type_List>()->GetStructs())
+                {
+                    MeasureStruct(element);
+                    ++elementCount;
+                }
+            }
+
+            m_ListIndicesSize += (elementCount + 1) * sizeof(std::uint32_t);
+            break;
+        }
+
+        default:
+            // Everything else fits in the field itself.
+            break;
+    }
+}
+
+std::uint32_t GffWriter::WriteStruct(GffStruct const& gffStruct)
+{
+    if (m_Mode == Mode::Default && IsUnmodified(gffStruct))
+    {
+        return WriteSourceStruct(*gffStruct.m_Node->m_Source, gffStruct.m_Node->m_SourceStructIndex);
+    }
+
+    GffStruct::FieldMap const& fields = gffStruct.GetFields();
+    std::uint32_t fieldCount = static_cast<std::uint32_t>(fields.size());
+
+    std::uint32_t baseFieldIndex;
+    std::uint32_t structIndex = WriteStructHeader(gffStruct.GetUserDefinedId(), fieldCount, &baseFieldIndex);
+
+    for (std::uint32_t i = 0; i < fieldCount; ++i)
+    {
+        WriteAt(m_Fields, (baseFieldIndex + i) * sizeof(Raw::GffField), WriteField(fields[i]));
+    }
+
+    return structIndex;
+}
+
+Raw::GffField GffWriter::WriteField(GffStruct::FieldMap::value_type const& kvp)
+{
+    GffFieldValue const& value = kvp.second;
+
+    Raw::GffField field = {};
+    field.m_Type = value.GetType();
+    field.m_LabelIndex = m_Labels.FindOrAdd(kvp.first);
+
+    if (m_Mode == Mode::Canonical && IsVariableSize(field.m_Type))
+    {
+        field.m_DataOrDataOffset = WritePooledFieldData();
+        return field;
+    }
+
+    switch (field.m_Type)
+    {
+        case Raw::GffField::Type::BYTE:    std::memcpy(&field.m_DataOrDataOffset, value.Get<Type_BYTE>(), sizeof(Type_BYTE)); break;
+        case Raw::GffField::Type::CHAR:    std::memcpy(&field.m_DataOrDataOffset, value.Get<Type_CHAR>(), sizeof(Type_CHAR)); break;
+        case Raw::GffField::Type::WORD:    std::memcpy(&field.m_DataOrDataOffset, value.Get<Type_WORD>(), sizeof(Type_WORD)); break;
+        case Raw::GffField::Type::SHORT:   std::memcpy(&field.m_DataOrDataOffset, value.Get<Type_SHORT>(), sizeof(Type_SHORT)); break;
+        case Raw::GffField::Type::DWORD:   std::memcpy(&field.m_DataOrDataOffset, value.Get<Type_DWORD>(), sizeof(Type_DWORD)); break;
+        case Raw::GffField::Type::INT:     std::memcpy(&field.m_DataOrDataOffset, value.Get<Type_INT>(), sizeof(Type_INT)); break;
+        case Raw::GffField::Type::FLOAT:   std::memcpy(&field.m_DataOrDataOffset, value.Get<Type_FLOAT>(), sizeof(Type_FLOAT)); break;
+        case Raw::GffField::Type::DWORD64: field.m_DataOrDataOffset = WriteFieldData(value.Get<Type_DWORD64>(), sizeof(Type_DWORD64)); break;
+        case Raw::GffField::Type::INT64:   field.m_DataOrDataOffset = WriteFieldData(value.Get<Type_INT64>(), sizeof(Type_INT64)); break;
+        case Raw::GffField::Type::DOUBLE:  field.m_DataOrDataOffset = WriteFieldData(value.Get<Type_DOUBLE>(), sizeof(Type_DOUBLE)); break;
+
+        case Raw::GffField::Type::CExoString:
+        {
+            Type_CExoString const& string = *value.Get<Type_CExoString>();
+            std::uint32_t stringSize = static_cast<std::uint32_t>(string.m_String.size());
+            field.m_DataOrDataOffset = WriteFieldData(&stringSize, sizeof(stringSize));
+            WriteFieldData(string.m_String.data(), stringSize);
+            break;
+        }
+
+        case Raw::GffField::Type::ResRef:
+        {
+            Type_CResRef const& resref = *value.Get<Type_CResRef>();
+            field.m_DataOrDataOffset = WriteFieldData(&resref.m_Size, sizeof(resref.m_Size));
+            WriteFieldData(resref.m_String, resref.m_Size);
+            break;
+        }
+
+        case Raw::GffField::Type::CExoLocString:
+        {
+            Type_CExoLocString const& locString = *value.Get<Type_CExoLocString>();
+            std::uint32_t totalSize = CalculateLocStringSize(locString);
+            std::uint32_t stringCount = static_cast<std::uint32_t>(locString.m_SubStrings.size());
+
+            field.m_DataOrDataOffset = WriteFieldData(&totalSize, sizeof(totalSize));
+            WriteFieldData(&locString.m_StringRef, sizeof(locString.m_StringRef));
+            WriteFieldData(&stringCount, sizeof(stringCount));
+
+            for (Type_CExoLocString::SubString const& substring : locString.m_SubStrings)
+            {
+                std::uint32_t substringLength = static_cast<std::uint32_t>(substring.m_String.size());
+                WriteFieldData(&substring.m_StringID, sizeof(substring.m_StringID));
+                WriteFieldData(&substringLength, sizeof(substringLength));
+                WriteFieldData(substring.m_String.data(), substringLength);
+            }
+
+            break;
+        }
+
+        case Raw::GffField::Type::VOID:
+        {
+            Type_VOID const& binary = *value.Get<Type_VOID>();
+            std::uint32_t size = static_cast<std::uint32_t>(binary.m_Data.size());
+            field.m_DataOrDataOffset = WriteFieldData(&size, sizeof(size));
+            WriteFieldData(binary.m_Data.data(), size);
+            break;
+        }
+
+        case Raw::GffField::Type::Struct:
+            field.m_DataOrDataOffset = WriteStruct(*value.Get<Type_Struct>());
+            break;
+
+        case Raw::GffField::Type::List:
+        {
+            // Elements are written before the list itself, so collect their indices on the scratch stack.
+            GffList::Node const& list = *value.Get<Type_List>()->m_Node;
+            std::size_t scratchBase = m_ListScratch.size();
+
+            if (m_Mode == Mode::Default && !list.m_Materialised)
+            {
+                ForEachSourceListElement(*list.m_Source, list.m_SourceField, [&](std::uint32_t sourceStructIndex)
+                {
+                    std::uint32_t elementIndex = WriteSourceStruct(*list.m_Source, sourceStructIndex);
+                    m_ListScratch.emplace_back(elementIndex);
+                });
+            }
+            else
+            {
+                for (GffStruct const& element : value.Get<Type_List>()->GetStructs())
+                {
+                    std::uint32_t elementIndex = WriteStruct(element);
+                    m_ListScratch.emplace_back(elementIndex);
+                }
+            }
+
+            field.m_DataOrDataOffset = WriteListIndices(scratchBase);
+            break;
+        }
+
+        default: ASSERT_FAIL_MSG("Unrecognised GFF field type: %d", field.m_Type); break;
+    }
+
+    return field;
+}
+
+std::uint32_t GffWriter::WriteFieldData(void const* data, std::size_t length)
+{
+    std::uint32_t offset = m_NextFieldData;
+    std::memcpy(m_FieldData + offset, data, length);
+    m_NextFieldData += static_cast<std::uint32_t>(length);
+    return offset;
+}
+
+std::uint32_t GffWriter::WriteStructHeader(std::uint32_t id, std::uint32_t fieldCount, std::uint32_t* baseFieldIndex)
+{
+    // The struct and its fields claim their slots before any of their children, so they are written in the same
+    // order as they are measured.
+    std::uint32_t structIndex = m_NextStruct++;
+    *baseFieldIndex = m_NextField;
+    m_NextField += fieldCount;
+
+    Raw::GffStruct rawStruct;
+    rawStruct.m_Type = id;
+    rawStruct.m_FieldCount = fieldCount;
+
+    if (fieldCount > 1)
+    {
+        rawStruct.m_DataOrDataOffset = m_NextFieldIndex * sizeof(Raw::GffFieldIndex);
+
+        for (std::uint32_t i = 0; i < fieldCount; ++i)
+        {
+            WriteAt(m_FieldIndices, (m_NextFieldIndex + i) * sizeof(Raw::GffFieldIndex), Raw::GffFieldIndex(*baseFieldIndex + i));
+        }
+
+        m_NextFieldIndex += fieldCount;
+    }
+    else
+    {
+        // Point directly to the head of the field array.
+        rawStruct.m_DataOrDataOffset = *baseFieldIndex;
+    }
+
+    WriteAt(m_Structs, structIndex * sizeof(Raw::GffStruct), rawStruct);
+    return structIndex;
+}
+
+std::uint32_t GffWriter::WriteListIndices(std::size_t scratchBase)
+{
+    std::uint32_t elementCount = static_cast<std::uint32_t>(m_ListScratch.size() - scratchBase);
+    std::uint32_t offset = m_NextListIndices;
+
+    WriteAt(m_ListIndices, offset, elementCount);
+    std::memcpy(m_ListIndices + offset + sizeof(elementCount), m_ListScratch.data() + scratchBase, elementCount * sizeof(std::uint32_t));
+    m_NextListIndices += (elementCount + 1) * sizeof(std::uint32_t);
+
+    m_ListScratch.resize(scratchBase);
+    return offset;
+}
+
+bool GffWriter::IsUnmodified(GffStruct const& gffStruct)
+{
+    GffStruct::Node const& node = *gffStruct.m_Node;
+
+    if (!node.m_Source)
+    {
+        return false;
+    }
+
+    if (!node.m_Decoded)
+    {
+        return true;
+    }
+
+    // Having been decoded doesn't make the struct any different from the source - but it does mean that its
+    // children may have been modified.
+    for (GffStruct::FieldMap::value_type const& kvp : node.m_Fields)
+    {
+        GffFieldValue const& value = kvp.second;
+
+        if ((value.GetType() == Raw::GffField::Type::Struct && !IsUnmodified(*value.Get<Type_Struct>())) ||
+            (value.GetType() == Raw::GffField::Type::List && !IsUnmodified(*value.Get<Type_List>())))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool GffWriter::IsUnmodified(GffList const& gffList)
+{
+    GffList::Node const& node = *gffList.m_Node;
+
+    if (!node.m_Source)
+    {
+        return false;
+    }
+
+    if (!node.m_Materialised)
+    {
+        return true;
+    }
+
+    return std::all_of(std::begin(node.m_Structs), std::end(node.m_Structs),
+        [](GffStruct const& element) { return IsUnmodified(element); });
+}
+
+void GffWriter::MeasureSourceStruct(Raw::GffView const& source, std::uint32_t structIndex)
+{
+    ASSERT(structIndex < source.m_Structs.size());
+    Raw::GffStruct const& sourceStruct = source.m_Structs[structIndex];
+    std::uint32_t fieldCount = GetSourceFieldCount(sourceStruct);
+
+    ++m_StructCount;
+    m_FieldCount += fieldCount;
+
+    if (fieldCount > 1)
+    {
+        m_FieldIndicesCount += fieldCount;
+    }
+
+    ForEachSourceField(source, sourceStruct, [&](Raw::GffField const& sourceField)
+    {
+        MeasureSourceField(source, sourceField);
+    });
+}
+
+void GffWriter::MeasureSourceField(Raw::GffView const& source, Raw::GffField const& sourceField)
+{
+    RemapLabel(source, sourceField.m_LabelIndex);
+
+    if (sourceField.m_Type == Raw::GffField::Type::Struct)
+    {
+        MeasureSourceStruct(source, sourceField.m_DataOrDataOffset);
+    }
+    else if (sourceField.m_Type == Raw::GffField::Type::List)
+    {
+        std::uint32_t elementCount = 0;
+
+        ForEachSourceListElement(source, sourceField, [&](std::uint32_t structIndex)
+        {
+            MeasureSourceStruct(source, structIndex);
+            ++elementCount;
+        });
+
+        m_ListIndicesSize += (elementCount + 1) * sizeof(std::uint32_t);
+    }
+    else
+    {
+        m_FieldDataSize += GetSourceFieldDataSize(source, sourceField);
+    }
+}
+
+std::uint32_t GffWriter::WriteSourceStruct(Raw::GffView const& source, std::uint32_t structIndex)
+{
+    ASSERT(structIndex < source.m_Structs.size());
+    Raw::GffStruct const& sourceStruct = source.m_Structs[structIndex];
+
+    std::uint32_t baseFieldIndex;
+    std::uint32_t outputStructIndex = WriteStructHeader(sourceStruct.m_Type, GetSourceFieldCount(sourceStruct), &baseFieldIndex);
+
+    ForEachSourceField(source, sourceStruct, [&](Raw::GffField const& sourceField)
+    {
+        WriteAt(m_Fields, (baseFieldIndex++) * sizeof(Raw::GffField), WriteSourceField(source, sourceField));
+    });
+
+    return outputStructIndex;
+}
+
+Raw::GffField GffWriter::WriteSourceField(Raw::GffView const& source, Raw::GffField const& sourceField)
+{
+    Raw::GffField field = sourceField;
+    field.m_LabelIndex = RemapLabel(source, sourceField.m_LabelIndex);
+
+    if (sourceField.m_Type == Raw::GffField::Type::Struct)
+    {
+        field.m_DataOrDataOffset = WriteSourceStruct(source, sourceField.m_DataOrDataOffset);
+    }
+    else if (sourceField.m_Type == Raw::GffField::Type::List)
+    {
+        std::size_t scratchBase = m_ListScratch.size();
+
+        ForEachSourceListElement(source, sourceField, [&](std::uint32_t structIndex)
+        {
+            std::uint32_t elementIndex = WriteSourceStruct(source, structIndex);
+            m_ListScratch.emplace_back(elementIndex);
+        });
+
+        field.m_DataOrDataOffset = WriteListIndices(scratchBase);
+    }
+    else if (std::uint32_t size = GetSourceFieldDataSize(source, sourceField))
+    {
+        field.m_DataOrDataOffset = WriteFieldData(source.m_FieldData.data() + sourceField.m_DataOrDataOffset, size);
+    }
+
+    return field;
+}
+
+std::uint32_t GffWriter::RemapLabel(Raw::GffView const& source, std::uint32_t labelIndex)
+{
+    if (&source != m_RemapSource)
+    {
+        m_RemapSource = &source;
+        m_LabelRemap.assign(source.m_Labels.size(), EmptySlot);
+    }
+
+    ASSERT(labelIndex < m_LabelRemap.size());
+    std::uint32_t& remapped = m_LabelRemap[labelIndex];
+
+    if (remapped == EmptySlot)
+    {
+        remapped = m_Labels.FindOrAdd(source.m_Labels[labelIndex]);
+    }
+
+    return remapped;
+}
+
+void GffWriter::MeasurePooledFieldData(GffFieldValue const& value)
+{
+    std::uint32_t index = m_FieldDataPool.FindOrAdd(m_FieldDataSize,
+        [&value](std::vector<std::byte>* out) { EncodeFieldData(value, out); });
+
+    m_PooledFieldData.emplace_back(index);
+
+    // Every payload has at least a size, so a payload at the end of the field data so far must be a new one.
+    if (m_FieldDataPool.GetFieldDataOffset(index) == m_FieldDataSize)
+    {
+        m_FieldDataSize += static_cast<std::uint32_t>(m_FieldDataPool.GetPayload(index).size());
+    }
+}
+
+std::uint32_t GffWriter::WritePooledFieldData()
+{
+    ASSERT(m_NextPooledFieldData < m_PooledFieldData.size());
+    std::uint32_t index = m_PooledFieldData[m_NextPooledFieldData++];
+    std::uint32_t offset = m_FieldDataPool.GetFieldDataOffset(index);
+
+    if (offset == m_NextFieldData)
+    {
+        Span<std::byte const> payload = m_FieldDataPool.GetPayload(index);
+        WriteFieldData(payload.data(), payload.size());
+    }
+
+    ASSERT(offset < m_NextFieldData);
+    return offset;
+}
+
+std::uint32_t GffLabelTable::FindOrAdd(GffFieldLabel const& label)
+{
+    // Keep the index at most half full so probes stay short.
+    if ((m_Labels.size() + 1) * 2 > m_Index.size())
+    {
+        m_Index.assign(std::max<std::size_t>(64, m_Index.size() * 2), EmptySlot);
+        std::size_t mask = m_Index.size() - 1;
+
+        for (std::uint32_t i = 0; i < m_Labels.size(); ++i)
+        {
+            std::size_t slot = m_Labels[i].GetHash() & mask;
+
+            while (m_Index[slot] != EmptySlot)
+            {
+                slot = (slot + 1) & mask;
+            }
+
+            m_Index[slot] = i;
+        }
+    }
+
+    std::size_t mask = m_Index.size() - 1;
+
+    for (std::size_t slot = label.GetHash() & mask; ; slot = (slot + 1) & mask)
+    {
+        std::uint32_t index = m_Index[slot];
+
+        if (index == EmptySlot)
+        {
+            index = static_cast<std::uint32_t>(m_Labels.size());
+            m_Index[slot] = index;
+            m_Labels.emplace_back(label);
+            return index;
+        }
+
+        if (m_Labels[index] == label)
+        {
+            return index;
+        }
+    }
+}
+
+void GffLabelTable::Clear()
+{
+    m_Labels.clear();
+    std::fill(std::begin(m_Index), std::end(m_Index), EmptySlot);
+}
+
+std::vector<GffFieldLabel> const& GffLabelTable::GetLabels() const
+{
+    return m_Labels;
+}
+
+std::uint32_t GffFieldDataPool::GetFieldDataOffset(std::uint32_t index) const
+{
+    ASSERT(index < m_Entries.size());
+    return m_Entries[index].m_FieldDataOffset;
+}
+
+Span<std::byte const> GffFieldDataPool::GetPayload(std::uint32_t index) const
+{
+    ASSERT(index < m_Entries.size());
+    return { m_Payloads.data() + m_Entries[index].m_PayloadOffset, m_Entries[index].m_PayloadSize };
+}
+
+void GffFieldDataPool::Clear()
+{
+    m_Entries.clear();
+    m_Payloads.clear();
+    std::fill(std::begin(m_Index), std::end(m_Index), EmptySlot);
+}
+
+std::uint32_t GffFieldDataPool::FindOrAddEncoded(std::uint32_t fieldDataOffset, std::size_t payloadOffset)
+{
+    std::byte const* payload = m_Payloads.data() + payloadOffset;
+    std::size_t payloadSize = m_Payloads.size() - payloadOffset;
+    std::uint64_t hash = HashBytes(HashSeed, payload, payloadSize);
+
+    // As for GffLabelTable, keep the index at most half full.
+    if ((m_Entries.size() + 1) * 2 > m_Index.size())
+    {
+        m_Index.assign(std::max<std::size_t>(64, m_Index.size() * 2), EmptySlot);
+        std::size_t mask = m_Index.size() - 1;
+
+        for (std::uint32_t i = 0; i < m_Entries.size(); ++i)
+        {
+            std::size_t slot = m_Entries[i].m_Hash & mask;
+
+            while (m_Index[slot] != EmptySlot)
+            {
+                slot = (slot + 1) & mask;
+            }
+
+            m_Index[slot] = i;
+        }
+    }
+
+    std::size_t mask = m_Index.size() - 1;
+
+    for (std::size_t slot = hash & mask; ; slot = (slot + 1) & mask)
+    {
+        std::uint32_t index = m_Index[slot];
+
+        if (index == EmptySlot)
+        {
+            index = static_cast<std::uint32_t>(m_Entries.size());
+            m_Index[slot] = index;
+            m_Entries.push_back({ hash, fieldDataOffset, static_cast<std::uint32_t>(payloadOffset), static_cast<std::uint32_t>(payloadSize) });
+            return index;
+        }
+
+        Entry const& entry = m_Entries[index];
+
+        if (entry.m_Hash == hash && entry.m_PayloadSize == payloadSize &&
+            std::memcmp(m_Payloads.data() + entry.m_PayloadOffset, payload, payloadSize) == 0)
+        {
+            m_Payloads.resize(payloadOffset);
+            return index;
+        }
+    }
+}
 
 }
@@ -1,11 +1,22 @@
 #pragma once
 
-#include <any>
-#include <map>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "FileFormats/Gff/Gff_Raw.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/Span.hpp"
+
+class ThreadPool;
 
 namespace FileFormats::Gff::Friendly {
 
@@ -48,19 +59,162 @@ Raw::GffField::Type GetTypeFromType(const Type_VOID&);
 Raw::GffField::Type GetTypeFromType(const Type_Struct&);
 Raw::GffField::Type GetTypeFromType(const Type_List&);
 
+// The same mapping as above, but available at compile time - GffFieldTypeOf<Type_BYTE>::Value == Type::BYTE.
+template <typename T> struct GffFieldTypeOf;
+template <> struct GffFieldTypeOf<Type_BYTE> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::BYTE; };
+template <> struct GffFieldTypeOf<Type_CHAR> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::CHAR; };
+template <> struct GffFieldTypeOf<Type_WORD> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::WORD; };
+template <> struct GffFieldTypeOf<Type_SHORT> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::SHORT; };
+template <> struct GffFieldTypeOf<Type_DWORD> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::DWORD; };
+template <> struct GffFieldTypeOf<Type_INT> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::INT; };
+template <> struct GffFieldTypeOf<Type_DWORD64> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::DWORD64; };
+template <> struct GffFieldTypeOf<Type_INT64> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::INT64; };
+template <> struct GffFieldTypeOf<Type_FLOAT> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::FLOAT; };
+template <> struct GffFieldTypeOf<Type_DOUBLE> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::DOUBLE; };
+template <> struct GffFieldTypeOf<Type_CExoString> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::CExoString; };
+template <> struct GffFieldTypeOf<Type_CResRef> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::ResRef; };
+template <> struct GffFieldTypeOf<Type_CExoLocString> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::CExoLocString; };
+template <> struct GffFieldTypeOf<Type_VOID> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::VOID; };
+template <> struct GffFieldTypeOf<Type_Struct> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::Struct; };
+template <> struct GffFieldTypeOf<Type_List> { static constexpr Raw::GffField::Type Value = Raw::GffField::Type::List; };
+
+// A field label. Labels are at most 16 characters, so rather than a heap allocated string we store them inline
+// as a fixed 16 byte key with the unused characters zeroed - the same as the raw label array.
+// Labels are compared as two 64-bit words rather than character by character.
+class GffFieldLabel
+{
+public:
+    GffFieldLabel();
+    GffFieldLabel(char const* label);
+    GffFieldLabel(std::string const& label);
+    GffFieldLabel(std::string_view label);
+    GffFieldLabel(Raw::GffLabel const& label);
+
+    // Returns the label without the trailing nulls.
+    std::string_view GetString() const;
+
+    // Copies the label into the raw label format.
+    Raw::GffLabel ToRawLabel() const;
+
+    bool operator==(GffFieldLabel const& rhs) const;
+    bool operator!=(GffFieldLabel const& rhs) const;
+
+    // Orders labels alphabetically.
+    bool operator<(GffFieldLabel const& rhs) const;
+
+    std::size_t GetHash() const;
+
+private:
+    std::uint64_t GetWord(std::size_t index) const;
+
+    alignas(std::uint64_t) char m_Label[16];
+};
+
+// A single field value - a tagged union keyed by the GFF type.
+// The fixed size types (BYTE through DOUBLE) are stored inline. The variable size types (CExoString, ResRef,
+// CExoLocString, VOID, Struct and List) are stored out of line and owned by the value.
+class GffFieldValue
+{
+public:
+    // Constructs a BYTE with the value 0.
+    GffFieldValue();
+
+    template <typename T>
+    explicit GffFieldValue(T value);
+
+    // Moves only hand over the stored value or pointer, and never throw - which lets the field vectors move values
+    // rather than copy them when they grow.
+    GffFieldValue(GffFieldValue const& rhs);
+    GffFieldValue(GffFieldValue&& rhs) noexcept;
+    GffFieldValue& operator=(GffFieldValue const& rhs);
+    GffFieldValue& operator=(GffFieldValue&& rhs) noexcept;
+    ~GffFieldValue();
+
+    Raw::GffField::Type GetType() const;
+
+    // Returns a pointer to the stored value if it is of type T, or nullptr if the value is a different type.
+    // The mapping of raw types to T matches the defines in Friendly::Type_*.
+    template <typename T>
+    T const* Get() const;
+
+    template <typename T>
+    T* Get();
+
+    // Returns a hash of the type and value, going through nested structs and lists. Equal values have equal hashes,
+    // and floating point values are hashed by their bits. See GffStruct::GetHash.
+    std::uint64_t GetHash() const;
+
+private:
+    void CopyFrom(GffFieldValue const& rhs);
+    void MoveFrom(GffFieldValue&& rhs) noexcept;
+    void Destroy() noexcept;
+
+    Raw::GffField::Type m_Type;
+
+    union
+    {
+        Type_BYTE m_BYTE;
+        Type_CHAR m_CHAR;
+        Type_WORD m_WORD;
+        Type_SHORT m_SHORT;
+        Type_DWORD m_DWORD;
+        Type_INT m_INT;
+        Type_DWORD64 m_DWORD64;
+        Type_INT64 m_INT64;
+        Type_FLOAT m_FLOAT;
+        Type_DOUBLE m_DOUBLE;
+
+        // Points to one of the variable size types, as described by m_Type.
+        void* m_Complex;
+    };
+};
+
+class GffWriter;
+
+// GffStruct and GffList are handles to reference counted nodes, which are shared between copies until one of the
+// copies is modified - at which point it takes a copy of its own node (copy on write). Copying a struct or list, and
+// reading one out of a field, is therefore O(1), and modifying a copy clones only the nodes along the modified path.
+//
+// The one exception is GffList::GetStructs(), which returns a reference to the elements that can modify them without
+// the list knowing. Once it has been called, copies of that list take a node of their own rather than sharing it, so
+// a modification made through the reference later on can't show through a copy.
+//
+// The nodes, and the field maps and element arrays within them, are allocated from the std::pmr::memory_resource the
+// struct or list was constructed with. Everything decoded beneath it, and every node cloned from it on write, uses the
+// same resource - so the resource must outlive every struct and list taken from the Gff. If a ThreadPool is used as
+// well, the resource must be safe to use from several threads at once: a std::pmr::synchronized_pool_resource, for
+// example, rather than a monotonic_buffer_resource. The field values themselves are still allocated from the heap.
 class GffStruct
 {
 public:
-    GffStruct() = default;
+    GffStruct();
+    explicit GffStruct(std::pmr::memory_resource* resource);
 
     // This will construct a struct from one struct directly.
-    GffStruct(Raw::GffStruct const& rawStruct, Raw::Gff const& rawGff);
+    // If a pool is provided, large lists within the struct are decoded across it. See GffList.
+    GffStruct(Raw::GffStruct const& rawStruct, Raw::Gff const& rawGff, ThreadPool* pool = nullptr,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    GffStruct(Raw::GffStruct const& rawStruct, Raw::GffView const& rawGff, ThreadPool* pool = nullptr,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     // This will construct a struct from one field in the gff - assuming the field is of type struct (e.g. its own entry).
-    GffStruct(Raw::GffField const& rawField, Raw::Gff const& rawGff);
-
-    // The field map maps between std::string (field name) -> { Type (gff Type), std::any (type safe variant) }
-    using FieldMap = std::map<std::string, std::pair<Raw::GffField::Type, std::any>>;
+    GffStruct(Raw::GffField const& rawField, Raw::Gff const& rawGff, ThreadPool* pool = nullptr,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    GffStruct(Raw::GffField const& rawField, Raw::GffView const& rawGff, ThreadPool* pool = nullptr,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // This will construct a lazy struct from an index into the struct array of a shared view.
+    // The fields are not decoded until the struct is first accessed, and nested structs and lists are lazy too.
+    // Decoding mutates the struct, so a lazy struct must not be accessed from multiple threads at once - even
+    // through const accessors.
+    //
+    // The view is kept alive until the struct is first modified. Until then, GffWriter copies the struct straight
+    // from the view rather than encoding it again.
+    GffStruct(std::shared_ptr<Raw::GffView const> rawGff, std::uint32_t structIndex,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // The field map is a flat array of { label, value } pairs, sorted by label.
+    using FieldMap = std::pmr::vector<std::pair<GffFieldLabel, GffFieldValue>>;
 
     // We expose direct access to the map here. This allows users to iterate over all fields if they need to do so.
     FieldMap const& GetFields() const;
@@ -68,7 +222,17 @@ public:
     // The mapping of raw types to return values from ReadField matches the defines in Friendly::Type_*.
     // This looks up the field in m_Fields and extracts the actual type.
     template <typename T>
-    bool ReadField(std::string const& fieldName, T* out) const;
+    bool ReadField(GffFieldLabel const& fieldName, T* out) const;
+
+    // Returns a pointer to the value of the field, or nullptr if there is no such field. Unlike ReadField, nothing
+    // is copied, which matters for strings, lists and binary data. The pointer is valid until the struct is next
+    // modified. As for ReadField, a type mismatch is an error.
+    template <typename T>
+    T const* GetField(GffFieldLabel const& fieldName) const;
+
+    // Views into CExoString or ResRef fields, and into VOID fields, with the same lifetime as GetField.
+    bool ReadField(GffFieldLabel const& fieldName, std::string_view* out) const;
+    bool ReadField(GffFieldLabel const& fieldName, Span<std::byte const>* out) const;
 
     // Similar to above, except using the iterator.
     template <typename T>
@@ -81,37 +245,126 @@ public:
     // The mapping of raw types to GFF types matches the defines in Friendly::Type_*.
     // This writes into the field the provided value, overwriting it if it already exists.
     template <typename T>
-    void WriteField(std::string const& fieldName, T field);
+    void WriteField(GffFieldLabel const& fieldName, T field);
 
     // Deletes the field if it exists. Does nothing if it does not.
     // Returns whether the field was deleted.
-    bool DeleteField(std::string const& fieldName);
+    bool DeleteField(GffFieldLabel const& fieldName);
 
     std::uint32_t GetUserDefinedId() const;
     void SetUserDefinedId(std::uint32_t id);
 
+    // Returns a 64-bit hash of the ID and every field, computed bottom up through nested structs and lists. Two
+    // structs with the same contents always have the same hash, so comparing hashes compares whole subtrees at once
+    // (with a 1 in 2^64 chance of a false match). The hash is cached in the node until the struct is modified, so
+    // it is only computed once for any number of copies. As for lazy decoding, this mutates the node, though the
+    // cache itself can be filled by copies on any number of threads at once.
+    std::uint64_t GetHash() const;
+
 private:
-    void ConstructInternal(Raw::GffStruct const& rawStruct, Raw::Gff const& rawGff);
-    void ConstructInternal(std::vector<Raw::GffField> const& rawFields, Raw::Gff const& rawGff);
+    friend class GffList;
+    friend class GffWriter;
+
+    // These are shared between Raw::Gff and Raw::GffView.
+    // If lazySource is provided, nested structs and lists are constructed lazily from it. Otherwise, if pool is
+    // provided, nested lists are decoded across it.
+    template <typename RawGff>
+    void ConstructInternal(Raw::GffStruct const& rawStruct, RawGff const& rawGff,
+        std::shared_ptr<Raw::GffView const> const* lazySource = nullptr, ThreadPool* pool = nullptr);
+
+    template <typename RawGff>
+    void ConstructField(Raw::GffField const& rawField, RawGff const& rawGff,
+        std::shared_ptr<Raw::GffView const> const* lazySource, ThreadPool* pool);
+
+    // Decodes the fields if this is a lazy struct which has not been accessed yet. Does nothing otherwise.
+    void DecodeIfLazy() const;
+
+    // Prepares the struct for modification: decodes the fields if lazy, takes a copy of the node if it is shared,
+    // then forgets the source - the struct no longer matches it.
+    void MarkModified();
+
+    // Returns the position of the field in m_Fields if present, or the position it should be inserted at if not.
+    FieldMap::iterator FindField(GffFieldLabel const& fieldName) const;
+
+    // The resource this struct's node was allocated from, which nested structs and lists are allocated from too.
+    std::pmr::memory_resource* GetResource() const;
+
+    struct Node
+    {
+        explicit Node(std::pmr::memory_resource* resource) : m_Fields(resource)
+        { }
+
+        // We map between field name -> value here.
+        FieldMap m_Fields;
+
+        std::uint32_t m_UserDefinedId = 0;
+
+        // The view that a lazy struct was constructed from, and the index of the struct within it.
+        // This is released as soon as the struct is modified, so while it is set the struct matches the source.
+        std::shared_ptr<Raw::GffView const> m_Source;
+        std::uint32_t m_SourceStructIndex = 0;
+
+        // Whether m_Fields has been decoded from the source yet.
+        bool m_Decoded = true;
 
-    // We map between field name -> variant here.
-    FieldMap m_Fields;
+        // The result of GetHash, or NoHash if it hasn't been computed since the struct was last modified. Structs
+        // sharing the node may hash it on several threads at once, but they all store the same value, so relaxed
+        // loads and stores are enough. A copy of the node starts without a hash, as it is only copied to be modified.
+        struct CachedHash
+        {
+            static constexpr std::uint64_t NoHash = 0;
 
-    std::uint32_t m_UserDefinedId;
+            CachedHash() = default;
+            CachedHash(CachedHash const&) { }
+            CachedHash& operator=(CachedHash const&)
+            {
+                m_Value.store(NoHash, std::memory_order_relaxed);
+                return *this;
+            }
+
+            std::atomic<std::uint64_t> m_Value { NoHash };
+        };
+
+        CachedHash m_Hash;
+    };
+
+    static std::shared_ptr<Node> MakeNode(std::pmr::memory_resource* resource);
+
+    // This is never null, except in a moved-from struct. A lazy struct populates the node the first time it is
+    // accessed - even through const accessors - which is visible to every struct sharing the node.
+    std::shared_ptr<Node> m_Node;
 };
 
 template <typename T>
-bool GffStruct::ReadField(std::string const& fieldName, T* out) const
+bool GffStruct::ReadField(GffFieldLabel const& fieldName, T* out) const
 {
     ASSERT(out);
 
-    auto entry = m_Fields.find(fieldName);
-    if (entry != std::end(m_Fields))
+    T const* value = GetField<T>(fieldName);
+    if (!value)
+    {
+        return false;
+    }
+
+    *out = *value;
+    return true;
+}
+
+template <typename T>
+T const* GffStruct::GetField(GffFieldLabel const& fieldName) const
+{
+    DecodeIfLazy();
+
+    auto entry = FindField(fieldName);
+    if (entry == std::end(m_Node->m_Fields) || entry->first != fieldName)
     {
-        return ReadField(entry, out);
+        return nullptr;
     }
 
-    return false;
+    T const* value = entry->second.template Get<T>();
+    ASSERT_MSG(value, "Failed to extract field name %.16s due to a type mismatch. The Gff type stored was %u.",
+        entry->first.GetString().data(), static_cast<std::uint32_t>(entry->second.GetType()));
+    return value;
 }
 
 template <typename T>
@@ -126,58 +379,524 @@ bool GffStruct::ReadField(typename GffStruct::FieldMap::value_type const& kvp, T
 {
     ASSERT(out);
 
-    std::string const& fieldName = kvp.first;
-    Raw::GffField::Type type = kvp.second.first;
-    std::any const& variant = kvp.second.second;
+    T const* value = kvp.second.template Get<T>();
 
-    try
-    {
-        *out = std::any_cast<T>(variant);
-        return true;
-    }
-    catch (std::bad_cast&)
+    if (!value)
     {
-        ASSERT_FAIL_MSG("Failed to extract field name %s due to a type mismatch. The Gff type stored was %u.", fieldName.c_str(), type);
+        ASSERT_FAIL_MSG("Failed to extract field name %.16s due to a type mismatch. The Gff type stored was %u.",
+            kvp.first.GetString().data(), static_cast<std::uint32_t>(kvp.second.GetType()));
         return false;
     }
+
+    *out = *value;
+    return true;
 }
 
 template <typename T>
-void GffStruct::WriteField(std::string const& fieldName, T field)
+void GffStruct::WriteField(GffFieldLabel const& fieldName, T field)
 {
-    m_Fields[fieldName] = std::make_pair(GetTypeFromType(field), std::move(field));
+    MarkModified();
+
+    auto entry = FindField(fieldName);
+    if (entry != std::end(m_Node->m_Fields) && entry->first == fieldName)
+    {
+        entry->second = GffFieldValue(std::move(field));
+    }
+    else
+    {
+        m_Node->m_Fields.emplace(entry, fieldName, GffFieldValue(std::move(field)));
+    }
 }
 
 class GffList
 {
 public:
-    GffList() = default;
+    GffList();
+    explicit GffList(std::pmr::memory_resource* resource);
 
-    // Constructs a list from the field describing it.
-    GffList(Raw::GffField const& rawField, Raw::Gff const& rawGff);
+    // Copies share the node, unless the structs have been requested for modification - see GetStructs.
+    GffList(GffList const& rhs);
+    GffList(GffList&& rhs) noexcept = default;
+    GffList& operator=(GffList const& rhs);
+    GffList& operator=(GffList&& rhs) noexcept = default;
 
-    std::vector<GffStruct>& GetStructs();
-    std::vector<GffStruct> const& GetStructs() const;
+    // Constructs a list from the field describing it.
+    //
+    // If a pool is provided, lists of at least ParallelDecodeMinElements elements are split into ranges which are
+    // decoded across the pool, as are any large lists nested within them. Every element is decoded into its own slot,
+    // so the result is exactly the same as decoding serially.
+    static constexpr std::size_t ParallelDecodeMinElements = 256;
+
+    GffList(Raw::GffField const& rawField, Raw::Gff const& rawGff, ThreadPool* pool = nullptr,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    GffList(Raw::GffField const& rawField, Raw::GffView const& rawGff, ThreadPool* pool = nullptr,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Constructs a lazy list from a list field in a shared view. See the lazy GffStruct constructor.
+    // The elements are materialised (as lazy structs) the first time the structs are requested.
+    GffList(Raw::GffField const& rawField, std::shared_ptr<Raw::GffView const> rawGff,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Requesting the structs for modification takes a copy of the list's node if it is shared, and detaches the
+    // list from its source. Each element is shared, and keeps its own source, until it is modified itself.
+    // As the reference may still be used to modify the list after it has been copied, every later copy of the list
+    // takes a copy of the node straight away - copying the elements' handles, not the elements.
+    std::pmr::vector<GffStruct>& GetStructs();
+    std::pmr::vector<GffStruct> const& GetStructs() const;
+
+    // Returns a hash of the elements in order, from their cached hashes. See GffStruct::GetHash.
+    std::uint64_t GetHash() const;
 
 private:
-    // Note that these are copies of the structs, rather than references.
-    std::vector<GffStruct> m_Structs;
+    friend class GffWriter;
+
+    template <typename RawGff>
+    void ConstructInternal(Raw::GffField const& rawField, RawGff const& rawGff, ThreadPool* pool);
+
+    void MaterialiseIfLazy() const;
+
+    std::pmr::memory_resource* GetResource() const;
+
+    struct Node
+    {
+        explicit Node(std::pmr::memory_resource* resource) : m_Structs(resource)
+        { }
+
+        // The elements, which share their nodes with any other copies of the same structs.
+        std::pmr::vector<GffStruct> m_Structs;
+
+        // The view that a lazy list was constructed from, and the list field within it. As for GffStruct, this is
+        // released as soon as the list is modified.
+        std::shared_ptr<Raw::GffView const> m_Source;
+        Raw::GffField m_SourceField;
+
+        // Whether m_Structs has been materialised from the source yet.
+        bool m_Materialised = true;
+
+        // Whether GetStructs has handed out a reference which can modify m_Structs, so the node mustn't be shared.
+        bool m_Unshareable = false;
+    };
+
+    static std::shared_ptr<Node> MakeNode(std::pmr::memory_resource* resource);
+
+    // As for GffStruct, this is never null except in a moved-from list.
+    std::shared_ptr<Node> m_Node;
 };
 
+// Calls callback with the value as whichever of the Friendly::Type_* it holds, by const reference - so a single
+// generic lambda can handle every type, without the caller switching on GetType() or copying anything out:
+//
+//     Visit(value, [](auto const& v) { Print(v); });
+template <typename Callback>
+void Visit(GffFieldValue const& value, Callback&& callback);
+
+// Calls callback(label, value) for every field of the struct in label order, with the value as above.
+// The references are valid until the struct is next modified, so the callback must not modify it.
+template <typename Callback>
+void Visit(GffStruct const& gffStruct, Callback&& callback);
+
+template <typename Callback>
+void Visit(GffFieldValue const& value, Callback&& callback)
+{
+    switch (value.GetType())
+    {
+        case Raw::GffField::Type::BYTE:          callback(*value.Get<Type_BYTE>()); break;
+        case Raw::GffField::Type::CHAR:          callback(*value.Get<Type_CHAR>()); break;
+        case Raw::GffField::Type::WORD:          callback(*value.Get<Type_WORD>()); break;
+        case Raw::GffField::Type::SHORT:         callback(*value.Get<Type_SHORT>()); break;
+        case Raw::GffField::Type::DWORD:         callback(*value.Get<Type_DWORD>()); break;
+        case Raw::GffField::Type::INT:           callback(*value.Get<Type_INT>()); break;
+        case Raw::GffField::Type::DWORD64:       callback(*value.Get<Type_DWORD64>()); break;
+        case Raw::GffField::Type::INT64:         callback(*value.Get<Type_INT64>()); break;
+        case Raw::GffField::Type::FLOAT:         callback(*value.Get<Type_FLOAT>()); break;
+        case Raw::GffField::Type::DOUBLE:        callback(*value.Get<Type_DOUBLE>()); break;
+        case Raw::GffField::Type::CExoString:    callback(*value.Get<Type_CExoString>()); break;
+        case Raw::GffField::Type::ResRef:        callback(*value.Get<Type_CResRef>()); break;
+        case Raw::GffField::Type::CExoLocString: callback(*value.Get<Type_CExoLocString>()); break;
+        case Raw::GffField::Type::VOID:          callback(*value.Get<Type_VOID>()); break;
+        case Raw::GffField::Type::Struct:        callback(*value.Get<Type_Struct>()); break;
+        case Raw::GffField::Type::List:          callback(*value.Get<Type_List>()); break;
+        default: ASSERT_FAIL_MSG("Unrecognised field type %u.", static_cast<std::uint32_t>(value.GetType())); break;
+    }
+}
+
+template <typename Callback>
+void Visit(GffStruct const& gffStruct, Callback&& callback)
+{
+    for (GffStruct::FieldMap::value_type const& kvp : gffStruct.GetFields())
+    {
+        Visit(kvp.second, [&callback, &kvp](auto const& value) { callback(kvp.first, value); });
+    }
+}
+
 // This is a user friendly wrapper around the Gff data.
 class Gff
 {
 public:
     Gff();
-    Gff(Raw::Gff const& rawGff);
+
+    // If a pool is provided, large lists are decoded across it - see GffList. Area and module files with thousands
+    // of tiles, placeables or journal entries decode several times faster.
+    // If a resource is provided, the structs and lists are allocated from it - see GffStruct.
+    Gff(Raw::Gff const& rawGff, ThreadPool* pool = nullptr, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Constructing from a view skips the section copies made by Raw::Gff. The view is not needed afterwards.
+    Gff(Raw::GffView const& rawGff, ThreadPool* pool = nullptr, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Takes ownership of the view and returns a Gff which is decoded lazily: each struct decodes its fields the
+    // first time it is accessed and each list materialises its elements the first time it is iterated.
+    // The view is kept alive until nothing refers to it anymore. Refer to the lazy GffStruct constructor.
+    //
+    // This is also the cheapest way to load, modify and save a file: when writing, anything that wasn't modified
+    // is copied through from the view rather than encoded again.
+    static Gff Lazy(Raw::GffView&& rawGff, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     GffStruct& GetTopLevelStruct();
     GffStruct const& GetTopLevelStruct() const;
 
+    // The four character type written to the header, e.g. "GIT " or "UTC ". A Gff read from a file keeps the type
+    // of that file, and a new one starts as "UTC ".
+    std::string_view GetFileType() const;
+    void SetFileType(char const* fileType);
+
     bool WriteToFile(char const* path) const;
 
+    // Serialises the Gff into out, which is resized to fit exactly.
+    bool WriteToBytes(std::vector<std::byte>* out) const;
+
 private:
+    Gff(std::shared_ptr<Raw::GffView const> rawGff, std::pmr::memory_resource* resource);
+
     GffStruct m_TopLevelStruct;
+    char m_FileType[4];
+};
+
+// GffLabelTable interns labels for writing. Each distinct label is numbered in the order it was first added, which is
+// its index in the label section of the output.
+class GffLabelTable
+{
+public:
+    // Returns the index of the label, adding it if it isn't there yet.
+    std::uint32_t FindOrAdd(GffFieldLabel const& label);
+
+    // Forgets every label, but keeps the memory for reuse.
+    void Clear();
+
+    std::vector<GffFieldLabel> const& GetLabels() const;
+
+private:
+    // The labels in the order they were first added, and an open addressing index into them.
+    std::vector<GffFieldLabel> m_Labels;
+    std::vector<std::uint32_t> m_Index;
+};
+
+// GffFieldDataPool interns the variable size field data (CExoString, ResRef, CExoLocString and VOID) written in
+// canonical mode. Each distinct payload is written once, at the field data offset it was first added at.
+class GffFieldDataPool
+{
+public:
+    // Returns the index of the payload, adding it at fieldDataOffset if it isn't there yet.
+    // The payload is encoded by encode(std::vector<std::byte>*), which appends it to the vector.
+    template <typename Encode>
+    std::uint32_t FindOrAdd(std::uint32_t fieldDataOffset, Encode&& encode);
+
+    std::uint32_t GetFieldDataOffset(std::uint32_t index) const;
+    Span<std::byte const> GetPayload(std::uint32_t index) const;
+
+    // Forgets every payload, but keeps the memory for reuse.
+    void Clear();
+
+private:
+    std::uint32_t FindOrAddEncoded(std::uint32_t fieldDataOffset, std::size_t payloadOffset);
+
+    struct Entry
+    {
+        std::uint64_t m_Hash;
+        std::uint32_t m_FieldDataOffset;
+
+        // Where the payload is in m_Payloads.
+        std::uint32_t m_PayloadOffset;
+        std::uint32_t m_PayloadSize;
+    };
+
+    // The distinct payloads in the order they were first added, back to back, and an open addressing index into them.
+    std::vector<Entry> m_Entries;
+    std::vector<std::byte> m_Payloads;
+    std::vector<std::uint32_t> m_Index;
+};
+
+template <typename Encode>
+std::uint32_t GffFieldDataPool::FindOrAdd(std::uint32_t fieldDataOffset, Encode&& encode)
+{
+    // Encode the payload where it would go if it's new, then take it back off again if it isn't.
+    std::size_t payloadOffset = m_Payloads.size();
+    encode(&m_Payloads);
+    return FindOrAddEncoded(fieldDataOffset, payloadOffset);
+}
+
+// GffWriter serialises a friendly Gff in two passes, without building a Raw::Gff in between.
+// - Measure walks the tree once to assign labels and size every section, which gives the exact size of the output.
+// - Write walks it again and writes every section straight into its final position in the caller's buffer.
+//
+// Gff::WriteToFile and Gff::WriteToBytes use a temporary writer. When writing many files, keep one writer around
+// and reuse it - the label table and scratch space are kept between calls, so steady state writes don't allocate
+// beyond the output buffer itself.
+//
+// By default, unmodified parts of a lazily decoded Gff are copied through in the layout of the file they came from,
+// so the same contents can be written differently depending on where they were loaded from. In canonical mode the
+// output depends only on the contents, so identical contents always produce identical bytes:
+// - Everything is encoded from the friendly structs, in the same order: fields by label, depth first.
+// - Identical CExoString, ResRef, CExoLocString and VOID payloads are written to the field data once and shared
+//   between every field holding them. Labels are always written once.
+// Canonical output is smaller but slower to write, and decodes any lazy structs it writes.
+class GffWriter
+{
+public:
+    enum class Mode
+    {
+        Default,
+        Canonical
+    };
+
+    explicit GffWriter(Mode mode = Mode::Default);
+    // Pass one. Returns the number of bytes the Gff will be written as.
+    std::size_t Measure(Gff const& gff);
+
+    // Pass two. Writes the Gff passed to the last call to Measure into buffer, which must be at least as large as
+    // the size Measure returned. The Gff must not have been modified in between.
+    void Write(std::byte* buffer);
+
+    // Both passes, into out, which is resized to fit exactly.
+    bool WriteToBytes(Gff const& gff, std::vector<std::byte>* out);
+
+    // Both passes, into a reused internal buffer which is then written to disk in a single write. The file is
+    // replaced rather than overwritten, so the Gff can be saved over the file it was loaded from.
+    bool WriteToFile(Gff const& gff, char const* path);
+
+private:
+    void MeasureStruct(GffStruct const& gffStruct);
+    void MeasureField(GffStruct::FieldMap::value_type const& kvp);
+
+    std::uint32_t WriteStruct(GffStruct const& gffStruct);
+    Raw::GffField WriteField(GffStruct::FieldMap::value_type const& kvp);
+    std::uint32_t WriteFieldData(void const* data, std::size_t length);
+
+    // Claims the next struct and a block of fields for it, and writes the struct and its field indices.
+    // Returns the index of the struct; the fields themselves are written at baseFieldIndex onwards.
+    std::uint32_t WriteStructHeader(std::uint32_t id, std::uint32_t fieldCount, std::uint32_t* baseFieldIndex);
+
+    // Writes the list of struct indices from scratchBase to the end of the scratch stack, then pops them.
+    // Returns the offset of the list.
+    std::uint32_t WriteListIndices(std::size_t scratchBase);
+
+    // Returns whether the struct or list still matches its source, along with everything beneath it.
+    static bool IsUnmodified(GffStruct const& gffStruct);
+    static bool IsUnmodified(GffList const& gffList);
+
+    // The same as the functions above, except copying the structs and fields from the raw source they were
+    // decoded from. Indices and offsets are rebased onto the output, but nothing is decoded.
+    void MeasureSourceStruct(Raw::GffView const& source, std::uint32_t structIndex);
+    void MeasureSourceField(Raw::GffView const& source, Raw::GffField const& sourceField);
+    std::uint32_t WriteSourceStruct(Raw::GffView const& source, std::uint32_t structIndex);
+    Raw::GffField WriteSourceField(Raw::GffView const& source, Raw::GffField const& sourceField);
+
+    // Returns the index in the output of a label in the source.
+    std::uint32_t RemapLabel(Raw::GffView const& source, std::uint32_t labelIndex);
+
+    // In canonical mode, adds the variable size field data of the value to the pool while measuring.
+    void MeasurePooledFieldData(GffFieldValue const& value);
+
+    // In canonical mode, takes the pooled field data of the next variable size field while writing. Writes it if
+    // this is the first field holding it, and returns its offset either way.
+    std::uint32_t WritePooledFieldData();
+
+    Mode m_Mode;
+    GffStruct const* m_TopLevelStruct = nullptr;
+    Raw::GffHeader m_Header;
+
+    GffLabelTable m_Labels;
+
+    // Maps label indices in the source of the structs being copied to label indices in the output.
+    Raw::GffView const* m_RemapSource;
+    std::vector<std::uint32_t> m_LabelRemap;
+
+    // Section sizes from Measure. Field indices are counted in indices, everything else in elements or bytes.
+    std::uint32_t m_StructCount;
+    std::uint32_t m_FieldCount;
+    std::uint32_t m_FieldIndicesCount;
+    std::uint32_t m_FieldDataSize;
+    std::uint32_t m_ListIndicesSize;
+
+    // The sections of the output buffer, and how much of each has been written so far, during Write.
+    std::byte* m_Structs;
+    std::byte* m_Fields;
+    std::byte* m_FieldData;
+    std::byte* m_FieldIndices;
+    std::byte* m_ListIndices;
+    std::uint32_t m_NextStruct;
+    std::uint32_t m_NextField;
+    std::uint32_t m_NextFieldIndex;
+    std::uint32_t m_NextFieldData;
+    std::uint32_t m_NextListIndices;
+
+    // The struct indices of the list elements being written, used as a stack as lists nest.
+    std::vector<std::uint32_t> m_ListScratch;
+
+    // In canonical mode, the pooled field data and the pool index of each variable size field in the order they are
+    // measured, which is the order they are written.
+    GffFieldDataPool m_FieldDataPool;
+    std::vector<std::uint32_t> m_PooledFieldData;
+    std::size_t m_NextPooledFieldData;
+
+    // Reused by WriteToFile.
+    std::vector<std::byte> m_Buffer;
+};
+
+inline GffFieldLabel::GffFieldLabel() : m_Label()
+{ }
+
+inline GffFieldLabel::GffFieldLabel(char const* label) : GffFieldLabel(std::string_view(label))
+{ }
+
+inline GffFieldLabel::GffFieldLabel(std::string const& label) : GffFieldLabel(std::string_view(label))
+{ }
+
+inline GffFieldLabel::GffFieldLabel(std::string_view label) : m_Label()
+{
+    ASSERT_MSG(label.size() <= sizeof(m_Label), "GFF labels are limited to 16 characters. %.*s will be truncated.",
+        static_cast<int>(label.size()), label.data());
+    std::memcpy(m_Label, label.data(), std::min(label.size(), sizeof(m_Label)));
+}
+
+inline GffFieldLabel::GffFieldLabel(Raw::GffLabel const& label) : m_Label()
+{
+    // Only copy up to the first null - anything after that is junk as far as we're concerned, and it would
+    // otherwise break comparisons.
+    std::memcpy(m_Label, label.m_Label, strnlen(label.m_Label, sizeof(m_Label)));
+}
+
+inline std::string_view GffFieldLabel::GetString() const
+{
+    return std::string_view(m_Label, strnlen(m_Label, sizeof(m_Label)));
+}
+
+inline Raw::GffLabel GffFieldLabel::ToRawLabel() const
+{
+    Raw::GffLabel label;
+    std::memcpy(label.m_Label, m_Label, sizeof(m_Label));
+    return label;
+}
+
+inline bool GffFieldLabel::operator==(GffFieldLabel const& rhs) const
+{
+    return GetWord(0) == rhs.GetWord(0) && GetWord(1) == rhs.GetWord(1);
+}
+
+inline bool GffFieldLabel::operator!=(GffFieldLabel const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+inline bool GffFieldLabel::operator<(GffFieldLabel const& rhs) const
+{
+    // The words are loaded little endian, so swap them to get the same ordering as comparing the characters.
+#if CMP_MSVC
+    std::uint64_t lhsHigh = _byteswap_uint64(GetWord(0));
+    std::uint64_t rhsHigh = _byteswap_uint64(rhs.GetWord(0));
+    std::uint64_t lhsLow = _byteswap_uint64(GetWord(1));
+    std::uint64_t rhsLow = _byteswap_uint64(rhs.GetWord(1));
+#else
+    std::uint64_t lhsHigh = __builtin_bswap64(GetWord(0));
+    std::uint64_t rhsHigh = __builtin_bswap64(rhs.GetWord(0));
+    std::uint64_t lhsLow = __builtin_bswap64(GetWord(1));
+    std::uint64_t rhsLow = __builtin_bswap64(rhs.GetWord(1));
+#endif
+
+    return lhsHigh < rhsHigh || (lhsHigh == rhsHigh && lhsLow < rhsLow);
+}
+
+inline std::size_t GffFieldLabel::GetHash() const
+{
+    // Labels often share long prefixes (ScriptAttacked, ScriptDamaged, ...), so mix well enough that the low bits
+    // are usable on their own by open addressing tables.
+    std::uint64_t hash = GetWord(0) ^ (GetWord(1) * 0x9E3779B97F4A7C15ull);
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return static_cast<std::size_t>(hash);
+}
+
+inline std::uint64_t GffFieldLabel::GetWord(std::size_t index) const
+{
+    std::uint64_t word;
+    std::memcpy(&word, m_Label + index * sizeof(word), sizeof(word));
+    return word;
+}
+
+inline GffFieldValue::GffFieldValue() : m_Type(Raw::GffField::Type::BYTE), m_BYTE(0)
+{ }
+
+template <typename T>
+GffFieldValue::GffFieldValue(T value) : m_Type(GffFieldTypeOf<T>::Value)
+{
+    if constexpr (std::is_same_v<T, Type_BYTE>) m_BYTE = value;
+    else if constexpr (std::is_same_v<T, Type_CHAR>) m_CHAR = value;
+    else if constexpr (std::is_same_v<T, Type_WORD>) m_WORD = value;
+    else if constexpr (std::is_same_v<T, Type_SHORT>) m_SHORT = value;
+    else if constexpr (std::is_same_v<T, Type_DWORD>) m_DWORD = value;
+    else if constexpr (std::is_same_v<T, Type_INT>) m_INT = value;
+    else if constexpr (std::is_same_v<T, Type_DWORD64>) m_DWORD64 = value;
+    else if constexpr (std::is_same_v<T, Type_INT64>) m_INT64 = value;
+    else if constexpr (std::is_same_v<T, Type_FLOAT>) m_FLOAT = value;
+    else if constexpr (std::is_same_v<T, Type_DOUBLE>) m_DOUBLE = value;
+    else m_Complex = new T(std::move(value));
+}
+
+inline Raw::GffField::Type GffFieldValue::GetType() const
+{
+    return m_Type;
+}
+
+template <typename T>
+T const* GffFieldValue::Get() const
+{
+    if (m_Type != GffFieldTypeOf<T>::Value)
+    {
+        return nullptr;
+    }
+
+    if constexpr (std::is_same_v<T, Type_BYTE>) return &m_BYTE;
+    else if constexpr (std::is_same_v<T, Type_CHAR>) return &m_CHAR;
+    else if constexpr (std::is_same_v<T, Type_WORD>) return &m_WORD;
+    else if constexpr (std::is_same_v<T, Type_SHORT>) return &m_SHORT;
+    else if constexpr (std::is_same_v<T, Type_DWORD>) return &m_DWORD;
+    else if constexpr (std::is_same_v<T, Type_INT>) return &m_INT;
+    else if constexpr (std::is_same_v<T, Type_DWORD64>) return &m_DWORD64;
+    else if constexpr (std::is_same_v<T, Type_INT64>) return &m_INT64;
+    else if constexpr (std::is_same_v<T, Type_FLOAT>) return &m_FLOAT;
+    else if constexpr (std::is_same_v<T, Type_DOUBLE>) return &m_DOUBLE;
+    else return static_cast<T const*>(m_Complex);
+}
+
+template <typename T>
+T* GffFieldValue::Get()
+{
+    return const_cast<T*>(static_cast<GffFieldValue const*>(this)->Get<T>());
+}
+
+}
+
+namespace std {
+
+template <>
+struct hash<FileFormats::Gff::Friendly::GffFieldLabel>
+{
+    std::size_t operator()(FileFormats::Gff::Friendly::GffFieldLabel const& label) const
+    {
+        return label.GetHash();
+    }
 };
 
 }
@@ -0,0 +1,1681 @@
+#include "FileFormats/Gff/Gff_Json.hpp"
+#include "FileFormats/Gff/Gff_Builder.hpp"
+#include "Utility/Assert.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define GFF_JSON_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define GFF_JSON_SSE2 0
+#endif
+
+#if CMP_MSVC
+    #include <intrin.h>
+#endif
+
+namespace FileFormats::Gff::Json {
+
+namespace {
+
+// Structs and lists can only nest so deep in a well formed file. This keeps malformed JSON from exhausting the stack.
+constexpr std::uint32_t MaxJsonDepth = 128;
+
+// Indexed by Raw::GffField::Type.
+constexpr std::string_view TypeNames[] =
+{
+    "byte", "char", "word", "short", "dword", "int", "dword64", "int64",
+    "float", "double", "cexostring", "resref", "cexolocstring", "void", "struct", "list"
+};
+
+constexpr char Base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#if GFF_JSON_SSE2
+std::uint32_t CountTrailingZeros(std::uint32_t mask)
+{
+#if CMP_MSVC
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+// Returns the first character which can't be written into a JSON string as is - a quote, a backslash, a control
+// character or anything outside of ASCII - or end if there is none. Checks sixteen characters at a time where it can.
+char const* FindCharacterToEscape(char const* ptr, char const* end)
+{
+#if GFF_JSON_SSE2
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const space = _mm_set1_epi8(' ');
+
+    for (; end - ptr >= 16; ptr += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr));
+
+        // The comparison is signed, so anything from 0x80 upwards is less than a space too.
+        __m128i special = _mm_or_si128(_mm_cmplt_epi8(chunk, space),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+
+        std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(special));
+        if (mask)
+        {
+            return ptr + CountTrailingZeros(mask);
+        }
+    }
+#endif
+
+    for (; ptr < end; ++ptr)
+    {
+        unsigned char c = static_cast<unsigned char>(*ptr);
+        if (c < 0x20 || c >= 0x80 || c == '"' || c == '\\')
+        {
+            break;
+        }
+    }
+
+    return ptr;
+}
+
+// Returns the first quote or backslash, or end if there is none.
+char const* FindEndOfStringRun(char const* ptr, char const* end)
+{
+#if GFF_JSON_SSE2
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+
+    for (; end - ptr >= 16; ptr += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+
+        std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(special));
+        if (mask)
+        {
+            return ptr + CountTrailingZeros(mask);
+        }
+    }
+#endif
+
+    while (ptr < end && *ptr != '"' && *ptr != '\\')
+    {
+        ++ptr;
+    }
+
+    return ptr;
+}
+
+void AppendString(std::string& out, std::string_view string)
+{
+    static constexpr char HexDigits[] = "0123456789ABCDEF";
+
+    out += '"';
+
+    char const* ptr = string.data();
+    char const* end = ptr + string.size();
+
+    while (ptr < end)
+    {
+        char const* special = FindCharacterToEscape(ptr, end);
+        out.append(ptr, special);
+
+        if (special == end)
+        {
+            break;
+        }
+
+        unsigned char c = static_cast<unsigned char>(*special);
+
+        switch (c)
+        {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+
+            default:
+            {
+                char escape[] = { '\\', 'u', '0', '0', HexDigits[c >> 4], HexDigits[c & 0xF] };
+                out.append(escape, sizeof(escape));
+                break;
+            }
+        }
+
+        ptr = special + 1;
+    }
+
+    out += '"';
+}
+
+template <typename T>
+void AppendNumber(std::string& out, T value)
+{
+    char buffer[24];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+template <typename T>
+void AppendFloatingPoint(std::string& out, T value)
+{
+    if (std::isnan(value))
+    {
+        out += "\"NaN\"";
+    }
+    else if (std::isinf(value))
+    {
+        out += value < 0 ? "\"-Infinity\"" : "\"Infinity\"";
+    }
+    else
+    {
+        // With no precision given, this is the shortest representation which reads back as exactly the same value.
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+}
+
+void AppendBase64(std::string& out, Span<std::byte const> data)
+{
+    std::size_t start = out.size();
+    out.resize(start + 2 + (data.size() + 2) / 3 * 4);
+
+    char* ptr = &out[start];
+    *ptr++ = '"';
+
+    std::size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3)
+    {
+        std::uint32_t bits = (std::to_integer<std::uint32_t>(data[i]) << 16) |
+            (std::to_integer<std::uint32_t>(data[i + 1]) << 8) | std::to_integer<std::uint32_t>(data[i + 2]);
+
+        *ptr++ = Base64Alphabet[(bits >> 18) & 0x3F];
+        *ptr++ = Base64Alphabet[(bits >> 12) & 0x3F];
+        *ptr++ = Base64Alphabet[(bits >> 6) & 0x3F];
+        *ptr++ = Base64Alphabet[bits & 0x3F];
+    }
+
+    if (std::size_t remaining = data.size() - i)
+    {
+        std::uint32_t bits = std::to_integer<std::uint32_t>(data[i]) << 16;
+        if (remaining == 2)
+        {
+            bits |= std::to_integer<std::uint32_t>(data[i + 1]) << 8;
+        }
+
+        *ptr++ = Base64Alphabet[(bits >> 18) & 0x3F];
+        *ptr++ = Base64Alphabet[(bits >> 12) & 0x3F];
+        *ptr++ = remaining == 2 ? Base64Alphabet[(bits >> 6) & 0x3F] : '=';
+        *ptr++ = '=';
+    }
+
+    *ptr++ = '"';
+    ASSERT(ptr == out.data() + out.size());
+}
+
+// Writes the events of a GFF into a string, one field per line.
+class JsonWriter : public Raw::GffEventHandler
+{
+public:
+    JsonWriter(Raw::GffHeader const& header, std::string* out);
+
+    bool BeginStruct(std::string_view label, std::uint32_t id) override;
+    void EndStruct() override;
+    bool BeginList(std::string_view label, std::uint32_t count) override;
+    void EndList() override;
+
+    void OnBYTE(std::string_view label, Raw::GffField::Type_BYTE value) override;
+    void OnCHAR(std::string_view label, Raw::GffField::Type_CHAR value) override;
+    void OnWORD(std::string_view label, Raw::GffField::Type_WORD value) override;
+    void OnSHORT(std::string_view label, Raw::GffField::Type_SHORT value) override;
+    void OnDWORD(std::string_view label, Raw::GffField::Type_DWORD value) override;
+    void OnINT(std::string_view label, Raw::GffField::Type_INT value) override;
+    void OnDWORD64(std::string_view label, Raw::GffField::Type_DWORD64 value) override;
+    void OnINT64(std::string_view label, Raw::GffField::Type_INT64 value) override;
+    void OnFLOAT(std::string_view label, Raw::GffField::Type_FLOAT value) override;
+    void OnDOUBLE(std::string_view label, Raw::GffField::Type_DOUBLE value) override;
+    void OnCExoString(std::string_view label, std::string_view value) override;
+    void OnResRef(std::string_view label, std::string_view value) override;
+    void OnVOID(std::string_view label, Span<std::byte const> value) override;
+    void OnCExoLocString(std::string_view label, std::uint32_t stringRef, std::uint32_t subStringCount) override;
+    void OnLocSubString(std::int32_t stringId, std::string_view value) override;
+
+private:
+    enum class Container : std::uint8_t
+    {
+        TopLevelStruct,
+        StructField,
+        ListElement,
+        List
+    };
+
+    // Starts a new line at the current depth, then writes "label": {"type": "type", "value": and leaves the
+    // field open for the value.
+    void BeginField(std::string_view label, Raw::GffField::Type type);
+
+    void NewLine();
+
+    std::string& m_Out;
+    char m_FileType[4];
+
+    // The containers currently open, innermost last, and how many levels the current line is indented by.
+    std::vector<Container> m_Open;
+    std::uint32_t m_Depth = 0;
+
+    // Whether an element has been written into each open list yet, innermost last.
+    std::vector<bool> m_ListHasElements;
+
+    // The substrings of the current CExoLocString still to come, and whether the object has any members so far.
+    std::uint32_t m_SubStringsLeft = 0;
+    bool m_LocStringHasMembers = false;
+};
+
+JsonWriter::JsonWriter(Raw::GffHeader const& header, std::string* out) : m_Out(*out)
+{
+    std::memcpy(m_FileType, header.m_FileType, sizeof(m_FileType));
+}
+
+bool JsonWriter::BeginStruct(std::string_view label, std::uint32_t id)
+{
+    if (m_Open.empty())
+    {
+        m_Out += "{";
+        m_Open.push_back(Container::TopLevelStruct);
+        ++m_Depth;
+
+        NewLine();
+        m_Out += "\"__data_type\": ";
+        AppendString(m_Out, std::string_view(m_FileType, sizeof(m_FileType)));
+        m_Out += ',';
+    }
+    else if (m_Open.back() == Container::List)
+    {
+        if (m_ListHasElements.back())
+        {
+            m_Out += ',';
+        }
+
+        m_ListHasElements.back() = true;
+        NewLine();
+        m_Out += '{';
+        m_Open.push_back(Container::ListElement);
+        ++m_Depth;
+    }
+    else
+    {
+        BeginField(label, Raw::GffField::Type::Struct);
+        m_Out += '{';
+        m_Open.push_back(Container::StructField);
+        ++m_Depth;
+    }
+
+    // Every struct starts with its ID, so every field after it is preceded by a comma.
+    NewLine();
+    m_Out += "\"__struct_id\": ";
+    AppendNumber(m_Out, id);
+    return true;
+}
+
+void JsonWriter::EndStruct()
+{
+    Container container = m_Open.back();
+    m_Open.pop_back();
+    --m_Depth;
+
+    NewLine();
+
+    switch (container)
+    {
+        case Container::TopLevelStruct: m_Out += "}\n"; break;
+        case Container::StructField: m_Out += "}}"; break;
+        default: m_Out += '}'; break;
+    }
+}
+
+bool JsonWriter::BeginList(std::string_view label, std::uint32_t /*count*/)
+{
+    BeginField(label, Raw::GffField::Type::List);
+    m_Out += '[';
+    m_Open.push_back(Container::List);
+    ++m_Depth;
+    m_ListHasElements.push_back(false);
+    return true;
+}
+
+void JsonWriter::EndList()
+{
+    m_Open.pop_back();
+    --m_Depth;
+
+    if (m_ListHasElements.back())
+    {
+        NewLine();
+    }
+
+    m_ListHasElements.pop_back();
+
+    m_Out += "]}";
+}
+
+void JsonWriter::OnBYTE(std::string_view label, Raw::GffField::Type_BYTE value)
+{
+    BeginField(label, Raw::GffField::Type::BYTE);
+    AppendNumber(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnCHAR(std::string_view label, Raw::GffField::Type_CHAR value)
+{
+    BeginField(label, Raw::GffField::Type::CHAR);
+    AppendNumber(m_Out, static_cast<signed char>(value));
+    m_Out += '}';
+}
+
+void JsonWriter::OnWORD(std::string_view label, Raw::GffField::Type_WORD value)
+{
+    BeginField(label, Raw::GffField::Type::WORD);
+    AppendNumber(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnSHORT(std::string_view label, Raw::GffField::Type_SHORT value)
+{
+    BeginField(label, Raw::GffField::Type::SHORT);
+    AppendNumber(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnDWORD(std::string_view label, Raw::GffField::Type_DWORD value)
+{
+    BeginField(label, Raw::GffField::Type::DWORD);
+    AppendNumber(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnINT(std::string_view label, Raw::GffField::Type_INT value)
+{
+    BeginField(label, Raw::GffField::Type::INT);
+    AppendNumber(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnDWORD64(std::string_view label, Raw::GffField::Type_DWORD64 value)
+{
+    BeginField(label, Raw::GffField::Type::DWORD64);
+    AppendNumber(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnINT64(std::string_view label, Raw::GffField::Type_INT64 value)
+{
+    BeginField(label, Raw::GffField::Type::INT64);
+    AppendNumber(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnFLOAT(std::string_view label, Raw::GffField::Type_FLOAT value)
+{
+    BeginField(label, Raw::GffField::Type::FLOAT);
+    AppendFloatingPoint(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnDOUBLE(std::string_view label, Raw::GffField::Type_DOUBLE value)
+{
+    BeginField(label, Raw::GffField::Type::DOUBLE);
+    AppendFloatingPoint(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnCExoString(std::string_view label, std::string_view value)
+{
+    BeginField(label, Raw::GffField::Type::CExoString);
+    AppendString(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnResRef(std::string_view label, std::string_view value)
+{
+    BeginField(label, Raw::GffField::Type::ResRef);
+    AppendString(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnVOID(std::string_view label, Span<std::byte const> value)
+{
+    BeginField(label, Raw::GffField::Type::VOID);
+    AppendBase64(m_Out, value);
+    m_Out += '}';
+}
+
+void JsonWriter::OnCExoLocString(std::string_view label, std::uint32_t stringRef, std::uint32_t subStringCount)
+{
+    BeginField(label, Raw::GffField::Type::CExoLocString);
+    m_Out += '{';
+
+    m_LocStringHasMembers = stringRef != 0xFFFFFFFF;
+    if (m_LocStringHasMembers)
+    {
+        m_Out += "\"id\": ";
+        AppendNumber(m_Out, stringRef);
+    }
+
+    m_SubStringsLeft = subStringCount;
+    if (!m_SubStringsLeft)
+    {
+        m_Out += "}}";
+    }
+}
+
+void JsonWriter::OnLocSubString(std::int32_t stringId, std::string_view value)
+{
+    ASSERT(m_SubStringsLeft);
+
+    if (m_LocStringHasMembers)
+    {
+        m_Out += ", ";
+    }
+
+    m_LocStringHasMembers = true;
+
+    m_Out += '"';
+    AppendNumber(m_Out, stringId);
+    m_Out += "\": ";
+    AppendString(m_Out, value);
+
+    if (!--m_SubStringsLeft)
+    {
+        m_Out += "}}";
+    }
+}
+
+void JsonWriter::BeginField(std::string_view label, Raw::GffField::Type type)
+{
+    std::uint32_t typeIndex = static_cast<std::uint32_t>(type);
+    ASSERT(typeIndex < sizeof(TypeNames) / sizeof(TypeNames[0]));
+
+    m_Out += ',';
+    NewLine();
+    AppendString(m_Out, label);
+    m_Out += ": {\"type\": \"";
+    m_Out += TypeNames[typeIndex];
+    m_Out += "\", \"value\": ";
+}
+
+void JsonWriter::NewLine()
+{
+    m_Out += '\n';
+    m_Out.append(m_Depth * 2, ' ');
+}
+
+template <typename RawGff>
+bool WriteGffToJsonInternal(RawGff const& gff, std::string* out)
+{
+    ASSERT(out);
+
+    // Most of the output is field names and types, plus the field data for strings.
+    out->reserve(out->size() + gff.m_Fields.size() * 48 + gff.m_FieldData.size() * 2);
+
+    JsonWriter writer(gff.m_Header, out);
+    return gff.ReadEvents(&writer);
+}
+
+void AppendValue(std::string& out, Friendly::GffFieldValue const& value);
+
+// Writes a friendly struct in the same form as a struct field's value, but on a single line.
+void AppendStruct(std::string& out, Friendly::GffStruct const& gffStruct)
+{
+    out += "{\"__struct_id\": ";
+    AppendNumber(out, gffStruct.GetUserDefinedId());
+
+    for (Friendly::GffStruct::FieldMap::value_type const& kvp : gffStruct.GetFields())
+    {
+        out += ", ";
+        AppendString(out, kvp.first.GetString());
+        out += ": ";
+        AppendValue(out, kvp.second);
+    }
+
+    out += '}';
+}
+
+void AppendValue(std::string& out, Friendly::GffFieldValue const& value)
+{
+    std::uint32_t typeIndex = static_cast<std::uint32_t>(value.GetType());
+    ASSERT(typeIndex < sizeof(TypeNames) / sizeof(TypeNames[0]));
+
+    out += "{\"type\": \"";
+    out += TypeNames[typeIndex];
+    out += "\", \"value\": ";
+
+    Friendly::Visit(value, [&out](auto const& v)
+    {
+        using T = std::decay_t<decltype(v)>;
+
+        if constexpr (std::is_same_v<T, Friendly::Type_CHAR>)
+        {
+            AppendNumber(out, static_cast<signed char>(v));
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            AppendFloatingPoint(out, v);
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            AppendNumber(out, v);
+        }
+        else if constexpr (std::is_same_v<T, Friendly::Type_CExoString>)
+        {
+            AppendString(out, v.m_String);
+        }
+        else if constexpr (std::is_same_v<T, Friendly::Type_CResRef>)
+        {
+            ASSERT(v.m_Size <= sizeof(v.m_String));
+            AppendString(out, std::string_view(v.m_String, v.m_Size));
+        }
+        else if constexpr (std::is_same_v<T, Friendly::Type_CExoLocString>)
+        {
+            out += '{';
+            bool hasMembers = v.m_StringRef != 0xFFFFFFFF;
+
+            if (hasMembers)
+            {
+                out += "\"id\": ";
+                AppendNumber(out, v.m_StringRef);
+            }
+
+            for (Friendly::Type_CExoLocString::SubString const& substring : v.m_SubStrings)
+            {
+                out += hasMembers ? ", \"" : "\"";
+                hasMembers = true;
+                AppendNumber(out, substring.m_StringID);
+                out += "\": ";
+                AppendString(out, substring.m_String);
+            }
+
+            out += '}';
+        }
+        else if constexpr (std::is_same_v<T, Friendly::Type_VOID>)
+        {
+            AppendBase64(out, Span<std::byte const> { v.m_Data.data(), v.m_Data.size() });
+        }
+        else if constexpr (std::is_same_v<T, Friendly::Type_Struct>)
+        {
+            AppendStruct(out, v);
+        }
+        else
+        {
+            static_assert(std::is_same_v<T, Friendly::Type_List>);
+            out += '[';
+
+            bool first = true;
+            for (Friendly::GffStruct const& element : v.GetStructs())
+            {
+                out += first ? "" : ", ";
+                first = false;
+                AppendStruct(out, element);
+            }
+
+            out += ']';
+        }
+    });
+
+    out += '}';
+}
+
+void AppendPathSegment(std::string& out, Friendly::GffEditPathSegment const& segment)
+{
+    if (segment.m_FromIndex == Friendly::GffEditPathSegment::NoElement &&
+        segment.m_ToIndex == Friendly::GffEditPathSegment::NoElement)
+    {
+        AppendString(out, segment.m_Label.GetString());
+        return;
+    }
+
+    out += "{\"field\": ";
+    AppendString(out, segment.m_Label.GetString());
+
+    if (segment.m_FromIndex != Friendly::GffEditPathSegment::NoElement)
+    {
+        out += ", \"from\": ";
+        AppendNumber(out, segment.m_FromIndex);
+    }
+
+    if (segment.m_ToIndex != Friendly::GffEditPathSegment::NoElement)
+    {
+        out += ", \"to\": ";
+        AppendNumber(out, segment.m_ToIndex);
+    }
+
+    if (!segment.m_Key.empty())
+    {
+        out += ", \"key\": {";
+
+        bool first = true;
+        for (auto const& key : segment.m_Key)
+        {
+            out += first ? "" : ", ";
+            first = false;
+            AppendString(out, key.first.GetString());
+            out += ": ";
+            AppendValue(out, key.second);
+        }
+
+        out += '}';
+    }
+
+    out += '}';
+}
+
+// Parses JSON straight into a GffBuilder. The cursor only moves forwards except to look ahead for a struct ID or
+// field type which isn't where the writer puts it.
+class JsonReader
+{
+public:
+    explicit JsonReader(std::string_view json);
+
+    bool Read(Raw::Gff* out);
+
+private:
+    void SkipWhitespace();
+
+    // These skip any whitespace before the character.
+    bool Consume(char c);
+    bool Peek(char c);
+
+    // Parses "key": leaving the cursor on the value.
+    bool ParseKey(std::string_view* out);
+
+    // Parses the members of an object after its '{', calling parseMember(key) with the cursor on each value.
+    template <typename ParseMember>
+    bool ParseMembers(ParseMember&& parseMember);
+
+    // As above, except after the first member, so each member is preceded by a comma.
+    template <typename ParseMember>
+    bool ParseMoreMembers(ParseMember&& parseMember);
+
+    // Finds the member called name in the object after the cursor, which is just after its '{', and parses its value
+    // with parseValue. If it is the first member - as it is in anything the writer wrote - the cursor is left after it
+    // and first is true. Otherwise, the rest of the object is searched and the cursor is left where it was.
+    // found is false if there is no such member.
+    template <typename ParseValue>
+    bool FindMember(std::string_view name, ParseValue&& parseValue, bool* found, bool* first);
+
+    bool SkipValue(std::uint32_t depth);
+
+    // The view points either into the JSON or, if the string contained escapes, into m_Unescaped - in which case
+    // it is only valid until the next string is parsed.
+    bool ParseString(std::string_view* out);
+
+    bool ParseNumber(std::string_view* out);
+
+    template <typename T>
+    bool ParseInteger(T* out);
+
+    template <typename T>
+    bool ParseFloatingPoint(T* out);
+
+    bool ParseType(Raw::GffField::Type* out);
+
+    // Parses a struct object, including its ID, into the builder. A struct without a label is a list element.
+    bool ParseStruct(Friendly::GffFieldLabel const* label, std::uint32_t depth);
+
+    // GffBuilder doesn't check that labels are unique within a struct, so the reader does: each struct's labels are
+    // collected as its fields are parsed, then checked once it ends. Returns false if any label is repeated.
+    void BeginStructLabels();
+    bool EndStructLabels();
+
+    bool ParseField(std::string_view label, std::uint32_t depth);
+    bool ParseFieldValue(Friendly::GffFieldLabel const& label, Raw::GffField::Type type, std::uint32_t depth);
+    bool ParseLocString(Friendly::GffFieldLabel const& label);
+    bool ParseVoid(Friendly::GffFieldLabel const& label);
+
+    char const* m_Ptr;
+    char const* m_End;
+
+    Friendly::GffBuilder m_Builder;
+
+    // The labels of every open struct, back to back, and where each struct's labels start, innermost last.
+    std::vector<Friendly::GffFieldLabel> m_Labels;
+    std::vector<std::size_t> m_LabelsStart;
+
+    // Reused between fields, so the strings keep their capacity.
+    std::string m_Unescaped;
+    Friendly::Type_CExoString m_String;
+    Friendly::Type_CExoLocString m_LocString;
+    Friendly::Type_VOID m_Void;
+};
+
+JsonReader::JsonReader(std::string_view json)
+    : m_Ptr(json.data()), m_End(json.data() + json.size()), m_Builder("    ")
+{ }
+
+bool JsonReader::Read(Raw::Gff* out)
+{
+    char fileType[4];
+    std::memcpy(fileType, "    ", sizeof(fileType));
+    std::uint32_t topLevelStructId = 0xFFFFFFFF;
+
+    if (!Consume('{'))
+    {
+        return false;
+    }
+
+    BeginStructLabels();
+
+    bool parsed = ParseMembers([&](std::string_view key)
+    {
+        if (key == "__data_type")
+        {
+            std::string_view type;
+            if (!ParseString(&type) || type.size() != sizeof(fileType))
+            {
+                return false;
+            }
+
+            std::memcpy(fileType, type.data(), sizeof(fileType));
+            return true;
+        }
+
+        if (key == "__struct_id")
+        {
+            return ParseInteger(&topLevelStructId);
+        }
+
+        return ParseField(key, 0);
+    });
+
+    if (!parsed || !EndStructLabels())
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (m_Ptr != m_End)
+    {
+        return false;
+    }
+
+    // The builder always begins with the top level struct open, so its type and ID are only known at the end.
+    m_Builder.Finish(out);
+    std::memcpy(out->m_Header.m_FileType, fileType, sizeof(fileType));
+    out->m_Structs[0].m_Type = topLevelStructId;
+    return true;
+}
+
+bool JsonReader::Consume(char c)
+{
+    if (!Peek(c))
+    {
+        return false;
+    }
+
+    ++m_Ptr;
+    return true;
+}
+
+bool JsonReader::Peek(char c)
+{
+    SkipWhitespace();
+    return m_Ptr < m_End && *m_Ptr == c;
+}
+
+void JsonReader::SkipWhitespace()
+{
+    while (m_Ptr < m_End && (*m_Ptr == ' ' || *m_Ptr == '\n' || *m_Ptr == '\r' || *m_Ptr == '\t'))
+    {
+        ++m_Ptr;
+    }
+}
+
+bool JsonReader::ParseKey(std::string_view* out)
+{
+    return ParseString(out) && Consume(':');
+}
+
+template <typename ParseMember>
+bool JsonReader::ParseMembers(ParseMember&& parseMember)
+{
+    if (Consume('}'))
+    {
+        return true;
+    }
+
+    std::string_view key;
+    return ParseKey(&key) && parseMember(key) && ParseMoreMembers(parseMember);
+}
+
+template <typename ParseMember>
+bool JsonReader::ParseMoreMembers(ParseMember&& parseMember)
+{
+    while (!Consume('}'))
+    {
+        std::string_view key;
+        if (!Consume(',') || !ParseKey(&key) || !parseMember(key))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename ParseValue>
+bool JsonReader::FindMember(std::string_view name, ParseValue&& parseValue, bool* found, bool* first)
+{
+    char const* start = m_Ptr;
+    *found = false;
+    *first = false;
+
+    if (Peek('"'))
+    {
+        std::string_view key;
+        if (!ParseKey(&key))
+        {
+            return false;
+        }
+
+        if (key == name)
+        {
+            *found = true;
+            *first = true;
+            return parseValue();
+        }
+
+        m_Ptr = start;
+    }
+
+    // Stop as soon as the member has been found.
+    bool parsed = ParseMembers([&](std::string_view key)
+    {
+        if (key != name)
+        {
+            return SkipValue(0);
+        }
+
+        *found = true;
+        return false;
+    });
+
+    if (*found)
+    {
+        parsed = parseValue();
+    }
+
+    m_Ptr = start;
+    return parsed;
+}
+
+bool JsonReader::SkipValue(std::uint32_t depth)
+{
+    if (depth > MaxJsonDepth)
+    {
+        return false;
+    }
+
+    if (Peek('"'))
+    {
+        std::string_view string;
+        return ParseString(&string);
+    }
+
+    if (Consume('{'))
+    {
+        return ParseMembers([this, depth](std::string_view) { return SkipValue(depth + 1); });
+    }
+
+    if (Consume('['))
+    {
+        if (Consume(']'))
+        {
+            return true;
+        }
+
+        do
+        {
+            if (!SkipValue(depth + 1))
+            {
+                return false;
+            }
+        } while (Consume(','));
+
+        return Consume(']');
+    }
+
+    // A number, true, false or null.
+    std::string_view token;
+    return ParseNumber(&token);
+}
+
+bool JsonReader::ParseString(std::string_view* out)
+{
+    if (!Consume('"'))
+    {
+        return false;
+    }
+
+    char const* start = m_Ptr;
+    char const* special = FindEndOfStringRun(m_Ptr, m_End);
+
+    if (special == m_End)
+    {
+        return false;
+    }
+
+    if (*special == '"')
+    {
+        *out = std::string_view(start, special - start);
+        m_Ptr = special + 1;
+        return true;
+    }
+
+    // The string contains escapes, so it has to be copied out.
+    m_Unescaped.assign(start, special);
+    m_Ptr = special;
+
+    while (true)
+    {
+        if (m_Ptr == m_End)
+        {
+            return false;
+        }
+
+        if (*m_Ptr == '"')
+        {
+            ++m_Ptr;
+            break;
+        }
+
+        if (*m_Ptr != '\\')
+        {
+            special = FindEndOfStringRun(m_Ptr, m_End);
+            m_Unescaped.append(m_Ptr, special);
+            m_Ptr = special;
+            continue;
+        }
+
+        if (m_End - m_Ptr < 2)
+        {
+            return false;
+        }
+
+        char escape = m_Ptr[1];
+        m_Ptr += 2;
+
+        switch (escape)
+        {
+            case '"': m_Unescaped += '"'; break;
+            case '\\': m_Unescaped += '\\'; break;
+            case '/': m_Unescaped += '/'; break;
+            case 'b': m_Unescaped += '\b'; break;
+            case 'f': m_Unescaped += '\f'; break;
+            case 'n': m_Unescaped += '\n'; break;
+            case 'r': m_Unescaped += '\r'; break;
+            case 't': m_Unescaped += '\t'; break;
+
+            case 'u':
+            {
+                auto parseCodeUnit = [this](std::uint32_t* codeUnit)
+                {
+                    if (m_End - m_Ptr < 4 || std::from_chars(m_Ptr, m_Ptr + 4, *codeUnit, 16).ptr != m_Ptr + 4)
+                    {
+                        return false;
+                    }
+
+                    m_Ptr += 4;
+                    return true;
+                };
+
+                std::uint32_t codePoint = 0;
+                if (!parseCodeUnit(&codePoint))
+                {
+                    return false;
+                }
+
+                // Up to 0xFF is a single byte, as written by WriteGffToJson. Anything else is encoded as UTF-8.
+                if (codePoint <= 0xFF)
+                {
+                    m_Unescaped += static_cast<char>(codePoint);
+                    break;
+                }
+
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+                {
+                    std::uint32_t low = 0;
+                    if (m_End - m_Ptr < 2 || m_Ptr[0] != '\\' || m_Ptr[1] != 'u')
+                    {
+                        return false;
+                    }
+
+                    m_Ptr += 2;
+                    if (!parseCodeUnit(&low) || low < 0xDC00 || low > 0xDFFF)
+                    {
+                        return false;
+                    }
+
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                if (codePoint < 0x800)
+                {
+                    m_Unescaped += static_cast<char>(0xC0 | (codePoint >> 6));
+                }
+                else if (codePoint < 0x10000)
+                {
+                    m_Unescaped += static_cast<char>(0xE0 | (codePoint >> 12));
+                    m_Unescaped += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                }
+                else
+                {
+                    m_Unescaped += static_cast<char>(0xF0 | (codePoint >> 18));
+                    m_Unescaped += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                    m_Unescaped += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                }
+
+                m_Unescaped += static_cast<char>(0x80 | (codePoint & 0x3F));
+                break;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    *out = m_Unescaped;
+    return true;
+}
+
+bool JsonReader::ParseNumber(std::string_view* out)
+{
+    SkipWhitespace();
+
+    char const* start = m_Ptr;
+    while (m_Ptr < m_End && *m_Ptr != ',' && *m_Ptr != '}' && *m_Ptr != ']' &&
+        *m_Ptr != ' ' && *m_Ptr != '\n' && *m_Ptr != '\r' && *m_Ptr != '\t')
+    {
+        ++m_Ptr;
+    }
+
+    *out = std::string_view(start, m_Ptr - start);
+    return !out->empty();
+}
+
+template <typename T>
+bool JsonReader::ParseInteger(T* out)
+{
+    std::string_view token;
+    if (!ParseNumber(&token))
+    {
+        return false;
+    }
+
+    // Parse at full width, so that out of range values are rejected rather than wrapped.
+    using Wide = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+    Wide value;
+
+    std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size() ||
+        value < static_cast<Wide>(std::numeric_limits<T>::min()) || value > static_cast<Wide>(std::numeric_limits<T>::max()))
+    {
+        return false;
+    }
+
+    *out = static_cast<T>(value);
+    return true;
+}
+
+template <typename T>
+bool JsonReader::ParseFloatingPoint(T* out)
+{
+    if (Peek('"'))
+    {
+        std::string_view special;
+        if (!ParseString(&special))
+        {
+            return false;
+        }
+
+        if (special == "NaN")
+        {
+            *out = std::numeric_limits<T>::quiet_NaN();
+        }
+        else if (special == "Infinity")
+        {
+            *out = std::numeric_limits<T>::infinity();
+        }
+        else if (special == "-Infinity")
+        {
+            *out = -std::numeric_limits<T>::infinity();
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string_view token;
+    if (!ParseNumber(&token))
+    {
+        return false;
+    }
+
+    std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), *out);
+    return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+bool JsonReader::ParseType(Raw::GffField::Type* out)
+{
+    std::string_view name;
+    if (!ParseString(&name))
+    {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < sizeof(TypeNames) / sizeof(TypeNames[0]); ++i)
+    {
+        if (name == TypeNames[i])
+        {
+            *out = static_cast<Raw::GffField::Type>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JsonReader::ParseStruct(Friendly::GffFieldLabel const* label, std::uint32_t depth)
+{
+    if (depth > MaxJsonDepth || !Consume('{'))
+    {
+        return false;
+    }
+
+    std::uint32_t id = 0;
+    bool found;
+    bool first;
+
+    if (!FindMember("__struct_id", [this, &id]() { return ParseInteger(&id); }, &found, &first))
+    {
+        return false;
+    }
+
+    if (label)
+    {
+        m_Builder.BeginStruct(*label, id);
+    }
+    else
+    {
+        m_Builder.BeginStruct(id);
+    }
+
+    BeginStructLabels();
+
+    auto parseMember = [this, depth](std::string_view key)
+    {
+        return key == "__struct_id" ? SkipValue(depth) : ParseField(key, depth);
+    };
+
+    bool parsed = first ? ParseMoreMembers(parseMember) : ParseMembers(parseMember);
+
+    if (!parsed || !EndStructLabels())
+    {
+        return false;
+    }
+
+    m_Builder.EndStruct();
+    return true;
+}
+
+void JsonReader::BeginStructLabels()
+{
+    m_LabelsStart.push_back(m_Labels.size());
+}
+
+bool JsonReader::EndStructLabels()
+{
+    ASSERT(!m_LabelsStart.empty());
+
+    auto begin = std::begin(m_Labels) + m_LabelsStart.back();
+    m_LabelsStart.pop_back();
+
+    // Sorting rather than searching as each label is added keeps a struct with thousands of fields cheap to check.
+    std::sort(begin, std::end(m_Labels));
+    bool unique = std::adjacent_find(begin, std::end(m_Labels)) == std::end(m_Labels);
+
+    m_Labels.erase(begin, std::end(m_Labels));
+    return unique;
+}
+
+bool JsonReader::ParseField(std::string_view key, std::uint32_t depth)
+{
+    if (key.empty() || key.size() > 16)
+    {
+        return false;
+    }
+
+    Friendly::GffFieldLabel label(key);
+    m_Labels.push_back(label);
+
+    if (!Consume('{'))
+    {
+        return false;
+    }
+
+    Raw::GffField::Type type;
+    bool found;
+    bool first;
+
+    if (!FindMember("type", [this, &type]() { return ParseType(&type); }, &found, &first) || !found)
+    {
+        return false;
+    }
+
+    bool hasValue = false;
+
+    auto parseMember = [&](std::string_view member)
+    {
+        if (member == "type")
+        {
+            return SkipValue(depth);
+        }
+
+        if (member == "value" && !hasValue)
+        {
+            hasValue = true;
+            return ParseFieldValue(label, type, depth);
+        }
+
+        return false;
+    };
+
+    bool parsed = first ? ParseMoreMembers(parseMember) : ParseMembers(parseMember);
+    return parsed && hasValue;
+}
+
+bool JsonReader::ParseFieldValue(Friendly::GffFieldLabel const& label, Raw::GffField::Type type, std::uint32_t depth)
+{
+    switch (type)
+    {
+        case Raw::GffField::Type::BYTE:
+        {
+            Friendly::Type_BYTE value;
+            if (!ParseInteger(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::CHAR:
+        {
+            signed char value;
+            if (!ParseInteger(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, static_cast<Friendly::Type_CHAR>(value));
+            return true;
+        }
+
+        case Raw::GffField::Type::WORD:
+        {
+            Friendly::Type_WORD value;
+            if (!ParseInteger(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::SHORT:
+        {
+            Friendly::Type_SHORT value;
+            if (!ParseInteger(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::DWORD:
+        {
+            Friendly::Type_DWORD value;
+            if (!ParseInteger(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::INT:
+        {
+            Friendly::Type_INT value;
+            if (!ParseInteger(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::DWORD64:
+        {
+            Friendly::Type_DWORD64 value;
+            if (!ParseInteger(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::INT64:
+        {
+            Friendly::Type_INT64 value;
+            if (!ParseInteger(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::FLOAT:
+        {
+            Friendly::Type_FLOAT value;
+            if (!ParseFloatingPoint(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::DOUBLE:
+        {
+            Friendly::Type_DOUBLE value;
+            if (!ParseFloatingPoint(&value))
+            {
+                return false;
+            }
+
+            m_Builder.AddField(label, value);
+            return true;
+        }
+
+        case Raw::GffField::Type::CExoString:
+        {
+            std::string_view value;
+            if (!ParseString(&value))
+            {
+                return false;
+            }
+
+            m_String.m_String.assign(value.data(), value.size());
+            m_Builder.AddField(label, m_String);
+            return true;
+        }
+
+        case Raw::GffField::Type::ResRef:
+        {
+            std::string_view value;
+            if (!ParseString(&value) || value.size() > sizeof(Friendly::Type_CResRef::m_String))
+            {
+                return false;
+            }
+
+            Friendly::Type_CResRef resref = {};
+            resref.m_Size = static_cast<std::uint8_t>(value.size());
+            std::memcpy(resref.m_String, value.data(), value.size());
+            m_Builder.AddField(label, resref);
+            return true;
+        }
+
+        case Raw::GffField::Type::CExoLocString: return ParseLocString(label);
+        case Raw::GffField::Type::VOID: return ParseVoid(label);
+        case Raw::GffField::Type::Struct: return ParseStruct(&label, depth + 1);
+
+        case Raw::GffField::Type::List:
+        {
+            if (!Consume('['))
+            {
+                return false;
+            }
+
+            m_Builder.BeginList(label);
+
+            if (!Consume(']'))
+            {
+                do
+                {
+                    if (!ParseStruct(nullptr, depth + 1))
+                    {
+                        return false;
+                    }
+                } while (Consume(','));
+
+                if (!Consume(']'))
+                {
+                    return false;
+                }
+            }
+
+            m_Builder.EndList();
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+bool JsonReader::ParseLocString(Friendly::GffFieldLabel const& label)
+{
+    if (!Consume('{'))
+    {
+        return false;
+    }
+
+    m_LocString.m_StringRef = 0xFFFFFFFF;
+    std::size_t subStringCount = 0;
+
+    bool parsed = ParseMembers([&](std::string_view key)
+    {
+        if (key == "id")
+        {
+            return ParseInteger(&m_LocString.m_StringRef);
+        }
+
+        std::int32_t stringId = 0;
+        std::from_chars_result result = std::from_chars(key.data(), key.data() + key.size(), stringId);
+        if (result.ec != std::errc() || result.ptr != key.data() + key.size())
+        {
+            return false;
+        }
+
+        std::string_view value;
+        if (!ParseString(&value))
+        {
+            return false;
+        }
+
+        if (subStringCount == m_LocString.m_SubStrings.size())
+        {
+            m_LocString.m_SubStrings.emplace_back();
+        }
+
+        Friendly::Type_CExoLocString::SubString& substring = m_LocString.m_SubStrings[subStringCount++];
+        substring.m_StringID = stringId;
+        substring.m_String.assign(value.data(), value.size());
+        return true;
+    });
+
+    if (!parsed)
+    {
+        return false;
+    }
+
+    m_LocString.m_SubStrings.resize(subStringCount);
+    m_Builder.AddField(label, m_LocString);
+    return true;
+}
+
+bool JsonReader::ParseVoid(Friendly::GffFieldLabel const& label)
+{
+    std::string_view encoded;
+    if (!ParseString(&encoded) || encoded.size() % 4 != 0)
+    {
+        return false;
+    }
+
+    auto decode = [](char c) -> std::uint32_t
+    {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return 0xFF;
+    };
+
+    std::size_t padding = 0;
+    if (!encoded.empty() && encoded.back() == '=') ++padding;
+    if (encoded.size() > 1 && encoded[encoded.size() - 2] == '=') ++padding;
+
+    m_Void.m_Data.resize(encoded.size() / 4 * 3 - padding);
+    std::byte* out = m_Void.m_Data.data();
+
+    for (std::size_t i = 0; i < encoded.size(); i += 4)
+    {
+        bool last = i + 4 == encoded.size();
+        std::uint32_t bits = 0;
+
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            char c = encoded[i + j];
+            std::uint32_t sextet = (last && c == '=' && j >= 4 - padding) ? 0 : decode(c);
+
+            if (sextet == 0xFF)
+            {
+                return false;
+            }
+
+            bits = (bits << 6) | sextet;
+        }
+
+        std::size_t bytes = last ? 3 - padding : 3;
+        for (std::size_t j = 0; j < bytes; ++j)
+        {
+            *out++ = static_cast<std::byte>(bits >> (16 - j * 8));
+        }
+    }
+
+    m_Builder.AddField(label, m_Void);
+    return true;
+}
+
+}
+
+bool WriteGffToJson(Raw::Gff const& gff, std::string* out)
+{
+    return WriteGffToJsonInternal(gff, out);
+}
+
+bool WriteGffToJson(Raw::GffView const& gff, std::string* out)
+{
+    return WriteGffToJsonInternal(gff, out);
+}
+
+bool ReadGffFromJson(std::string_view json, Raw::Gff* out)
+{
+    ASSERT(out);
+
+    JsonReader reader(json);
+    return reader.Read(out);
+}
+
+void WriteValueToJson(Friendly::GffFieldValue const& value, std::string* out)
+{
+    ASSERT(out);
+    AppendValue(*out, value);
+}
+
+void WriteEditScriptToJson(std::vector<Friendly::GffEdit> const& edits, std::string* out)
+{
+    ASSERT(out);
+
+    // Indexed by Friendly::GffEdit::Type.
+    static constexpr std::string_view OpNames[] =
+    {
+        "add_field", "remove_field", "change_field", "add_element", "remove_element", "change_struct_id"
+    };
+
+    *out += '[';
+
+    for (std::size_t i = 0; i < edits.size(); ++i)
+    {
+        Friendly::GffEdit const& edit = edits[i];
+
+        std::uint32_t opIndex = static_cast<std::uint32_t>(edit.m_Type);
+        ASSERT(opIndex < sizeof(OpNames) / sizeof(OpNames[0]));
+
+        *out += i ? ",\n  {\"op\": \"" : "\n  {\"op\": \"";
+        *out += OpNames[opIndex];
+        *out += "\", \"path\": [";
+
+        for (std::size_t j = 0; j < edit.m_Path.size(); ++j)
+        {
+            *out += j ? ", " : "";
+            AppendPathSegment(*out, edit.m_Path[j]);
+        }
+
+        *out += ']';
+
+        bool hasFrom = edit.m_Type != Friendly::GffEdit::Type::AddField && edit.m_Type != Friendly::GffEdit::Type::AddElement;
+        bool hasTo = edit.m_Type != Friendly::GffEdit::Type::RemoveField && edit.m_Type != Friendly::GffEdit::Type::RemoveElement;
+
+        if (hasFrom)
+        {
+            *out += ", \"from\": ";
+            AppendValue(*out, edit.m_From);
+        }
+
+        if (hasTo)
+        {
+            *out += ", \"to\": ";
+            AppendValue(*out, edit.m_To);
+        }
+
+        *out += '}';
+    }
+
+    *out += edits.empty() ? "]\n" : "\n]\n";
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "FileFormats/Gff/Gff_Diff.hpp"
+#include "FileFormats/Gff/Gff_Raw.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FileFormats::Gff::Json {
+
+// Converts between GFF and JSON without a Friendly::Gff in between. GFF to JSON streams the events from
+// Raw::GffView::ReadEvents into a string, and JSON to GFF parses straight into a Friendly::GffBuilder.
+// Both directions are lossless, so a file can be kept as JSON under source control and converted back on build.
+//
+// The top level struct is an object with the file type and struct ID, followed by one member per field in file order:
+//
+//     {
+//       "__data_type": "UTC ",
+//       "__struct_id": 4294967295,
+//       "Tag": {"type": "cexostring", "value": "nw_chicken"},
+//       "FirstName": {"type": "cexolocstring", "value": {"id": 5432, "0": "Chicken"}},
+//       "Inner": {"type": "struct", "value": {
+//         "__struct_id": 7,
+//         "A": {"type": "int", "value": 1}
+//       }},
+//       "VarTable": {"type": "list", "value": [
+//         {
+//           "__struct_id": 0,
+//           "Name": {"type": "cexostring", "value": "x"}
+//         }
+//       ]}
+//     }
+//
+// - The types are byte, char, word, short, dword, int, dword64, int64, float, double, cexostring, resref,
+//   cexolocstring, void, struct and list. Numbers are written exactly: floats and doubles use the shortest form which
+//   reads back to the same bits. NaN and the infinities are written as the strings "NaN", "Infinity" and
+//   "-Infinity" - the payload of a NaN is not kept.
+// - GFF strings are not UTF-8 (the game uses the Windows code pages), so every byte outside printable ASCII is
+//   escaped as \u00XX. Reading maps \u0000 to \u00FF back to single bytes, and encodes anything higher as UTF-8.
+// - A cexolocstring is an object of substrings keyed by string ID, plus "id" for the StrRef if it isn't -1.
+// - Void data is base64.
+//
+// When reading, members may come in any order - but the files are read fastest in the order they are written,
+// with the type of each field and the ID of each struct first.
+
+// Appends the GFF to out as JSON. Returns false if the GFF is malformed, in which case out is incomplete.
+bool WriteGffToJson(Raw::Gff const& gff, std::string* out);
+bool WriteGffToJson(Raw::GffView const& gff, std::string* out);
+
+// Parses the JSON into out. Returns false if the JSON is malformed or does not describe a GFF.
+bool ReadGffFromJson(std::string_view json, Raw::Gff* out);
+
+// Appends a friendly value in the {"type": ..., "value": ...} form of a field above, on a single line.
+void WriteValueToJson(Friendly::GffFieldValue const& value, std::string* out);
+
+// Appends the edits from Friendly::DiffGff as an array with one edit per line:
+//
+//     [
+//       {"op": "change_field", "path": ["Str"], "from": {"type": "byte", "value": 10}, "to": {...}},
+//       {"op": "add_element", "path": [{"field": "VarTable", "to": 3, "key": {"Name": {...}}}], "to": {...}}
+//     ]
+//
+// - op is add_field, remove_field, change_field, add_element, remove_element or change_struct_id, as in GffEdit.
+// - path has a label for each field along the way, or an object for a list element with the index of the element on
+//   either side ("from", "to") and, in a keyed list, the key fields.
+// - from and to are values as written by WriteValueToJson, and are left out of adds and removes respectively. Struct
+//   IDs are dwords.
+void WriteEditScriptToJson(std::vector<Friendly::GffEdit> const& edits, std::string* out);
+
+}
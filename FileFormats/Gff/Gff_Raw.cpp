@@ -1,11 +1,24 @@
 #include "FileFormats/Gff/Gff_Raw.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/FileReader.hpp"
+#include "Utility/FileWriter.hpp"
 #include "Utility/MemoryMappedFile.hpp"
+#include "Utility/RAIIWrapper.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace FileFormats::Gff::Raw {
 
+Gff::Gff(std::pmr::memory_resource* resource)
+    : m_Structs(resource),
+      m_Fields(resource),
+      m_Labels(resource),
+      m_FieldData(resource),
+      m_FieldIndices(resource),
+      m_ListIndices(resource)
+{ }
+
 bool Gff::ReadFromBytes(std::byte const* bytes, Gff* out)
 {
     ASSERT(bytes);
@@ -20,13 +33,19 @@ bool Gff::ReadFromByteVector(std::vector<std::byte>&& bytes, Gff* out)
     return out->ConstructInternal(bytes.data());
 }
 
-bool Gff::ReadFromFile(char const* path, Gff* out)
+bool Gff::ReadFromFile(char const* path, Gff* out, FileReadOptions const& options)
 {
     ASSERT(path);
     ASSERT(out);
 
+    if (options.m_Backend != FileReadBackend::MemoryMap)
+    {
+        std::vector<std::byte> bytes;
+        return ReadEntireFile(path, &bytes) && ReadFromByteVector(std::move(bytes), out);
+    }
+
     MemoryMappedFile memmap;
-    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap);
+    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap, options.m_Hints);
 
     if (!loaded)
     {
@@ -40,26 +59,25 @@ bool Gff::WriteToFile(char const* path) const
 {
     ASSERT(path);
 
-    FILE* outFile = std::fopen(path, "wb");
-
-    if (outFile)
+    WriteBuffer const buffers[] =
     {
-        std::fwrite(&m_Header, sizeof(m_Header), 1, outFile);
-        std::fwrite(m_Structs.data(), sizeof(m_Structs[0]), m_Structs.size(), outFile);
-        std::fwrite(m_Fields.data(), sizeof(m_Fields[0]), m_Fields.size(), outFile);
-        std::fwrite(m_Labels.data(), sizeof(m_Labels[0]), m_Labels.size(), outFile);
-        std::fwrite(m_FieldData.data(), sizeof(m_FieldData[0]), m_FieldData.size(), outFile);
-        std::fwrite(m_FieldIndices.data(), sizeof(m_FieldIndices[0]), m_FieldIndices.size(), outFile);
-        std::fwrite(m_ListIndices.data(), sizeof(m_ListIndices[0]), m_ListIndices.size(), outFile);
-        std::fclose(outFile);
-        return true;
-    }
-
-    return false;
+        { &m_Header, sizeof(m_Header) },
+        { m_Structs.data(), m_Structs.size() * sizeof(m_Structs[0]) },
+        { m_Fields.data(), m_Fields.size() * sizeof(m_Fields[0]) },
+        { m_Labels.data(), m_Labels.size() * sizeof(m_Labels[0]) },
+        { m_FieldData.data(), m_FieldData.size() * sizeof(m_FieldData[0]) },
+        { m_FieldIndices.data(), m_FieldIndices.size() * sizeof(m_FieldIndices[0]) },
+        { m_ListIndices.data(), m_ListIndices.size() * sizeof(m_ListIndices[0]) },
+    };
+
+    return WriteBuffersToFile(path, buffers, sizeof(buffers) / sizeof(buffers[0]));
 }
 
 namespace {
 
+// The Construct* functions below are shared between Gff and GffView - the sections are accessed identically
+// whether they are vectors or spans.
+
 template <typename T>
 T ReadSimpleType(GffField const& field, GffField::Type type)
 {
@@ -69,121 +87,76 @@ T ReadSimpleType(GffField const& field, GffField::Type type)
     return value;
 }
 
-}
-
-GffField::Type_BYTE Gff::ConstructBYTE(GffField const& field) const
-{
-    return ReadSimpleType<GffField::Type_BYTE>(field, GffField::Type::BYTE);
-}
-
-GffField::Type_CHAR Gff::ConstructCHAR(GffField const& field) const
-{
-    return ReadSimpleType<GffField::Type_CHAR>(field, GffField::Type::CHAR);
-}
-
-GffField::Type_WORD Gff::ConstructWORD(GffField const& field) const
-{
-    return ReadSimpleType<GffField::Type_WORD>(field, GffField::Type::WORD);
-}
-
-GffField::Type_SHORT Gff::ConstructSHORT(GffField const& field) const
-{
-    return ReadSimpleType<GffField::Type_SHORT>(field, GffField::Type::SHORT);
-}
-
-GffField::Type_DWORD Gff::ConstructDWORD(GffField const& field) const
-{
-    return ReadSimpleType<GffField::Type_DWORD>(field, GffField::Type::DWORD);
-}
-
-GffField::Type_INT Gff::ConstructINT(GffField const& field) const
-{
-    return ReadSimpleType<GffField::Type_INT>(field, GffField::Type::INT);
-}
-
-GffField::Type_DWORD64 Gff::ConstructDWORD64(GffField const& field) const
-{
-    ASSERT(field.m_Type == GffField::Type::DWORD64);
-
-    std::uint32_t offsetIntoFieldDataArray = field.m_DataOrDataOffset;
-    ASSERT(offsetIntoFieldDataArray < m_FieldData.size());
-
-    GffField::Type_DWORD64 value;
-    std::memcpy(&value, m_FieldData.data() + offsetIntoFieldDataArray, sizeof(value));
-    return value;
-}
-
-GffField::Type_INT64 Gff::ConstructINT64(GffField const& field) const
-{
-    ASSERT(field.m_Type == GffField::Type::INT64);
-
-    std::uint32_t offsetIntoFieldDataArray = field.m_DataOrDataOffset;
-    ASSERT(offsetIntoFieldDataArray < m_FieldData.size());
-
-    GffField::Type_INT64 value;
-    std::memcpy(&value, m_FieldData.data() + offsetIntoFieldDataArray, sizeof(value));
-    return value;
-}
-
-GffField::Type_FLOAT Gff::ConstructFLOAT(GffField const& field) const
-{
-    return ReadSimpleType<GffField::Type_FLOAT>(field, GffField::Type::FLOAT);
-}
-
-GffField::Type_DOUBLE Gff::ConstructDOUBLE(GffField const& field) const
+template <typename T, typename RawGff>
+T ReadComplexFixedSizeType(RawGff const& gff, GffField const& field, GffField::Type type)
 {
-    ASSERT(field.m_Type == GffField::Type::DOUBLE);
+    ASSERT(field.m_Type == type);
 
     std::uint32_t offsetIntoFieldDataArray = field.m_DataOrDataOffset;
-    ASSERT(offsetIntoFieldDataArray < m_FieldData.size());
+    ASSERT(offsetIntoFieldDataArray < gff.m_FieldData.size());
 
-    GffField::Type_DOUBLE value;
-    std::memcpy(&value, m_FieldData.data() + offsetIntoFieldDataArray, sizeof(value));
+    T value;
+    std::memcpy(&value, gff.m_FieldData.data() + offsetIntoFieldDataArray, sizeof(value));
     return value;
 }
 
-GffField::Type_CExoString Gff::ConstructCExoString(GffField const& field) const
+template <typename RawGff>
+GffField::Type_CExoString ConstructCExoStringInternal(RawGff const& gff, GffField const& field)
 {
     ASSERT(field.m_Type == GffField::Type::CExoString);
 
     std::uint32_t offsetIntoFieldDataArray = field.m_DataOrDataOffset;
-    ASSERT(offsetIntoFieldDataArray < m_FieldData.size());
+    ASSERT(offsetIntoFieldDataArray < gff.m_FieldData.size());
 
     GffField::Type_CExoString string;
 
     std::uint32_t length;
-    std::memcpy(&length, m_FieldData.data() + offsetIntoFieldDataArray, sizeof(length));
+    std::memcpy(&length, gff.m_FieldData.data() + offsetIntoFieldDataArray, sizeof(length));
 
-    string.m_String = std::string(reinterpret_cast<char const*>(m_FieldData.data() + offsetIntoFieldDataArray + sizeof(length)), length);
+    string.m_String = std::string(reinterpret_cast<char const*>(gff.m_FieldData.data() + offsetIntoFieldDataArray + sizeof(length)), length);
 
     return string;
 }
 
-GffField::Type_CResRef Gff::ConstructResRef(GffField const& field) const
+template <typename RawGff>
+GffField::Type_CResRef ConstructResRefInternal(RawGff const& gff, GffField const& field)
 {
     ASSERT(field.m_Type == GffField::Type::ResRef);
 
     std::uint32_t offsetIntoFieldDataArray = field.m_DataOrDataOffset;
-    ASSERT(offsetIntoFieldDataArray < m_FieldData.size());
+    ASSERT(offsetIntoFieldDataArray < gff.m_FieldData.size());
+
+    GffField::Type_CResRef resref = {};
 
-    GffField::Type_CResRef resref;
+    if (offsetIntoFieldDataArray >= gff.m_FieldData.size())
+    {
+        return resref;
+    }
 
-    std::memcpy(&resref.m_Size, m_FieldData.data() + offsetIntoFieldDataArray, sizeof(resref.m_Size));
-    std::memcpy(&resref.m_String, m_FieldData.data() + offsetIntoFieldDataArray + sizeof(resref.m_Size), sizeof(resref.m_String));
+    std::memcpy(&resref.m_Size, gff.m_FieldData.data() + offsetIntoFieldDataArray, sizeof(resref.m_Size));
+    ASSERT(resref.m_Size <= sizeof(resref.m_String));
+    ASSERT(offsetIntoFieldDataArray + sizeof(resref.m_Size) + resref.m_Size <= gff.m_FieldData.size());
+
+    // Only the characters in use are stored - the resref may be the last thing in the block. The size comes from
+    // the file, so it is clamped to both the string and what is left of the block before anything is copied.
+    std::size_t available = gff.m_FieldData.size() - offsetIntoFieldDataArray - sizeof(resref.m_Size);
+    resref.m_Size = static_cast<std::uint8_t>(std::min<std::size_t>({ resref.m_Size, sizeof(resref.m_String), available }));
+    std::memcpy(&resref.m_String, gff.m_FieldData.data() + offsetIntoFieldDataArray + sizeof(resref.m_Size), resref.m_Size);
 
     return resref;
 }
 
-GffField::Type_CExoLocString Gff::ConstructCExoLocString(GffField const& field) const
+template <typename RawGff>
+GffField::Type_CExoLocString ConstructCExoLocStringInternal(RawGff const& gff, GffField const& field)
 {
     ASSERT(field.m_Type == GffField::Type::CExoLocString);
 
     std::uint32_t offsetIntoFieldDataArray = field.m_DataOrDataOffset;
-    ASSERT(offsetIntoFieldDataArray < m_FieldData.size());
+    ASSERT(offsetIntoFieldDataArray < gff.m_FieldData.size());
 
     GffField::Type_CExoLocString locString;
 
-    std::byte const* ptr = m_FieldData.data() + offsetIntoFieldDataArray;
+    std::byte const* ptr = gff.m_FieldData.data() + offsetIntoFieldDataArray;
 
     std::memcpy(&locString.m_TotalSize, ptr, sizeof(locString.m_TotalSize));
     ptr += sizeof(locString.m_TotalSize);
@@ -215,48 +188,213 @@ GffField::Type_CExoLocString Gff::ConstructCExoLocString(GffField const& field)
     return locString;
 }
 
-GffField::Type_VOID Gff::ConstructVOID(GffField const& field) const
+template <typename RawGff>
+GffField::Type_VOID ConstructVOIDInternal(RawGff const& gff, GffField const& field)
 {
     ASSERT(field.m_Type == GffField::Type::VOID);
 
     std::uint32_t offsetIntoFieldDataArray = field.m_DataOrDataOffset;
-    ASSERT(offsetIntoFieldDataArray < m_FieldData.size());
+    ASSERT(offsetIntoFieldDataArray < gff.m_FieldData.size());
 
     GffField::Type_VOID binary;
 
     std::uint32_t size;
-    std::memcpy(&size, m_FieldData.data() + offsetIntoFieldDataArray, sizeof(size));
+    std::memcpy(&size, gff.m_FieldData.data() + offsetIntoFieldDataArray, sizeof(size));
 
     binary.m_Data.resize(size);
-    std::memcpy(binary.m_Data.data(), m_FieldData.data() + offsetIntoFieldDataArray + sizeof(size), size);
+    std::memcpy(binary.m_Data.data(), gff.m_FieldData.data() + offsetIntoFieldDataArray + sizeof(size), size);
 
     return binary;
 }
 
-GffField::Type_Struct Gff::ConstructStruct(GffField const& field) const
+template <typename RawGff>
+GffField::Type_Struct ConstructStructInternal(RawGff const& gff, GffField const& field)
 {
     ASSERT(field.m_Type == GffField::Type::Struct);
-    return m_Structs[field.m_DataOrDataOffset];
+    return gff.m_Structs[field.m_DataOrDataOffset];
 }
 
-GffField::Type_List Gff::ConstructList(GffField const& field) const
+template <typename RawGff>
+GffField::Type_List ConstructListInternal(RawGff const& gff, GffField const& field)
 {
     ASSERT(field.m_Type == GffField::Type::List);
 
     std::uint32_t offsetIntoListIndicesArray = field.m_DataOrDataOffset;
-    ASSERT(offsetIntoListIndicesArray < m_ListIndices.size());
+    ASSERT(offsetIntoListIndicesArray < gff.m_ListIndices.size());
 
     GffField::Type_List list;
 
     std::uint32_t length;
-    std::memcpy(&length, m_ListIndices.data() + offsetIntoListIndicesArray, sizeof(length));
+    std::memcpy(&length, gff.m_ListIndices.data() + offsetIntoListIndicesArray, sizeof(length));
 
     list.m_Elements.resize(length);
-    std::memcpy(list.m_Elements.data(), m_ListIndices.data() + offsetIntoListIndicesArray + sizeof(length), length * sizeof(std::uint32_t));
+    std::memcpy(list.m_Elements.data(), gff.m_ListIndices.data() + offsetIntoListIndicesArray + sizeof(length), length * sizeof(std::uint32_t));
 
     return list;
 }
 
+}
+
+GffField::Type_BYTE Gff::ConstructBYTE(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_BYTE>(field, GffField::Type::BYTE);
+}
+
+GffField::Type_CHAR Gff::ConstructCHAR(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_CHAR>(field, GffField::Type::CHAR);
+}
+
+GffField::Type_WORD Gff::ConstructWORD(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_WORD>(field, GffField::Type::WORD);
+}
+
+GffField::Type_SHORT Gff::ConstructSHORT(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_SHORT>(field, GffField::Type::SHORT);
+}
+
+GffField::Type_DWORD Gff::ConstructDWORD(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_DWORD>(field, GffField::Type::DWORD);
+}
+
+GffField::Type_INT Gff::ConstructINT(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_INT>(field, GffField::Type::INT);
+}
+
+GffField::Type_DWORD64 Gff::ConstructDWORD64(GffField const& field) const
+{
+    return ReadComplexFixedSizeType<GffField::Type_DWORD64>(*this, field, GffField::Type::DWORD64);
+}
+
+GffField::Type_INT64 Gff::ConstructINT64(GffField const& field) const
+{
+    return ReadComplexFixedSizeType<GffField::Type_INT64>(*this, field, GffField::Type::INT64);
+}
+
+GffField::Type_FLOAT Gff::ConstructFLOAT(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_FLOAT>(field, GffField::Type::FLOAT);
+}
+
+GffField::Type_DOUBLE Gff::ConstructDOUBLE(GffField const& field) const
+{
+    return ReadComplexFixedSizeType<GffField::Type_DOUBLE>(*this, field, GffField::Type::DOUBLE);
+}
+
+GffField::Type_CExoString Gff::ConstructCExoString(GffField const& field) const
+{
+    return ConstructCExoStringInternal(*this, field);
+}
+
+GffField::Type_CResRef Gff::ConstructResRef(GffField const& field) const
+{
+    return ConstructResRefInternal(*this, field);
+}
+
+GffField::Type_CExoLocString Gff::ConstructCExoLocString(GffField const& field) const
+{
+    return ConstructCExoLocStringInternal(*this, field);
+}
+
+GffField::Type_VOID Gff::ConstructVOID(GffField const& field) const
+{
+    return ConstructVOIDInternal(*this, field);
+}
+
+GffField::Type_Struct Gff::ConstructStruct(GffField const& field) const
+{
+    return ConstructStructInternal(*this, field);
+}
+
+GffField::Type_List Gff::ConstructList(GffField const& field) const
+{
+    return ConstructListInternal(*this, field);
+}
+
+GffField::Type_BYTE GffView::ConstructBYTE(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_BYTE>(field, GffField::Type::BYTE);
+}
+
+GffField::Type_CHAR GffView::ConstructCHAR(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_CHAR>(field, GffField::Type::CHAR);
+}
+
+GffField::Type_WORD GffView::ConstructWORD(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_WORD>(field, GffField::Type::WORD);
+}
+
+GffField::Type_SHORT GffView::ConstructSHORT(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_SHORT>(field, GffField::Type::SHORT);
+}
+
+GffField::Type_DWORD GffView::ConstructDWORD(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_DWORD>(field, GffField::Type::DWORD);
+}
+
+GffField::Type_INT GffView::ConstructINT(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_INT>(field, GffField::Type::INT);
+}
+
+GffField::Type_DWORD64 GffView::ConstructDWORD64(GffField const& field) const
+{
+    return ReadComplexFixedSizeType<GffField::Type_DWORD64>(*this, field, GffField::Type::DWORD64);
+}
+
+GffField::Type_INT64 GffView::ConstructINT64(GffField const& field) const
+{
+    return ReadComplexFixedSizeType<GffField::Type_INT64>(*this, field, GffField::Type::INT64);
+}
+
+GffField::Type_FLOAT GffView::ConstructFLOAT(GffField const& field) const
+{
+    return ReadSimpleType<GffField::Type_FLOAT>(field, GffField::Type::FLOAT);
+}
+
+GffField::Type_DOUBLE GffView::ConstructDOUBLE(GffField const& field) const
+{
+    return ReadComplexFixedSizeType<GffField::Type_DOUBLE>(*this, field, GffField::Type::DOUBLE);
+}
+
+GffField::Type_CExoString GffView::ConstructCExoString(GffField const& field) const
+{
+    return ConstructCExoStringInternal(*this, field);
+}
+
+GffField::Type_CResRef GffView::ConstructResRef(GffField const& field) const
+{
+    return ConstructResRefInternal(*this, field);
+}
+
+GffField::Type_CExoLocString GffView::ConstructCExoLocString(GffField const& field) const
+{
+    return ConstructCExoLocStringInternal(*this, field);
+}
+
+GffField::Type_VOID GffView::ConstructVOID(GffField const& field) const
+{
+    return ConstructVOIDInternal(*this, field);
+}
+
+GffField::Type_Struct GffView::ConstructStruct(GffField const& field) const
+{
+    return ConstructStructInternal(*this, field);
+}
+
+GffField::Type_List GffView::ConstructList(GffField const& field) const
+{
+    return ConstructListInternal(*this, field);
+}
+
 bool Gff::ConstructInternal(std::byte const* bytes)
 {
     std::memcpy(&m_Header, bytes, sizeof(m_Header));
@@ -278,8 +416,8 @@ bool Gff::ConstructInternal(std::byte const* bytes)
 
 namespace {
 
-template <typename T>
-void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T>& out)
+template <typename T, typename Allocator>
+void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T, Allocator>& out)
 {
     out.resize(count);
     std::memcpy(out.data(), bytesWithInitialOffset, count * sizeof(T));
@@ -329,4 +467,914 @@ void Gff::ReadLists(std::byte const* data)
     ReadGenericOffsetable(data + offset, count, m_ListIndices);
 }
 
+bool GffView::ReadFromBytes(std::byte const* bytes, std::size_t bytesCount, GffView* out)
+{
+    ASSERT(bytes);
+    ASSERT(out);
+    return out->ConstructInternal(bytes, bytesCount);
+}
+
+bool GffView::ReadFromByteVector(std::vector<std::byte>&& bytes, GffView* out)
+{
+    ASSERT(!bytes.empty());
+    ASSERT(out);
+
+    // Moving the vector into the wrapper does not move the underlying buffer, so the spans remain valid.
+    std::byte const* data = bytes.data();
+    std::size_t dataLength = bytes.size();
+
+    using StorageType = std::vector<std::byte>;
+    out->m_DataBlockStorage = std::make_shared<RAIIWrapper<StorageType>>(std::forward<StorageType>(bytes));
+
+    return out->ConstructInternal(data, dataLength);
+}
+
+bool GffView::ReadFromFile(char const* path, GffView* out, FileReadOptions const& options)
+{
+    ASSERT(path);
+    ASSERT(out);
+
+    if (options.m_Backend != FileReadBackend::MemoryMap)
+    {
+        std::vector<std::byte> bytes;
+        return ReadEntireFile(path, &bytes) && ReadFromByteVector(std::move(bytes), out);
+    }
+
+    MemoryMappedFile memmap;
+    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap, options.m_Hints);
+
+    if (!loaded)
+    {
+        return false;
+    }
+
+    DataBlock const& memmapped = memmap.GetDataBlock();
+    std::byte const* data = memmapped.GetData();
+    std::size_t dataLength = memmapped.GetDataLength();
+
+    out->m_DataBlockStorage = std::make_shared<RAIIWrapper<MemoryMappedFile>>(std::move(memmap));
+
+    return out->ConstructInternal(data, dataLength);
+}
+
+namespace {
+
+// Points the span at a section of the source bytes. Returns false if the section is outside of the source.
+template <typename T>
+bool ReadSection(std::byte const* bytes, std::size_t bytesCount, std::uint32_t offset, std::size_t count, Span<T const>* out)
+{
+    if (offset > bytesCount || count > (bytesCount - offset) / sizeof(T))
+    {
+        return false;
+    }
+
+    out->m_Data = reinterpret_cast<T const*>(bytes + offset);
+    out->m_Count = count;
+    return true;
+}
+
+}
+
+bool GffView::ConstructInternal(std::byte const* bytes, std::size_t bytesCount)
+{
+    if (bytesCount < sizeof(m_Header))
+    {
+        return false;
+    }
+
+    std::memcpy(&m_Header, bytes, sizeof(m_Header));
+
+    if (std::memcmp(m_Header.m_FileVersion, "V3.2", 4) != 0)
+    {
+        return false;
+    }
+
+    // Unlike Gff, we know how many bytes we have been given, so we can refuse to point outside of them.
+    return ReadSection(bytes, bytesCount, m_Header.m_StructOffset, m_Header.m_StructCount, &m_Structs) &&
+        ReadSection(bytes, bytesCount, m_Header.m_FieldOffset, m_Header.m_FieldCount, &m_Fields) &&
+        ReadSection(bytes, bytesCount, m_Header.m_LabelOffset, m_Header.m_LabelCount, &m_Labels) &&
+        ReadSection(bytes, bytesCount, m_Header.m_FieldDataOffset, m_Header.m_FieldDataCount, &m_FieldData) &&
+        ReadSection(bytes, bytesCount, m_Header.m_FieldIndicesOffset, m_Header.m_FieldIndicesCount / sizeof(GffFieldIndex), &m_FieldIndices) &&
+        ReadSection(bytes, bytesCount, m_Header.m_ListIndicesOffset, m_Header.m_ListIndicesCount, &m_ListIndices);
+}
+
+bool GffProjection::Parse(std::vector<std::string> const& paths, GffProjection* out)
+{
+    ASSERT(out);
+
+    out->m_Labels.clear();
+    out->m_Nodes.clear();
+    out->m_Nodes.emplace_back();
+    out->m_PathCount = static_cast<std::uint32_t>(paths.size());
+
+    for (std::uint32_t pathIndex = 0; pathIndex < paths.size(); ++pathIndex)
+    {
+        std::string const& path = paths[pathIndex];
+        std::uint32_t nodeIndex = 0;
+        std::size_t componentStart = 0;
+
+        while (true)
+        {
+            std::size_t componentEnd = path.find('/', componentStart);
+            bool lastComponent = componentEnd == std::string::npos;
+            std::string component = path.substr(componentStart, lastComponent ? std::string::npos : componentEnd - componentStart);
+
+            std::uint32_t listIndex = None;
+            std::size_t bracket = component.find('[');
+
+            if (bracket != std::string::npos)
+            {
+                // A list index must be followed by another component - we can only return fields.
+                if (lastComponent || component.back() != ']' || bracket + 2 >= component.size())
+                {
+                    return false;
+                }
+
+                std::string digits = component.substr(bracket + 1, component.size() - bracket - 2);
+
+                if (digits.size() > 9 || digits.find_first_not_of("0123456789") != std::string::npos)
+                {
+                    return false;
+                }
+
+                listIndex = static_cast<std::uint32_t>(std::stoul(digits));
+                component.resize(bracket);
+            }
+
+            if (component.empty() || component.size() > sizeof(GffLabel::m_Label))
+            {
+                return false;
+            }
+
+            GffLabel label = {};
+            std::memcpy(label.m_Label, component.data(), component.size());
+
+            std::uint32_t labelSlot = 0;
+            while (labelSlot < out->m_Labels.size() && std::memcmp(out->m_Labels[labelSlot].m_Label, label.m_Label, sizeof(label.m_Label)) != 0)
+            {
+                ++labelSlot;
+            }
+
+            if (labelSlot == out->m_Labels.size())
+            {
+                out->m_Labels.emplace_back(label);
+            }
+
+            std::uint32_t childIndex = None;
+
+            for (std::uint32_t candidate : out->m_Nodes[nodeIndex].m_Children)
+            {
+                if (out->m_Nodes[candidate].m_LabelSlot == labelSlot && out->m_Nodes[candidate].m_ListIndex == listIndex)
+                {
+                    childIndex = candidate;
+                    break;
+                }
+            }
+
+            if (childIndex == None)
+            {
+                childIndex = static_cast<std::uint32_t>(out->m_Nodes.size());
+                out->m_Nodes[nodeIndex].m_Children.emplace_back(childIndex);
+
+                Node node;
+                node.m_LabelSlot = labelSlot;
+                node.m_ListIndex = listIndex;
+                out->m_Nodes.emplace_back(std::move(node));
+            }
+
+            nodeIndex = childIndex;
+
+            if (lastComponent)
+            {
+                out->m_Nodes[nodeIndex].m_PathIndices.emplace_back(pathIndex);
+                break;
+            }
+
+            componentStart = componentEnd + 1;
+        }
+    }
+
+    return true;
+}
+
+namespace {
+
+template <typename RawGff>
+struct ProjectionContext
+{
+    RawGff const& m_Gff;
+    GffProjection const& m_Projection;
+
+    // Maps each label index in the file to a label slot in the projection, or GffProjection::None.
+    std::vector<std::uint32_t> m_LabelSlots;
+
+    std::vector<GffField const*>* m_Out;
+};
+
+template <typename RawGff>
+void ProjectField(ProjectionContext<RawGff>& context, GffProjection::Node const& node, GffField const& field);
+
+template <typename RawGff>
+void ProjectStruct(ProjectionContext<RawGff>& context, GffProjection::Node const& node, GffStruct const& rawStruct)
+{
+    RawGff const& gff = context.m_Gff;
+
+    // See Friendly::GffStruct - ill-formed empty structs are tolerated.
+    if (!rawStruct.m_FieldCount || rawStruct.m_DataOrDataOffset == 0xFFFFFFFF)
+    {
+        return;
+    }
+
+    if (rawStruct.m_FieldCount == 1)
+    {
+        ASSERT(rawStruct.m_DataOrDataOffset < gff.m_Fields.size());
+        ProjectField(context, node, gff.m_Fields[rawStruct.m_DataOrDataOffset]);
+        return;
+    }
+
+    std::uint32_t offsetIntoFieldIndexArray = rawStruct.m_DataOrDataOffset / sizeof(GffFieldIndex);
+    ASSERT(offsetIntoFieldIndexArray < gff.m_FieldIndices.size());
+
+    for (std::size_t i = 0; i < rawStruct.m_FieldCount; ++i)
+    {
+        std::uint32_t offsetIntoFieldArray = gff.m_FieldIndices[offsetIntoFieldIndexArray + i];
+        ASSERT(offsetIntoFieldArray < gff.m_Fields.size());
+        ProjectField(context, node, gff.m_Fields[offsetIntoFieldArray]);
+    }
+}
+
+template <typename RawGff>
+void ProjectField(ProjectionContext<RawGff>& context, GffProjection::Node const& node, GffField const& field)
+{
+    RawGff const& gff = context.m_Gff;
+
+    ASSERT(field.m_LabelIndex < context.m_LabelSlots.size());
+    std::uint32_t labelSlot = context.m_LabelSlots[field.m_LabelIndex];
+
+    if (labelSlot == GffProjection::None)
+    {
+        return;
+    }
+
+    for (std::uint32_t childIndex : node.m_Children)
+    {
+        GffProjection::Node const& child = context.m_Projection.m_Nodes[childIndex];
+
+        if (child.m_LabelSlot != labelSlot)
+        {
+            continue;
+        }
+
+        for (std::uint32_t pathIndex : child.m_PathIndices)
+        {
+            (*context.m_Out)[pathIndex] = &field;
+        }
+
+        if (child.m_Children.empty())
+        {
+            continue;
+        }
+
+        if (child.m_ListIndex != GffProjection::None)
+        {
+            if (field.m_Type != GffField::Type::List)
+            {
+                continue;
+            }
+
+            // Read just the element we want rather than constructing the whole list.
+            std::uint32_t offsetIntoListIndicesArray = field.m_DataOrDataOffset;
+            ASSERT(offsetIntoListIndicesArray + sizeof(std::uint32_t) <= gff.m_ListIndices.size());
+
+            std::uint32_t length;
+            std::memcpy(&length, gff.m_ListIndices.data() + offsetIntoListIndicesArray, sizeof(length));
+
+            if (child.m_ListIndex >= length)
+            {
+                continue;
+            }
+
+            std::size_t elementOffset = offsetIntoListIndicesArray + sizeof(length) + child.m_ListIndex * sizeof(std::uint32_t);
+            ASSERT(elementOffset + sizeof(std::uint32_t) <= gff.m_ListIndices.size());
+
+            std::uint32_t offsetIntoStructArray;
+            std::memcpy(&offsetIntoStructArray, gff.m_ListIndices.data() + elementOffset, sizeof(offsetIntoStructArray));
+            ASSERT(offsetIntoStructArray < gff.m_Structs.size());
+
+            ProjectStruct(context, child, gff.m_Structs[offsetIntoStructArray]);
+        }
+        else if (field.m_Type == GffField::Type::Struct)
+        {
+            ASSERT(field.m_DataOrDataOffset < gff.m_Structs.size());
+            ProjectStruct(context, child, gff.m_Structs[field.m_DataOrDataOffset]);
+        }
+    }
+}
+
+template <typename RawGff>
+void ProjectInternal(RawGff const& gff, GffProjection const& projection, std::vector<GffField const*>* out)
+{
+    ASSERT(out);
+    ASSERT(!projection.m_Nodes.empty());
+
+    out->assign(projection.m_PathCount, nullptr);
+
+    if (gff.m_Structs.empty())
+    {
+        return;
+    }
+
+    ProjectionContext<RawGff> context { gff, projection, {}, out };
+    context.m_LabelSlots.assign(gff.m_Labels.size(), GffProjection::None);
+
+    // This is the only place labels are compared. Past this point, fields are matched by label index.
+    for (std::size_t i = 0; i < gff.m_Labels.size(); ++i)
+    {
+        for (std::uint32_t labelSlot = 0; labelSlot < projection.m_Labels.size(); ++labelSlot)
+        {
+            if (std::strncmp(gff.m_Labels[i].m_Label, projection.m_Labels[labelSlot].m_Label, sizeof(GffLabel::m_Label)) == 0)
+            {
+                context.m_LabelSlots[i] = labelSlot;
+                break;
+            }
+        }
+    }
+
+    ProjectStruct(context, projection.m_Nodes[0], gff.m_Structs[0]);
+}
+
+}
+
+void Gff::Project(GffProjection const& projection, std::vector<GffField const*>* out) const
+{
+    ProjectInternal(*this, projection, out);
+}
+
+void GffView::Project(GffProjection const& projection, std::vector<GffField const*>* out) const
+{
+    ProjectInternal(*this, projection, out);
+}
+
+bool GffEventHandler::BeginStruct(std::string_view, std::uint32_t)
+{
+    return true;
+}
+
+void GffEventHandler::EndStruct()
+{ }
+
+bool GffEventHandler::BeginList(std::string_view, std::uint32_t)
+{
+    return true;
+}
+
+void GffEventHandler::EndList()
+{ }
+
+void GffEventHandler::OnBYTE(std::string_view, GffField::Type_BYTE)
+{ }
+
+void GffEventHandler::OnCHAR(std::string_view, GffField::Type_CHAR)
+{ }
+
+void GffEventHandler::OnWORD(std::string_view, GffField::Type_WORD)
+{ }
+
+void GffEventHandler::OnSHORT(std::string_view, GffField::Type_SHORT)
+{ }
+
+void GffEventHandler::OnDWORD(std::string_view, GffField::Type_DWORD)
+{ }
+
+void GffEventHandler::OnINT(std::string_view, GffField::Type_INT)
+{ }
+
+void GffEventHandler::OnDWORD64(std::string_view, GffField::Type_DWORD64)
+{ }
+
+void GffEventHandler::OnINT64(std::string_view, GffField::Type_INT64)
+{ }
+
+void GffEventHandler::OnFLOAT(std::string_view, GffField::Type_FLOAT)
+{ }
+
+void GffEventHandler::OnDOUBLE(std::string_view, GffField::Type_DOUBLE)
+{ }
+
+void GffEventHandler::OnCExoString(std::string_view, std::string_view)
+{ }
+
+void GffEventHandler::OnResRef(std::string_view, std::string_view)
+{ }
+
+void GffEventHandler::OnVOID(std::string_view, Span<std::byte const>)
+{ }
+
+void GffEventHandler::OnCExoLocString(std::string_view, std::uint32_t, std::uint32_t)
+{ }
+
+void GffEventHandler::OnLocSubString(std::int32_t, std::string_view)
+{ }
+
+namespace {
+
+// Structs can only nest so deep in a well formed file. This keeps a malformed file from exhausting the stack.
+constexpr std::uint32_t MaxEventDepth = 128;
+
+template <typename RawGff>
+struct EventContext
+{
+    RawGff const& m_Gff;
+    GffEventHandler* m_Handler;
+
+    // Each struct in a well formed file is reached exactly once, so visiting more than there are means the file
+    // refers to a struct twice - possibly from within itself.
+    std::size_t m_StructsVisited;
+};
+
+// Returns whether length bytes starting at offset are within the field data block.
+template <typename RawGff>
+bool IsFieldDataInBounds(RawGff const& gff, std::uint64_t offset, std::uint64_t length)
+{
+    return offset + length <= gff.m_FieldData.size();
+}
+
+template <typename RawGff>
+bool ReadStructEvents(EventContext<RawGff>& context, std::string_view label, std::uint32_t structIndex, std::uint32_t depth);
+
+// Reads a DWORD size prefix at offset, then returns a view of the size bytes after it.
+template <typename RawGff>
+bool ReadSizedFieldData(RawGff const& gff, std::uint32_t offset, std::byte const** data, std::uint32_t* size)
+{
+    if (!IsFieldDataInBounds(gff, offset, sizeof(*size)))
+    {
+        return false;
+    }
+
+    std::memcpy(size, gff.m_FieldData.data() + offset, sizeof(*size));
+
+    if (!IsFieldDataInBounds(gff, offset + sizeof(*size), *size))
+    {
+        return false;
+    }
+
+    *data = gff.m_FieldData.data() + offset + sizeof(*size);
+    return true;
+}
+
+template <typename T, typename RawGff>
+bool ReadFixedSizeFieldData(RawGff const& gff, std::uint32_t offset, T* out)
+{
+    if (!IsFieldDataInBounds(gff, offset, sizeof(*out)))
+    {
+        return false;
+    }
+
+    std::memcpy(out, gff.m_FieldData.data() + offset, sizeof(*out));
+    return true;
+}
+
+template <typename RawGff>
+bool ReadLocStringEvents(EventContext<RawGff>& context, std::string_view label, std::uint32_t offset)
+{
+    RawGff const& gff = context.m_Gff;
+
+    std::byte const* ptr;
+    std::uint32_t totalSize;
+
+    if (!ReadSizedFieldData(gff, offset, &ptr, &totalSize))
+    {
+        return false;
+    }
+
+    std::byte const* end = ptr + totalSize;
+
+    std::uint32_t stringRef;
+    std::uint32_t stringCount;
+
+    if (end - ptr < static_cast<std::ptrdiff_t>(sizeof(stringRef) + sizeof(stringCount)))
+    {
+        return false;
+    }
+
+    std::memcpy(&stringRef, ptr, sizeof(stringRef));
+    ptr += sizeof(stringRef);
+    std::memcpy(&stringCount, ptr, sizeof(stringCount));
+    ptr += sizeof(stringCount);
+
+    context.m_Handler->OnCExoLocString(label, stringRef, stringCount);
+
+    for (std::uint32_t i = 0; i < stringCount; ++i)
+    {
+        std::int32_t stringId;
+        std::uint32_t length;
+
+        if (end - ptr < static_cast<std::ptrdiff_t>(sizeof(stringId) + sizeof(length)))
+        {
+            return false;
+        }
+
+        std::memcpy(&stringId, ptr, sizeof(stringId));
+        ptr += sizeof(stringId);
+        std::memcpy(&length, ptr, sizeof(length));
+        ptr += sizeof(length);
+
+        if (static_cast<std::uint64_t>(end - ptr) < length)
+        {
+            return false;
+        }
+
+        context.m_Handler->OnLocSubString(stringId, std::string_view(reinterpret_cast<char const*>(ptr), length));
+        ptr += length;
+    }
+
+    return true;
+}
+
+template <typename RawGff>
+bool ReadListEvents(EventContext<RawGff>& context, std::string_view label, std::uint32_t offset, std::uint32_t depth)
+{
+    RawGff const& gff = context.m_Gff;
+
+    std::uint32_t length;
+
+    if (static_cast<std::uint64_t>(offset) + sizeof(length) > gff.m_ListIndices.size())
+    {
+        return false;
+    }
+
+    std::memcpy(&length, gff.m_ListIndices.data() + offset, sizeof(length));
+
+    std::uint64_t elementsOffset = static_cast<std::uint64_t>(offset) + sizeof(length);
+    if (elementsOffset + static_cast<std::uint64_t>(length) * sizeof(std::uint32_t) > gff.m_ListIndices.size())
+    {
+        return false;
+    }
+
+    if (!context.m_Handler->BeginList(label, length))
+    {
+        return true;
+    }
+
+    for (std::uint32_t i = 0; i < length; ++i)
+    {
+        std::uint32_t structIndex;
+        std::memcpy(&structIndex, gff.m_ListIndices.data() + elementsOffset + i * sizeof(structIndex), sizeof(structIndex));
+
+        if (!ReadStructEvents(context, std::string_view(), structIndex, depth + 1))
+        {
+            return false;
+        }
+    }
+
+    context.m_Handler->EndList();
+    return true;
+}
+
+template <typename RawGff>
+bool ReadFieldEvents(EventContext<RawGff>& context, std::uint32_t fieldIndex, std::uint32_t depth)
+{
+    RawGff const& gff = context.m_Gff;
+    GffEventHandler* handler = context.m_Handler;
+
+    if (fieldIndex >= gff.m_Fields.size())
+    {
+        return false;
+    }
+
+    GffField const& field = gff.m_Fields[fieldIndex];
+
+    if (field.m_LabelIndex >= gff.m_Labels.size())
+    {
+        return false;
+    }
+
+    char const* labelChars = gff.m_Labels[field.m_LabelIndex].m_Label;
+    std::string_view label(labelChars, strnlen(labelChars, sizeof(GffLabel::m_Label)));
+
+    std::uint32_t data = field.m_DataOrDataOffset;
+
+    switch (field.m_Type)
+    {
+        case GffField::Type::BYTE:  handler->OnBYTE(label, ReadSimpleType<GffField::Type_BYTE>(field, field.m_Type)); return true;
+        case GffField::Type::CHAR:  handler->OnCHAR(label, ReadSimpleType<GffField::Type_CHAR>(field, field.m_Type)); return true;
+        case GffField::Type::WORD:  handler->OnWORD(label, ReadSimpleType<GffField::Type_WORD>(field, field.m_Type)); return true;
+        case GffField::Type::SHORT: handler->OnSHORT(label, ReadSimpleType<GffField::Type_SHORT>(field, field.m_Type)); return true;
+        case GffField::Type::DWORD: handler->OnDWORD(label, ReadSimpleType<GffField::Type_DWORD>(field, field.m_Type)); return true;
+        case GffField::Type::INT:   handler->OnINT(label, ReadSimpleType<GffField::Type_INT>(field, field.m_Type)); return true;
+        case GffField::Type::FLOAT: handler->OnFLOAT(label, ReadSimpleType<GffField::Type_FLOAT>(field, field.m_Type)); return true;
+
+        case GffField::Type::DWORD64:
+        {
+            GffField::Type_DWORD64 value;
+            if (!ReadFixedSizeFieldData(gff, data, &value))
+            {
+                return false;
+            }
+
+            handler->OnDWORD64(label, value);
+            return true;
+        }
+
+        case GffField::Type::INT64:
+        {
+            GffField::Type_INT64 value;
+            if (!ReadFixedSizeFieldData(gff, data, &value))
+            {
+                return false;
+            }
+
+            handler->OnINT64(label, value);
+            return true;
+        }
+
+        case GffField::Type::DOUBLE:
+        {
+            GffField::Type_DOUBLE value;
+            if (!ReadFixedSizeFieldData(gff, data, &value))
+            {
+                return false;
+            }
+
+            handler->OnDOUBLE(label, value);
+            return true;
+        }
+
+        case GffField::Type::CExoString:
+        {
+            std::byte const* string;
+            std::uint32_t length;
+            if (!ReadSizedFieldData(gff, data, &string, &length))
+            {
+                return false;
+            }
+
+            handler->OnCExoString(label, std::string_view(reinterpret_cast<char const*>(string), length));
+            return true;
+        }
+
+        case GffField::Type::ResRef:
+        {
+            std::uint8_t length;
+            if (!ReadFixedSizeFieldData(gff, data, &length))
+            {
+                return false;
+            }
+
+            if (length > sizeof(GffField::Type_CResRef::m_String))
+            {
+                return false;
+            }
+
+            if (!IsFieldDataInBounds(gff, static_cast<std::uint64_t>(data) + sizeof(length), length))
+            {
+                return false;
+            }
+
+            handler->OnResRef(label, std::string_view(reinterpret_cast<char const*>(gff.m_FieldData.data() + data + sizeof(length)), length));
+            return true;
+        }
+
+        case GffField::Type::CExoLocString:
+            return ReadLocStringEvents(context, label, data);
+
+        case GffField::Type::VOID:
+        {
+            std::byte const* binary;
+            std::uint32_t size;
+            if (!ReadSizedFieldData(gff, data, &binary, &size))
+            {
+                return false;
+            }
+
+            handler->OnVOID(label, Span<std::byte const>{ binary, size });
+            return true;
+        }
+
+        case GffField::Type::Struct:
+            return ReadStructEvents(context, label, data, depth + 1);
+
+        case GffField::Type::List:
+            return ReadListEvents(context, label, data, depth);
+
+        default:
+            return false;
+    }
+}
+
+template <typename RawGff>
+bool ReadStructEvents(EventContext<RawGff>& context, std::string_view label, std::uint32_t structIndex, std::uint32_t depth)
+{
+    RawGff const& gff = context.m_Gff;
+
+    if (structIndex >= gff.m_Structs.size() || depth > MaxEventDepth || ++context.m_StructsVisited > gff.m_Structs.size())
+    {
+        return false;
+    }
+
+    GffStruct const& rawStruct = gff.m_Structs[structIndex];
+
+    if (!context.m_Handler->BeginStruct(label, rawStruct.m_Type))
+    {
+        return true;
+    }
+
+    // See Friendly::GffStruct - ill-formed empty structs are tolerated.
+    if (rawStruct.m_FieldCount == 1 && rawStruct.m_DataOrDataOffset != 0xFFFFFFFF)
+    {
+        if (!ReadFieldEvents(context, rawStruct.m_DataOrDataOffset, depth))
+        {
+            return false;
+        }
+    }
+    else if (rawStruct.m_FieldCount > 1 && rawStruct.m_DataOrDataOffset != 0xFFFFFFFF)
+    {
+        std::uint64_t offsetIntoFieldIndexArray = rawStruct.m_DataOrDataOffset / sizeof(GffFieldIndex);
+
+        if (offsetIntoFieldIndexArray + rawStruct.m_FieldCount > gff.m_FieldIndices.size())
+        {
+            return false;
+        }
+
+        for (std::uint32_t i = 0; i < rawStruct.m_FieldCount; ++i)
+        {
+            if (!ReadFieldEvents(context, gff.m_FieldIndices[offsetIntoFieldIndexArray + i], depth))
+            {
+                return false;
+            }
+        }
+    }
+
+    context.m_Handler->EndStruct();
+    return true;
+}
+
+template <typename RawGff>
+bool ReadEventsInternal(RawGff const& gff, GffEventHandler* handler)
+{
+    ASSERT(handler);
+
+    if (gff.m_Structs.empty())
+    {
+        return false;
+    }
+
+    EventContext<RawGff> context { gff, handler, 0 };
+    return ReadStructEvents(context, std::string_view(), 0, 0);
+}
+
+}
+
+bool Gff::ReadEvents(GffEventHandler* handler) const
+{
+    return ReadEventsInternal(*this, handler);
+}
+
+bool GffView::ReadEvents(GffEventHandler* handler) const
+{
+    return ReadEventsInternal(*this, handler);
+}
+
+bool GffPatcher::ReadFromBytes(std::byte* bytes, std::size_t bytesCount, GffPatcher* out)
+{
+    ASSERT(bytes);
+    ASSERT(out);
+
+    out->m_Bytes = bytes;
+    out->m_MappedFile.reset();
+    return GffView::ReadFromBytes(bytes, bytesCount, &out->m_View);
+}
+
+bool GffPatcher::ReadFromFile(char const* path, GffPatcher* out)
+{
+    ASSERT(path);
+    ASSERT(out);
+
+    auto memmap = std::make_shared<MemoryMappedFile>();
+
+    if (!MemoryMappedFile::MemoryMapWritable(path, memmap.get()))
+    {
+        return false;
+    }
+
+    out->m_Bytes = memmap->GetWritableData();
+    out->m_MappedFile = std::move(memmap);
+    return GffView::ReadFromBytes(out->m_Bytes, out->m_MappedFile->GetDataBlock().GetDataLength(), &out->m_View);
+}
+
+GffView const& GffPatcher::GetView() const
+{
+    return m_View;
+}
+
+GffField const* GffPatcher::FindField(std::string const& path) const
+{
+    GffProjection projection;
+
+    if (!GffProjection::Parse({ path }, &projection))
+    {
+        return nullptr;
+    }
+
+    std::vector<GffField const*> fields;
+    m_View.Project(projection, &fields);
+    return fields[0];
+}
+
+template <typename T>
+bool GffPatcher::PatchInline(GffField const& field, GffField::Type type, T value)
+{
+    ASSERT(&field >= m_View.m_Fields.begin() && &field < m_View.m_Fields.end());
+
+    if (field.m_Type != type)
+    {
+        return false;
+    }
+
+    // Values smaller than a DWORD occupy its first bytes, and the rest is zeroed - the same as the writer.
+    std::uint32_t data = 0;
+    std::memcpy(&data, &value, sizeof(value));
+
+    std::size_t offset = reinterpret_cast<std::byte const*>(&field.m_DataOrDataOffset) - m_Bytes;
+    std::memcpy(m_Bytes + offset, &data, sizeof(data));
+    return true;
+}
+
+template <typename T>
+bool GffPatcher::PatchFieldData(GffField const& field, GffField::Type type, T value)
+{
+    ASSERT(&field >= m_View.m_Fields.begin() && &field < m_View.m_Fields.end());
+
+    if (field.m_Type != type)
+    {
+        return false;
+    }
+
+    // The offset comes from the file, and this writes through to it, so a malformed one fails the patch.
+    std::uint32_t offsetIntoFieldDataArray = field.m_DataOrDataOffset;
+
+    if (static_cast<std::uint64_t>(offsetIntoFieldDataArray) + sizeof(value) > m_View.m_FieldData.size())
+    {
+        return false;
+    }
+
+    std::memcpy(m_Bytes + m_View.m_Header.m_FieldDataOffset + offsetIntoFieldDataArray, &value, sizeof(value));
+    return true;
+}
+
+bool GffPatcher::PatchBYTE(GffField const& field, GffField::Type_BYTE value)
+{
+    return PatchInline(field, GffField::Type::BYTE, value);
+}
+
+bool GffPatcher::PatchCHAR(GffField const& field, GffField::Type_CHAR value)
+{
+    return PatchInline(field, GffField::Type::CHAR, value);
+}
+
+bool GffPatcher::PatchWORD(GffField const& field, GffField::Type_WORD value)
+{
+    return PatchInline(field, GffField::Type::WORD, value);
+}
+
+bool GffPatcher::PatchSHORT(GffField const& field, GffField::Type_SHORT value)
+{
+    return PatchInline(field, GffField::Type::SHORT, value);
+}
+
+bool GffPatcher::PatchDWORD(GffField const& field, GffField::Type_DWORD value)
+{
+    return PatchInline(field, GffField::Type::DWORD, value);
+}
+
+bool GffPatcher::PatchINT(GffField const& field, GffField::Type_INT value)
+{
+    return PatchInline(field, GffField::Type::INT, value);
+}
+
+bool GffPatcher::PatchDWORD64(GffField const& field, GffField::Type_DWORD64 value)
+{
+    return PatchFieldData(field, GffField::Type::DWORD64, value);
+}
+
+bool GffPatcher::PatchINT64(GffField const& field, GffField::Type_INT64 value)
+{
+    return PatchFieldData(field, GffField::Type::INT64, value);
+}
+
+bool GffPatcher::PatchFLOAT(GffField const& field, GffField::Type_FLOAT value)
+{
+    return PatchInline(field, GffField::Type::FLOAT, value);
+}
+
+bool GffPatcher::PatchDOUBLE(GffField const& field, GffField::Type_DOUBLE value)
+{
+    return PatchFieldData(field, GffField::Type::DOUBLE, value);
+}
+
+bool GffPatcher::Flush()
+{
+    return !m_MappedFile || m_MappedFile->Flush();
+}
+
 }
@@ -1,10 +1,19 @@
 #pragma once
 
+#include "Utility/FileReader.hpp"
+#include "Utility/Span.hpp"
+#include "Utility/VirtualObject.hpp"
+
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
+class MemoryMappedFile;
+
 namespace FileFormats::Gff::Raw {
 
 // Refer to https://wiki.neverwintervault.org/pages/viewpage.action?pageId=327727
@@ -312,15 +321,106 @@ using GffFieldIndex = std::uint32_t;
 // There are Size DWORDS after that, each one an index into the Struct Array.
 using GffListIndex = std::byte;
 
+// A GffProjection is a set of field paths to extract from a GFF without decoding the rest of it.
+// A path is a series of labels separated by '/'. To step into a list, give the index of the element:
+//
+//     "Str", "FirstName", "ClassList[0]/Class", "Equip_ItemList[2]/Tag"
+//
+// Parse the projection once, then run it against any number of files with Gff::Project or GffView::Project.
+// Within each file the requested labels are resolved against the label table once, and only the structs and lists
+// on the requested paths are visited. Everything else is skipped without being read.
+struct GffProjection
+{
+    static constexpr std::uint32_t None = 0xFFFFFFFF;
+
+    struct Node
+    {
+        // Index into m_Labels.
+        std::uint32_t m_LabelSlot = None;
+
+        // If this node is a list, the element to step into. Otherwise, None.
+        std::uint32_t m_ListIndex = None;
+
+        // The paths which end at this node, as indices into the output of Project.
+        std::vector<std::uint32_t> m_PathIndices;
+
+        // Indices into m_Nodes.
+        std::vector<std::uint32_t> m_Children;
+    };
+
+    // Every distinct label in the projection.
+    std::vector<GffLabel> m_Labels;
+
+    // The paths, merged into a tree. m_Nodes[0] is the top level struct.
+    std::vector<Node> m_Nodes;
+
+    std::uint32_t m_PathCount = 0;
+
+    // Parses the paths. Returns false if any path is malformed - an empty label, a label longer than 16 characters,
+    // a bad list index, or a path which ends on a list index rather than a field.
+    static bool Parse(std::vector<std::string> const& paths, GffProjection* out);
+};
+
+// GffEventHandler receives the contents of a GFF as a stream of events from Gff::ReadEvents or GffView::ReadEvents,
+// depth first in the order the fields are stored. No tree is built and nothing is allocated: labels, strings and
+// binary data are passed as views into the GFF and are only valid for the duration of the call.
+//
+// Override the events you're interested in - the rest do nothing. For example, an indexer which only wants the tag:
+//
+//     struct TagReader : GffEventHandler
+//     {
+//         void OnCExoString(std::string_view label, std::string_view value) override { if (label == "Tag") ... }
+//         bool BeginList(std::string_view, std::uint32_t) override { return false; }
+//     };
+class GffEventHandler
+{
+public:
+    virtual ~GffEventHandler() = default;
+
+    // Called for the top level struct, each struct field and each list element. The label is empty for the top level
+    // struct and for list elements. Return false to skip the fields of the struct, in which case EndStruct is not
+    // called for it.
+    virtual bool BeginStruct(std::string_view label, std::uint32_t id);
+    virtual void EndStruct();
+
+    // Called for each list field, before its elements. As above, return false to skip the elements and EndList.
+    virtual bool BeginList(std::string_view label, std::uint32_t count);
+    virtual void EndList();
+
+    virtual void OnBYTE(std::string_view label, GffField::Type_BYTE value);
+    virtual void OnCHAR(std::string_view label, GffField::Type_CHAR value);
+    virtual void OnWORD(std::string_view label, GffField::Type_WORD value);
+    virtual void OnSHORT(std::string_view label, GffField::Type_SHORT value);
+    virtual void OnDWORD(std::string_view label, GffField::Type_DWORD value);
+    virtual void OnINT(std::string_view label, GffField::Type_INT value);
+    virtual void OnDWORD64(std::string_view label, GffField::Type_DWORD64 value);
+    virtual void OnINT64(std::string_view label, GffField::Type_INT64 value);
+    virtual void OnFLOAT(std::string_view label, GffField::Type_FLOAT value);
+    virtual void OnDOUBLE(std::string_view label, GffField::Type_DOUBLE value);
+    virtual void OnCExoString(std::string_view label, std::string_view value);
+    virtual void OnResRef(std::string_view label, std::string_view value);
+    virtual void OnVOID(std::string_view label, Span<std::byte const> value);
+
+    // A CExoLocString is reported as the header, followed immediately by one OnLocSubString per substring.
+    virtual void OnCExoLocString(std::string_view label, std::uint32_t stringRef, std::uint32_t subStringCount);
+    virtual void OnLocSubString(std::int32_t stringId, std::string_view value);
+};
+
 struct Gff
 {
+    Gff() = default;
+
+    // The sections of a Gff constructed with a resource are allocated from it when read, rather than from the heap,
+    // so a batch of files can be read into one arena and released together. The resource must outlive the Gff.
+    explicit Gff(std::pmr::memory_resource* resource);
+
     GffHeader m_Header;
-    std::vector<GffStruct> m_Structs;
-    std::vector<GffField> m_Fields;
-    std::vector<GffLabel> m_Labels;
-    std::vector<GffFieldData> m_FieldData;
-    std::vector<GffFieldIndex> m_FieldIndices;
-    std::vector<GffListIndex> m_ListIndices;
+    std::pmr::vector<GffStruct> m_Structs;
+    std::pmr::vector<GffField> m_Fields;
+    std::pmr::vector<GffLabel> m_Labels;
+    std::pmr::vector<GffFieldData> m_FieldData;
+    std::pmr::vector<GffFieldIndex> m_FieldIndices;
+    std::pmr::vector<GffListIndex> m_ListIndices;
 
     // Constructs an Gff from a non-owning pointer.
     static bool ReadFromBytes(std::byte const* bytes, Gff* out);
@@ -329,7 +429,7 @@ struct Gff
     static bool ReadFromByteVector(std::vector<std::byte>&& bytes, Gff* out);
 
     // Constructs an Gff from a file.
-    static bool ReadFromFile(char const* path, Gff* out);
+    static bool ReadFromFile(char const* path, Gff* out, FileReadOptions const& options = FileReadOptions());
 
     // Writes the raw Gff to disk.
     bool WriteToFile(char const* path) const;
@@ -352,6 +452,16 @@ struct Gff
     GffField::Type_Struct ConstructStruct(GffField const& field) const;
     GffField::Type_List ConstructList(GffField const& field) const;
 
+    // Extracts the fields named by the projection. out has one entry per path, in the order the paths were given to
+    // GffProjection::Parse; each is either the field at that path or nullptr if the path doesn't exist in this file.
+    // The fields point into this Gff and can be passed to the ConstructX functions above.
+    void Project(GffProjection const& projection, std::vector<GffField const*>* out) const;
+
+    // Walks every struct, list and field from the top level struct, reporting each to the handler.
+    // Unlike the ConstructX functions, every index and offset is bounds checked, so this is safe to run over files
+    // which may be malformed. Returns false if the file is malformed - the events up to that point have been sent.
+    bool ReadEvents(GffEventHandler* handler) const;
+
 private:
     bool ConstructInternal(std::byte const* bytes);
     void ReadStructs(std::byte const* data);
@@ -362,4 +472,129 @@ private:
     void ReadLists(std::byte const* data);
 };
 
+// GffView is a read-only alternative to Gff which does not copy any of the sections out of the source bytes.
+// Instead, each section is a span directly into the source, and the source is kept alive for as long as the view
+// (or any copy of it) exists. The Construct* accessors are identical to the ones on Gff.
+//
+// This is the cheapest way to load a GFF when you don't need to modify the raw structure - prefer it over Gff
+// when loading many files, e.g. on server start.
+//
+// NOTE: Sections are read in place, so they are subject to whatever alignment the file gives them. The field
+// indices in particular are only guaranteed to be aligned if the field data block is a multiple of four bytes.
+// This is fine on x86 - see the README.
+struct GffView
+{
+    GffHeader m_Header;
+    Span<GffStruct const> m_Structs;
+    Span<GffField const> m_Fields;
+    Span<GffLabel const> m_Labels;
+    Span<GffFieldData const> m_FieldData;
+    Span<GffFieldIndex const> m_FieldIndices;
+    Span<GffListIndex const> m_ListIndices;
+
+    // Constructs a GffView from a non-owning pointer. The bytes must outlive the view.
+    static bool ReadFromBytes(std::byte const* bytes, std::size_t bytesCount, GffView* out);
+
+    // Constructs a GffView from a vector of bytes which we have taken ownership of.
+    static bool ReadFromByteVector(std::vector<std::byte>&& bytes, GffView* out);
+
+    // Constructs a GffView from a file. With the MemoryMap backend (the default) the file is mapped and stays mapped
+    // for the lifetime of the view, so nothing is copied. The Read and Batched backends read the whole file into a
+    // buffer the view owns, with ReadEntireFile, instead.
+    static bool ReadFromFile(char const* path, GffView* out, FileReadOptions const& options = FileReadOptions());
+
+    // Below are functions to construct a type from the provided field.
+    GffField::Type_BYTE ConstructBYTE(GffField const& field) const;
+    GffField::Type_CHAR ConstructCHAR(GffField const& field) const;
+    GffField::Type_WORD ConstructWORD(GffField const& field) const;
+    GffField::Type_SHORT ConstructSHORT(GffField const& field) const;
+    GffField::Type_DWORD ConstructDWORD(GffField const& field) const;
+    GffField::Type_INT ConstructINT(GffField const& field) const;
+    GffField::Type_DWORD64 ConstructDWORD64(GffField const& field) const;
+    GffField::Type_INT64 ConstructINT64(GffField const& field) const;
+    GffField::Type_FLOAT ConstructFLOAT(GffField const& field) const;
+    GffField::Type_DOUBLE ConstructDOUBLE(GffField const& field) const;
+    GffField::Type_CExoString ConstructCExoString(GffField const& field) const;
+    GffField::Type_CResRef ConstructResRef(GffField const& field) const;
+    GffField::Type_CExoLocString ConstructCExoLocString(GffField const& field) const;
+    GffField::Type_VOID ConstructVOID(GffField const& field) const;
+    GffField::Type_Struct ConstructStruct(GffField const& field) const;
+    GffField::Type_List ConstructList(GffField const& field) const;
+
+    // See Gff::Project.
+    void Project(GffProjection const& projection, std::vector<GffField const*>* out) const;
+
+    // See Gff::ReadEvents. Together with ReadFromFile, this reads the file without copying anything out of it.
+    bool ReadEvents(GffEventHandler* handler) const;
+
+private:
+    // This is an RAII wrapper around the source of the sections above. It is shared so views can be copied cheaply.
+    // - If by bytes, this is nullptr.
+    // - If by byte vector, this will contain the vector.
+    // - If by file with the MemoryMap backend, this will contain the mapping.
+    // - If by file with the Read or Batched backends, this will contain the vector the file was read into.
+    std::shared_ptr<VirtualObject> m_DataBlockStorage;
+
+    bool ConstructInternal(std::byte const* bytes, std::size_t bytesCount);
+};
+
+// GffPatcher overwrites fixed-size fields in place, in a mapped file or a caller's buffer, without decoding or
+// re-serialising anything else. These are the types stored either inline in the field or in a fixed size slot in
+// the field data: BYTE, CHAR, WORD, SHORT, DWORD, INT, FLOAT, DWORD64, INT64 and DOUBLE.
+//
+// Anything which changes the size of the file - strings, resrefs, adding or removing fields - can't be patched.
+// For those, fall back to a rewrite: construct a Friendly::Gff from GetView(), modify it, and write it out.
+//
+//     GffPatcher patcher;
+//     GffPatcher::ReadFromFile("nw_chicken.utc", &patcher);
+//     GffField const* appearance = patcher.FindField("Appearance_Type");
+//     if (appearance && patcher.PatchDWORD(*appearance, 31)) { ... }
+struct GffPatcher
+{
+    // Constructs a GffPatcher over a non-owning, writable pointer. The bytes must outlive the patcher.
+    static bool ReadFromBytes(std::byte* bytes, std::size_t bytesCount, GffPatcher* out);
+
+    // Constructs a GffPatcher over a writable mapping of the file. Patches are written straight through to the file.
+    static bool ReadFromFile(char const* path, GffPatcher* out);
+
+    // A read-only view of the same bytes. Patches are visible through it immediately.
+    GffView const& GetView() const;
+
+    // Finds the field at the path, using the same syntax as GffProjection (e.g. "ItemList[3]/Cost").
+    // Returns nullptr if the path is malformed or the field doesn't exist.
+    GffField const* FindField(std::string const& path) const;
+
+    // Below are functions to overwrite the value of the provided field, which must belong to this patcher.
+    // Each returns false, without writing anything, if the field is of a different type or (for the 64 bit types)
+    // its data offset runs past the end of the field data.
+    bool PatchBYTE(GffField const& field, GffField::Type_BYTE value);
+    bool PatchCHAR(GffField const& field, GffField::Type_CHAR value);
+    bool PatchWORD(GffField const& field, GffField::Type_WORD value);
+    bool PatchSHORT(GffField const& field, GffField::Type_SHORT value);
+    bool PatchDWORD(GffField const& field, GffField::Type_DWORD value);
+    bool PatchINT(GffField const& field, GffField::Type_INT value);
+    bool PatchDWORD64(GffField const& field, GffField::Type_DWORD64 value);
+    bool PatchINT64(GffField const& field, GffField::Type_INT64 value);
+    bool PatchFLOAT(GffField const& field, GffField::Type_FLOAT value);
+    bool PatchDOUBLE(GffField const& field, GffField::Type_DOUBLE value);
+
+    // If constructed from a file, blocks until every patch so far has reached the disk. Otherwise, does nothing.
+    bool Flush();
+
+private:
+    GffView m_View;
+
+    // The start of the bytes the view was constructed over, for writing.
+    std::byte* m_Bytes = nullptr;
+
+    // If constructed from a file, the writable mapping. Otherwise, nullptr.
+    std::shared_ptr<MemoryMappedFile> m_MappedFile;
+
+    template <typename T>
+    bool PatchInline(GffField const& field, GffField::Type type, T value);
+
+    template <typename T>
+    bool PatchFieldData(GffField const& field, GffField::Type type, T value);
+};
+
 }
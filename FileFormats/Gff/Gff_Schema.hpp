@@ -0,0 +1,392 @@
+#pragma once
+
+#include "FileFormats/Gff/Gff_Friendly.hpp"
+#include "FileFormats/Gff/Gff_Raw.hpp"
+#include "Utility/Assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// This file provides typed binding between plain C++ structs and GFF structs.
+//
+// Declare a struct, then describe which GFF label maps to which member by specialising GffSchema:
+//
+//     struct Variable
+//     {
+//         Friendly::Type_CExoString m_Name;
+//         Friendly::Type_DWORD m_Type;
+//     };
+//
+//     template <> struct GffSchema<Variable>
+//     {
+//         static constexpr auto Fields = std::make_tuple(
+//             Bind<Variable>("Name", &Variable::m_Name),
+//             Bind<Variable>("Type", &Variable::m_Type));
+//     };
+//
+// Schema::Decode(rawGff, &out) then fills the struct straight from a Raw::Gff or Raw::GffView in a single pass.
+// The labels in the file are resolved to members once per file (for each schema) rather than once per field, and no
+// Friendly::GffStruct is built along the way.
+//
+// Members may be:
+// - Any of the Friendly::Type_* types. The GFF field must be exactly that type.
+// - Friendly::GffFieldValue, which accepts a field of any type (e.g. the Value of a VarTable entry).
+// - Another struct with a GffSchema, bound to a struct field.
+// - A std::vector of a struct with a GffSchema, bound to a list field.
+//
+// Fields in the file which aren't in the schema are skipped. Members which aren't in the file keep whatever value
+// they had before decoding. A schema may also provide `static constexpr auto StructId = &T::m_Member;` to receive
+// the user defined ID of the struct (e.g. the equipment slot of an Equip_ItemList entry).
+
+namespace FileFormats::Gff::Schema {
+
+template <typename T>
+struct GffSchema;
+
+template <typename Owner, typename Member>
+struct FieldBinding
+{
+    char const* m_Label;
+    Member Owner::* m_Member;
+};
+
+// Owner is provided explicitly so that members inherited from a base struct bind against the derived struct.
+template <typename Owner, typename Member, typename Base>
+constexpr FieldBinding<Owner, Member> Bind(char const* label, Member Base::* member)
+{
+    return FieldBinding<Owner, Member> { label, member };
+}
+
+template <typename T, typename = void>
+struct HasGffSchema : std::false_type { };
+
+template <typename T>
+struct HasGffSchema<T, std::void_t<decltype(GffSchema<T>::Fields)>> : std::true_type { };
+
+// Decodes the top level struct of the GFF into out.
+// Returns false if a field which the schema binds has a different type in the file than the schema expects.
+template <typename T, typename RawGff>
+bool Decode(RawGff const& rawGff, T* out);
+
+// Maps the file and decodes the top level struct into out.
+template <typename T>
+bool ReadFromFile(char const* path, T* out);
+
+namespace Detail {
+
+template <typename T, typename = void>
+struct HasStructId : std::false_type { };
+
+template <typename T>
+struct HasStructId<T, std::void_t<decltype(GffSchema<T>::StructId)>> : std::true_type { };
+
+template <typename T>
+struct IsSchemaList : std::false_type { };
+
+template <typename T>
+struct IsSchemaList<std::vector<T>> : HasGffSchema<T> { };
+
+template <typename T>
+constexpr std::size_t FieldCount = std::tuple_size_v<std::decay_t<decltype(GffSchema<T>::Fields)>>;
+
+constexpr std::uint16_t UnboundSlot = 0xFFFF;
+
+using SortedLabels = std::vector<std::pair<Friendly::GffFieldLabel, std::uint16_t>>;
+
+// Each schema gets a small index on first use so the decoder can keep its per-file state in a flat array.
+inline std::size_t AllocateSchemaIndex()
+{
+    static std::atomic<std::size_t> s_NextIndex = 0;
+    return s_NextIndex++;
+}
+
+template <typename T>
+std::size_t GetSchemaIndex()
+{
+    static std::size_t const s_Index = AllocateSchemaIndex();
+    return s_Index;
+}
+
+// Returns the labels of T's schema paired with their position in the schema, sorted by label.
+template <typename T>
+SortedLabels const& GetSortedLabels()
+{
+    static SortedLabels const s_Labels = []()
+    {
+        static_assert(FieldCount<T> < UnboundSlot, "Too many fields in the schema.");
+
+        SortedLabels labels;
+        labels.reserve(FieldCount<T>);
+
+        std::apply([&labels](auto const&... binding)
+        {
+            (labels.emplace_back(Friendly::GffFieldLabel(binding.m_Label), static_cast<std::uint16_t>(labels.size())), ...);
+        }, GffSchema<T>::Fields);
+
+        std::sort(std::begin(labels), std::end(labels),
+            [](SortedLabels::value_type const& lhs, SortedLabels::value_type const& rhs) { return lhs.first < rhs.first; });
+
+        ASSERT_MSG(std::adjacent_find(std::begin(labels), std::end(labels),
+            [](SortedLabels::value_type const& lhs, SortedLabels::value_type const& rhs) { return lhs.first == rhs.first; })
+                == std::end(labels), "The same label is bound twice in a schema.");
+
+        return labels;
+    }();
+
+    return s_Labels;
+}
+
+template <typename M, typename RawGff>
+M ConstructValue(RawGff const& rawGff, Raw::GffField const& field)
+{
+    if constexpr (std::is_same_v<M, Friendly::Type_BYTE>) return rawGff.ConstructBYTE(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_CHAR>) return rawGff.ConstructCHAR(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_WORD>) return rawGff.ConstructWORD(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_SHORT>) return rawGff.ConstructSHORT(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_DWORD>) return rawGff.ConstructDWORD(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_INT>) return rawGff.ConstructINT(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_DWORD64>) return rawGff.ConstructDWORD64(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_INT64>) return rawGff.ConstructINT64(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_FLOAT>) return rawGff.ConstructFLOAT(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_DOUBLE>) return rawGff.ConstructDOUBLE(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_CExoString>) return rawGff.ConstructCExoString(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_CResRef>) return rawGff.ConstructResRef(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_CExoLocString>) return rawGff.ConstructCExoLocString(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_VOID>) return rawGff.ConstructVOID(field);
+    else if constexpr (std::is_same_v<M, Friendly::Type_Struct>) return Friendly::GffStruct(field, rawGff);
+    else return Friendly::GffList(field, rawGff);
+}
+
+// Decodes one file. Holds the label -> member resolution for each schema it has seen in this file.
+template <typename RawGff>
+class Decoder
+{
+public:
+    explicit Decoder(RawGff const& rawGff) : m_RawGff(rawGff)
+    { }
+
+    template <typename T>
+    bool DecodeStruct(Raw::GffStruct const& rawStruct, T* out)
+    {
+        if constexpr (HasStructId<T>::value)
+        {
+            out->*GffSchema<T>::StructId = rawStruct.m_Type;
+        }
+
+        // See Friendly::GffStruct - ill-formed empty structs are tolerated.
+        if (!rawStruct.m_FieldCount || rawStruct.m_DataOrDataOffset == 0xFFFFFFFF)
+        {
+            return true;
+        }
+
+        std::vector<std::uint16_t> const& slots = GetSlots<T>();
+
+        if (rawStruct.m_FieldCount == 1)
+        {
+            ASSERT(rawStruct.m_DataOrDataOffset < m_RawGff.m_Fields.size());
+            return DecodeField(m_RawGff.m_Fields[rawStruct.m_DataOrDataOffset], slots, out);
+        }
+
+        std::uint32_t offsetIntoFieldIndexArray = rawStruct.m_DataOrDataOffset / sizeof(Raw::GffFieldIndex);
+        ASSERT(offsetIntoFieldIndexArray < m_RawGff.m_FieldIndices.size());
+
+        for (std::size_t i = 0; i < rawStruct.m_FieldCount; ++i)
+        {
+            std::uint32_t offsetIntoFieldArray = m_RawGff.m_FieldIndices[offsetIntoFieldIndexArray + i];
+            ASSERT(offsetIntoFieldArray < m_RawGff.m_Fields.size());
+
+            if (!DecodeField(m_RawGff.m_Fields[offsetIntoFieldArray], slots, out))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    template <typename T>
+    using SlotDecoder = bool (*)(Decoder&, Raw::GffField const&, T*);
+
+    // Returns, for each label in the file, the index of the schema field it binds to (or UnboundSlot).
+    // This is the only place labels are compared, and it happens once per schema per file.
+    template <typename T>
+    std::vector<std::uint16_t> const& GetSlots()
+    {
+        std::size_t schemaIndex = GetSchemaIndex<T>();
+
+        if (schemaIndex >= m_Slots.size())
+        {
+            m_Slots.resize(schemaIndex + 1);
+        }
+
+        std::vector<std::uint16_t>& slots = m_Slots[schemaIndex];
+
+        if (slots.size() != m_RawGff.m_Labels.size())
+        {
+            SortedLabels const& labels = GetSortedLabels<T>();
+            slots.assign(m_RawGff.m_Labels.size(), UnboundSlot);
+
+            for (std::size_t i = 0; i < m_RawGff.m_Labels.size(); ++i)
+            {
+                Friendly::GffFieldLabel label = m_RawGff.m_Labels[i];
+
+                auto entry = std::lower_bound(std::begin(labels), std::end(labels), label,
+                    [](SortedLabels::value_type const& lhs, Friendly::GffFieldLabel const& rhs) { return lhs.first < rhs; });
+
+                if (entry != std::end(labels) && entry->first == label)
+                {
+                    slots[i] = entry->second;
+                }
+            }
+        }
+
+        return slots;
+    }
+
+    template <typename T>
+    bool DecodeField(Raw::GffField const& field, std::vector<std::uint16_t> const& slots, T* out)
+    {
+        ASSERT(field.m_LabelIndex < slots.size());
+        std::uint16_t slot = slots[field.m_LabelIndex];
+
+        if (slot == UnboundSlot)
+        {
+            return true;
+        }
+
+        return GetDispatchTable<T>()[slot](*this, field, out);
+    }
+
+    template <typename T, std::size_t Index>
+    static bool DecodeSlot(Decoder& decoder, Raw::GffField const& field, T* out)
+    {
+        auto const& binding = std::get<Index>(GffSchema<T>::Fields);
+        return decoder.DecodeMember(field, &(out->*binding.m_Member));
+    }
+
+    template <typename T, std::size_t... Indices>
+    static constexpr std::array<SlotDecoder<T>, sizeof...(Indices)> MakeDispatchTable(std::index_sequence<Indices...>)
+    {
+        return { &DecodeSlot<T, Indices>... };
+    }
+
+    template <typename T>
+    static SlotDecoder<T> const* GetDispatchTable()
+    {
+        static constexpr std::array<SlotDecoder<T>, FieldCount<T>> s_Table =
+            MakeDispatchTable<T>(std::make_index_sequence<FieldCount<T>>());
+        return s_Table.data();
+    }
+
+    template <typename M>
+    bool DecodeMember(Raw::GffField const& field, M* out)
+    {
+        if constexpr (std::is_same_v<M, Friendly::GffFieldValue>)
+        {
+            switch (field.m_Type)
+            {
+                case Raw::GffField::Type::BYTE:          *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_BYTE>(m_RawGff, field)); break;
+                case Raw::GffField::Type::CHAR:          *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_CHAR>(m_RawGff, field)); break;
+                case Raw::GffField::Type::WORD:          *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_WORD>(m_RawGff, field)); break;
+                case Raw::GffField::Type::SHORT:         *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_SHORT>(m_RawGff, field)); break;
+                case Raw::GffField::Type::DWORD:         *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_DWORD>(m_RawGff, field)); break;
+                case Raw::GffField::Type::INT:           *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_INT>(m_RawGff, field)); break;
+                case Raw::GffField::Type::DWORD64:       *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_DWORD64>(m_RawGff, field)); break;
+                case Raw::GffField::Type::INT64:         *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_INT64>(m_RawGff, field)); break;
+                case Raw::GffField::Type::FLOAT:         *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_FLOAT>(m_RawGff, field)); break;
+                case Raw::GffField::Type::DOUBLE:        *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_DOUBLE>(m_RawGff, field)); break;
+                case Raw::GffField::Type::CExoString:    *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_CExoString>(m_RawGff, field)); break;
+                case Raw::GffField::Type::ResRef:        *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_CResRef>(m_RawGff, field)); break;
+                case Raw::GffField::Type::CExoLocString: *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_CExoLocString>(m_RawGff, field)); break;
+                case Raw::GffField::Type::VOID:          *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_VOID>(m_RawGff, field)); break;
+                case Raw::GffField::Type::Struct:        *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_Struct>(m_RawGff, field)); break;
+                case Raw::GffField::Type::List:          *out = Friendly::GffFieldValue(ConstructValue<Friendly::Type_List>(m_RawGff, field)); break;
+                default: return false;
+            }
+
+            return true;
+        }
+        else if constexpr (HasGffSchema<M>::value)
+        {
+            if (field.m_Type != Raw::GffField::Type::Struct)
+            {
+                return false;
+            }
+
+            return DecodeStruct(m_RawGff.ConstructStruct(field), out);
+        }
+        else if constexpr (IsSchemaList<M>::value)
+        {
+            if (field.m_Type != Raw::GffField::Type::List)
+            {
+                return false;
+            }
+
+            Raw::GffField::Type_List list = m_RawGff.ConstructList(field);
+            out->clear();
+            out->resize(list.m_Elements.size());
+
+            for (std::size_t i = 0; i < list.m_Elements.size(); ++i)
+            {
+                std::uint32_t offsetIntoStructArray = list.m_Elements[i];
+                ASSERT(offsetIntoStructArray < m_RawGff.m_Structs.size());
+
+                if (!DecodeStruct(m_RawGff.m_Structs[offsetIntoStructArray], &(*out)[i]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+        else
+        {
+            if (field.m_Type != Friendly::GffFieldTypeOf<M>::Value)
+            {
+                return false;
+            }
+
+            *out = ConstructValue<M>(m_RawGff, field);
+            return true;
+        }
+    }
+
+    RawGff const& m_RawGff;
+
+    // Indexed by GetSchemaIndex<T>(), then by label index in the file.
+    // A deque because decoding a nested schema can add entries while a reference to an outer one is held.
+    std::deque<std::vector<std::uint16_t>> m_Slots;
+};
+
+}
+
+template <typename T, typename RawGff>
+bool Decode(RawGff const& rawGff, T* out)
+{
+    static_assert(HasGffSchema<T>::value, "Decode requires a GffSchema specialisation for T.");
+    ASSERT(out);
+
+    if (rawGff.m_Structs.empty())
+    {
+        return false;
+    }
+
+    return Detail::Decoder<RawGff>(rawGff).DecodeStruct(rawGff.m_Structs[0], out);
+}
+
+template <typename T>
+bool ReadFromFile(char const* path, T* out)
+{
+    Raw::GffView view;
+    return Raw::GffView::ReadFromFile(path, &view) && Decode(view, out);
+}
+
+}
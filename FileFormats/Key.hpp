@@ -10,9 +10,12 @@
 // Step 2: Construct a Key as such: FileFormats::Key::Raw::Key::ReadFromBytes(bytes);
 // Step 3: If user friendly access is desired, construct a Key from FileFormats::Key::Friendly::Key(rawKey).
 // - Referenced BIFs can be accessed by .GetReferencedBifs().
-// - Referenced resources can be accessed by .GetReferencedResources().
+// - Referenced resources can be accessed by .GetReferencedResources(). Their names are Resource::ResRef, which is
+//   already lowercased, so it can be compared or used as a hash key directly.
 // - Refer to Example_Key.cpp if the usage is unclear.
 //
+// Both the raw and friendly Key can allocate from a std::pmr::memory_resource given on construction.
+//
 // For further information refer to https://wiki.neverwintervault.org/pages/viewpage.action?pageId=327727
 // Specifically, https://wiki.neverwintervault.org/download/attachments/327727/Bioware_Aurora_KeyBIF_Format.pdf?api=v2
 
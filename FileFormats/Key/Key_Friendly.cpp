@@ -6,21 +6,27 @@
 
 namespace FileFormats::Key::Friendly {
 
-Key::Key(Raw::Key const& rawKey)
+Key::Key(Raw::Key const& rawKey, std::pmr::memory_resource* resource)
+    : m_ReferencedBifs(resource),
+      m_ReferencedResources(resource)
 {
     // Get the referenced BIFs.
+    m_ReferencedBifs.reserve(rawKey.m_Files.size());
+
     for (Raw::KeyFile const& rawFile : rawKey.m_Files)
     {
-        KeyBifReference reference;
-        reference.m_Drives = rawFile.m_Drives;
-        reference.m_FileSize = rawFile.m_FileSize;
-
         std::uint32_t offSetStartIntoFilenameTable = rawKey.m_Header.m_OffsetToFileTable + (rawKey.m_Header.m_BIFCount * sizeof(Raw::KeyFile)); // End of file table
         std::uint32_t offSetIntoFilenameTable = rawFile.m_FilenameOffset - offSetStartIntoFilenameTable;
         ASSERT(offSetStartIntoFilenameTable + offSetIntoFilenameTable + rawFile.m_FilenameSize <= rawKey.m_Header.m_OffsetToKeyTable);
 
         char const* ptr = rawKey.m_Filenames.data() + offSetIntoFilenameTable;
-        reference.m_Path = std::string(ptr, strnlen(ptr, rawFile.m_FilenameSize));
+
+        // The path is constructed in place, since assigning a string from the resource to one which isn't
+        // would copy it back out to the heap.
+        KeyBifReference reference {
+            rawFile.m_Drives,
+            std::pmr::string(ptr, strnlen(ptr, rawFile.m_FilenameSize), resource),
+            rawFile.m_FileSize };
 
         // Replace all back slash with forward slashes. This avoids any nasty platform-related issues.
         std::replace(std::begin(reference.m_Path), std::end(reference.m_Path), '\\', '/');
@@ -29,31 +35,27 @@ Key::Key(Raw::Key const& rawKey)
     }
 
     // Get the references resources.
+    m_ReferencedResources.reserve(rawKey.m_Entries.size());
+
     for (Raw::KeyEntry const& rawEntry : rawKey.m_Entries)
     {
-        std::string resref = std::string(rawEntry.m_ResRef, rawEntry.m_ResRef + strnlen(rawEntry.m_ResRef, 16));
-
-        // NWN is case insensitive and cases are mixed like crazy in the official modules.
-        // We just do the conversion to lower here to simplify things.
-        std::transform(std::begin(resref), std::end(resref), std::begin(resref), ::tolower);
-
-        KeyBifReferencedResource entry;
-        entry.m_ResRef = std::move(resref);
-        entry.m_ResType = rawEntry.m_ResourceType;
-        entry.m_ResId = rawEntry.m_ResID;
-        entry.m_ReferencedBifResId = rawEntry.m_ResID & 0x00003FFF; // See Bif_Friendly.cpp for explanation.
-        entry.m_ReferencedBifIndex = rawEntry.m_ResID >> 20;
+        KeyBifReferencedResource entry {
+            Resource::ResRef::FromRawResRef(rawEntry.m_ResRef),
+            rawEntry.m_ResourceType,
+            rawEntry.m_ResID,
+            rawEntry.m_ResID & 0x00003FFF, // See Bif_Friendly.cpp for explanation.
+            rawEntry.m_ResID >> 20 };
 
         m_ReferencedResources.emplace_back(std::move(entry));
     }
 }
 
-std::vector<KeyBifReference> const& Key::GetReferencedBifs() const
+std::pmr::vector<KeyBifReference> const& Key::GetReferencedBifs() const
 {
     return m_ReferencedBifs;
 }
 
-std::vector<KeyBifReferencedResource> const& Key::GetReferencedResources() const
+std::pmr::vector<KeyBifReferencedResource> const& Key::GetReferencedResources() const
 {
     return m_ReferencedResources;
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "FileFormats/Key/Key_Raw.hpp"
+#include "FileFormats/ResRef.hpp"
+
+#include <memory_resource>
 #include <string>
 
 namespace FileFormats::Key::Friendly {
@@ -12,7 +15,7 @@ struct KeyBifReference
     std::uint16_t m_Drives;
 
     // The path (relative to the root of the drive above) of the BIF.
-    std::string m_Path;
+    std::pmr::string m_Path;
 
     // Total byte size of the BIF.
     std::uint32_t m_FileSize;
@@ -21,7 +24,7 @@ struct KeyBifReference
 struct KeyBifReferencedResource
 {
     // The file name of the resource.
-    std::string m_ResRef;
+    Resource::ResRef m_ResRef;
 
     // The type of the resource.
     Resource::ResourceType m_ResType;
@@ -41,14 +44,15 @@ struct KeyBifReferencedResource
 class Key
 {
 public:
-    Key(Raw::Key const& rawKey);
+    // Both tables, and the paths within them, are allocated from the resource. It must outlive the Key.
+    Key(Raw::Key const& rawKey, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
-    std::vector<KeyBifReference> const& GetReferencedBifs() const;
-    std::vector<KeyBifReferencedResource> const& GetReferencedResources() const;
+    std::pmr::vector<KeyBifReference> const& GetReferencedBifs() const;
+    std::pmr::vector<KeyBifReferencedResource> const& GetReferencedResources() const;
 
 private:
-    std::vector<KeyBifReference> m_ReferencedBifs;
-    std::vector<KeyBifReferencedResource> m_ReferencedResources;
+    std::pmr::vector<KeyBifReference> m_ReferencedBifs;
+    std::pmr::vector<KeyBifReferencedResource> m_ReferencedResources;
 };
 
 }
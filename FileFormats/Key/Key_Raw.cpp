@@ -1,13 +1,14 @@
 #include "FileFormats/Key/Key_Raw.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/FileReader.hpp"
 #include "Utility/MemoryMappedFile.hpp"
 
 #include <cstring>
 
 namespace {
 
-template <typename T>
-void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T>& out)
+template <typename T, typename Allocator>
+void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T, Allocator>& out)
 {
     out.resize(count);
     std::memcpy(out.data(), bytesWithInitialOffset, count * sizeof(T));
@@ -17,6 +18,12 @@ void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t
 
 namespace FileFormats::Key::Raw {
 
+Key::Key(std::pmr::memory_resource* resource)
+    : m_Files(resource),
+      m_Filenames(resource),
+      m_Entries(resource)
+{ }
+
 bool Key::ReadFromBytes(std::byte const* bytes, Key* out)
 {
     ASSERT(bytes);
@@ -31,13 +38,19 @@ bool Key::ReadFromByteVector(std::vector<std::byte>&& bytes, Key* out)
     return out->ConstructInternal(bytes.data());
 }
 
-bool Key::ReadFromFile(char const* path, Key* out)
+bool Key::ReadFromFile(char const* path, Key* out, FileReadOptions const& options)
 {
     ASSERT(path);
     ASSERT(out);
 
+    if (options.m_Backend != FileReadBackend::MemoryMap)
+    {
+        std::vector<std::byte> bytes;
+        return ReadEntireFile(path, &bytes) && ReadFromByteVector(std::move(bytes), out);
+    }
+
     MemoryMappedFile memmap;
-    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap);
+    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap, options.m_Hints);
 
     if (!loaded)
     {
@@ -86,6 +99,7 @@ void Key::ReadEntries(std::byte const* data)
     std::uint32_t count = m_Header.m_KeyCount;
 
     data = data + offset;
+    m_Entries.reserve(count);
 
     for (std::size_t i = 0; i < count; ++i)
     {
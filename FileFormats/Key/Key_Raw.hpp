@@ -1,8 +1,10 @@
 #pragma once
 
 #include "FileFormats/Resource.hpp"
+#include "Utility/FileReader.hpp"
 
 #include <cstddef>
+#include <memory_resource>
 #include <vector>
 
 namespace FileFormats::Key::Raw {
@@ -88,10 +90,15 @@ struct KeyEntry
 
 struct Key
 {
+    Key() = default;
+
+    // Reading into a Key constructed this way allocates its tables from the resource, which must outlive it.
+    explicit Key(std::pmr::memory_resource* resource);
+
     KeyHeader m_Header;
-    std::vector<KeyFile> m_Files;
-    std::vector<KeyFilename> m_Filenames;
-    std::vector<KeyEntry> m_Entries;
+    std::pmr::vector<KeyFile> m_Files;
+    std::pmr::vector<KeyFilename> m_Filenames;
+    std::pmr::vector<KeyEntry> m_Entries;
 
     // Constructs an Key from a non-owning pointer.
     static bool ReadFromBytes(std::byte const* bytes, Key* out);
@@ -100,7 +107,7 @@ struct Key
     static bool ReadFromByteVector(std::vector<std::byte>&& bytes, Key* out);
 
     // Constructs an Key from a file.
-    static bool ReadFromFile(char const* path, Key* out);
+    static bool ReadFromFile(char const* path, Key* out, FileReadOptions const& options = FileReadOptions());
 
 private:
     bool ConstructInternal(std::byte const* bytes);
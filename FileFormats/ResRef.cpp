@@ -0,0 +1,75 @@
+#include "FileFormats/ResRef.hpp"
+#include "Utility/Assert.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define RESREF_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define RESREF_SSE2 0
+#endif
+
+namespace FileFormats::Resource {
+
+ResRef::ResRef(std::string_view resref) : m_ResRef()
+{
+    ASSERT_MSG(resref.size() <= sizeof(m_ResRef), "ResRefs are limited to 16 characters. %.*s will be truncated.",
+        static_cast<int>(resref.size()), resref.data());
+    std::memcpy(m_ResRef, resref.data(), std::min(resref.size(), sizeof(m_ResRef)));
+    Normalise();
+}
+
+ResRef ResRef::FromRawResRef(char const* data)
+{
+    ResRef resref;
+    std::memcpy(resref.m_ResRef, data, sizeof(resref.m_ResRef));
+    resref.Normalise();
+    return resref;
+}
+
+void ResRef::Normalise()
+{
+#if RESREF_SSE2
+    // All 16 characters are handled at once: the nulls give a mask of the characters to keep, and the characters
+    // between A and Z get 0x20 added. The comparisons are signed, so bytes above 0x7F never count as upper case.
+    __m128i chars = _mm_load_si128(reinterpret_cast<__m128i const*>(m_ResRef));
+
+    int nulls = _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_setzero_si128()));
+
+    if (nulls)
+    {
+    #if CMP_MSVC
+        unsigned long length;
+        _BitScanForward(&length, static_cast<unsigned long>(nulls));
+    #else
+        int length = __builtin_ctz(static_cast<unsigned>(nulls));
+    #endif
+
+        __m128i indices = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        __m128i keep = _mm_cmplt_epi8(indices, _mm_set1_epi8(static_cast<char>(length)));
+        chars = _mm_and_si128(chars, keep);
+    }
+
+    __m128i upper = _mm_and_si128(
+        _mm_cmpgt_epi8(chars, _mm_set1_epi8('A' - 1)),
+        _mm_cmplt_epi8(chars, _mm_set1_epi8('Z' + 1)));
+    chars = _mm_add_epi8(chars, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+
+    _mm_store_si128(reinterpret_cast<__m128i*>(m_ResRef), chars);
+#else
+    std::size_t length = strnlen(m_ResRef, sizeof(m_ResRef));
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        if (m_ResRef[i] >= 'A' && m_ResRef[i] <= 'Z')
+        {
+            m_ResRef[i] = static_cast<char>(m_ResRef[i] + ('a' - 'A'));
+        }
+    }
+
+    std::memset(m_ResRef + length, 0, sizeof(m_ResRef) - length);
+#endif
+}
+
+}
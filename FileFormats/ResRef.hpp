@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace FileFormats::Resource {
+
+// The name of a resource. A ResRef is at most 16 characters and case insensitive - NWN mixes cases freely, and
+// the official modules are no exception - so it is stored inline as a fixed 16 byte key, lowercased, with the
+// unused characters zeroed. Two ResRefs naming the same resource are then the same bytes, and are compared and
+// hashed as two 64-bit words.
+class ResRef
+{
+public:
+    ResRef();
+    ResRef(char const* resref);
+    ResRef(std::string const& resref);
+    ResRef(std::string_view resref);
+
+    // Constructs a ResRef from a 16 character field as it is stored in a KEY, ERF or TLK. The field is not null
+    // terminated if the name is 16 characters long, and anything after the first null is ignored.
+    static ResRef FromRawResRef(char const* data);
+
+    // Returns the lowercase name without the trailing nulls.
+    std::string_view GetString() const;
+
+    // Copies the name into a raw 16 character field, padding it with nulls.
+    void ToRawResRef(char* data) const;
+
+    bool IsEmpty() const;
+
+    bool operator==(ResRef const& rhs) const;
+    bool operator!=(ResRef const& rhs) const;
+
+    // Orders names alphabetically.
+    bool operator<(ResRef const& rhs) const;
+
+    std::size_t GetHash() const;
+
+private:
+    // Zeroes everything from the first null onwards and lowercases the rest.
+    void Normalise();
+
+    std::uint64_t GetWord(std::size_t index) const;
+
+    alignas(16) char m_ResRef[16];
+};
+
+inline ResRef::ResRef() : m_ResRef()
+{ }
+
+inline ResRef::ResRef(char const* resref) : ResRef(std::string_view(resref))
+{ }
+
+inline ResRef::ResRef(std::string const& resref) : ResRef(std::string_view(resref))
+{ }
+
+inline std::string_view ResRef::GetString() const
+{
+    return std::string_view(m_ResRef, strnlen(m_ResRef, sizeof(m_ResRef)));
+}
+
+inline void ResRef::ToRawResRef(char* data) const
+{
+    std::memcpy(data, m_ResRef, sizeof(m_ResRef));
+}
+
+inline bool ResRef::IsEmpty() const
+{
+    return m_ResRef[0] == '\0';
+}
+
+inline bool ResRef::operator==(ResRef const& rhs) const
+{
+    return GetWord(0) == rhs.GetWord(0) && GetWord(1) == rhs.GetWord(1);
+}
+
+inline bool ResRef::operator!=(ResRef const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+inline bool ResRef::operator<(ResRef const& rhs) const
+{
+    // The words are loaded little endian, so swap them to get the same ordering as comparing the characters.
+#if CMP_MSVC
+    std::uint64_t lhsHigh = _byteswap_uint64(GetWord(0));
+    std::uint64_t rhsHigh = _byteswap_uint64(rhs.GetWord(0));
+    std::uint64_t lhsLow = _byteswap_uint64(GetWord(1));
+    std::uint64_t rhsLow = _byteswap_uint64(rhs.GetWord(1));
+#else
+    std::uint64_t lhsHigh = __builtin_bswap64(GetWord(0));
+    std::uint64_t rhsHigh = __builtin_bswap64(rhs.GetWord(0));
+    std::uint64_t lhsLow = __builtin_bswap64(GetWord(1));
+    std::uint64_t rhsLow = __builtin_bswap64(rhs.GetWord(1));
+#endif
+
+    return lhsHigh < rhsHigh || (lhsHigh == rhsHigh && lhsLow < rhsLow);
+}
+
+inline std::size_t ResRef::GetHash() const
+{
+    // Names within an archive tend to share prefixes and numbered suffixes (it_mring001, it_mring002, ...), so
+    // mix both words into every bit of the result.
+    std::uint64_t hash = GetWord(0) ^ (GetWord(1) * 0x9E3779B97F4A7C15ull);
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return static_cast<std::size_t>(hash);
+}
+
+inline std::uint64_t ResRef::GetWord(std::size_t index) const
+{
+    std::uint64_t word;
+    std::memcpy(&word, m_ResRef + index * sizeof(word), sizeof(word));
+    return word;
+}
+
+}
+
+namespace std {
+
+template <>
+struct hash<FileFormats::Resource::ResRef>
+{
+    std::size_t operator()(FileFormats::Resource::ResRef const& resref) const
+    {
+        return resref.GetHash();
+    }
+};
+
+}
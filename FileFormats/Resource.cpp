@@ -67,7 +67,7 @@ ResourceContentType ResourceContentTypeFromResourceType(ResourceType res)
     return ResourceContentType::Binary;
 }
 
-ResourceType ResourceTypeFromString(char const* str)
+ResourceType TryResourceTypeFromString(char const* str)
 {
 #if CMP_MSVC && OS_WINDOWS
     #define CASE_INSENSITIVE_CMP _stricmp
@@ -127,12 +127,18 @@ ResourceType ResourceTypeFromString(char const* str)
     else if (CASE_INSENSITIVE_CMP(str, "bif") == 0) return ResourceType::BIF;
     else if (CASE_INSENSITIVE_CMP(str, "key") == 0) return ResourceType::KEY;
 
-    ASSERT_FAIL_MSG("Unknown resource type.");
     return ResourceType::INVALID;
 
 #undef CASE_INSENSITIVE_CMP
 }
 
+ResourceType ResourceTypeFromString(char const* str)
+{
+    ResourceType type = TryResourceTypeFromString(str);
+    ASSERT_MSG(type != ResourceType::INVALID, "Unknown resource type %s.", str);
+    return type;
+}
+
 char const* StringFromResourceType(ResourceType res)
 {
     if (res == ResourceType::BMP) return "bmp";
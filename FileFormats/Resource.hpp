@@ -195,6 +195,10 @@ enum class ResourceContentType
 
 ResourceContentType ResourceContentTypeFromResourceType(ResourceType res);
 ResourceType ResourceTypeFromString(char const* str);
+
+// As above, but returns ResourceType::INVALID for a string which isn't a known type rather than asserting.
+ResourceType TryResourceTypeFromString(char const* str);
+
 char const* StringFromResourceType(ResourceType res);
 
 }
@@ -0,0 +1,1055 @@
+#include "FileFormats/ResourceManager.hpp"
+#include "FileFormats/Bif.hpp"
+#include "FileFormats/Erf.hpp"
+#include "FileFormats/Key.hpp"
+#include "Utility/Assert.hpp"
+#include "Utility/FileWriter.hpp"
+#include "Utility/FileReaderPool.hpp"
+#include "Utility/MemoryMappedFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+namespace {
+
+using namespace FileFormats::Resource;
+
+std::uint64_t HashResource(ResRef const& resref, ResourceType type)
+{
+    // The same name is often used for several types (a creature's .utc and its .dlg), so the type is mixed in too.
+    return static_cast<std::uint64_t>(resref.GetHash()) ^ (static_cast<std::uint64_t>(type) * 0x9E3779B97F4A7C15ull);
+}
+
+bool EntryLess(ResRef const& lhsResRef, ResourceType lhsType, ResRef const& rhsResRef, ResourceType rhsType)
+{
+    return lhsResRef < rhsResRef || (lhsResRef == rhsResRef && lhsType < rhsType);
+}
+
+// What a file looked like when it was added - compared against the file system to tell whether an index file is
+// still valid.
+struct FileStamp
+{
+    std::int64_t m_ModifiedTime;
+    std::uint64_t m_Size; // Zero for a directory.
+
+    bool operator==(FileStamp const& rhs) const
+    {
+        return m_ModifiedTime == rhs.m_ModifiedTime && m_Size == rhs.m_Size;
+    }
+};
+
+bool ReadFileStamp(char const* path, FileStamp* out)
+{
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    fs::file_time_type modifiedTime = fs::last_write_time(path, error);
+
+    if (error)
+    {
+        return false;
+    }
+
+    out->m_ModifiedTime = static_cast<std::int64_t>(modifiedTime.time_since_epoch().count());
+    out->m_Size = fs::is_directory(path, error) ? 0 : static_cast<std::uint64_t>(fs::file_size(path, error));
+    return !error;
+}
+
+// The layout of an index file. Every section is an array of the structs below (or of the ResourceManager's own
+// index slots and source entries) starting on a 16 byte boundary, so the sections are used where they are mapped.
+// The structs are written as they are laid out in memory - an index file is a cache for the host which wrote it,
+// not an interchange format.
+
+struct IndexFileHeader
+{
+    char m_FileType[4];
+    char m_Version[4];
+
+    // Guards against a file written by a build with a different layout.
+    std::uint32_t m_EntrySize;
+    std::uint32_t m_IndexSlotSize;
+
+    std::uint32_t m_SourceCount;
+    std::uint32_t m_FileCount;
+    std::uint32_t m_EntryCount;
+    std::uint32_t m_FilterWordCount;
+    std::uint32_t m_IndexSlotCount;
+    std::uint32_t m_ResourceCount;
+    std::uint32_t m_StringsSize;
+    std::uint32_t m_Padding;
+
+    std::uint64_t m_OffsetToSources;
+    std::uint64_t m_OffsetToFiles;
+    std::uint64_t m_OffsetToEntries;
+    std::uint64_t m_OffsetToFilter;
+    std::uint64_t m_OffsetToIndex;
+    std::uint64_t m_OffsetToStrings;
+};
+
+struct IndexFileString
+{
+    std::uint32_t m_Offset; // Into the strings section.
+    std::uint32_t m_Length;
+};
+
+struct IndexFileSource
+{
+    std::uint32_t m_Kind;
+    IndexFileString m_Path;
+    std::uint32_t m_FirstFile;
+    std::uint32_t m_FileCount;
+    std::uint32_t m_FirstEntry;
+    std::uint32_t m_EntryCount;
+    std::uint32_t m_FirstFilterWord;
+    std::uint32_t m_FilterWordCount;
+    std::uint32_t m_Padding;
+    FileStamp m_Stamp;
+};
+
+struct IndexFileFile
+{
+    IndexFileString m_Path;
+    FileStamp m_Stamp;
+};
+
+constexpr std::size_t IndexFileAlignment = 16;
+
+std::uint64_t AlignIndexFileOffset(std::uint64_t offset)
+{
+    return (offset + IndexFileAlignment - 1) & ~static_cast<std::uint64_t>(IndexFileAlignment - 1);
+}
+
+// Points the span at count elements of T at offset, if they are within the mapping and suitably aligned.
+template <typename T>
+bool ReadIndexFileSection(DataBlock const& data, std::uint64_t offset, std::uint64_t count, Span<T const>* out)
+{
+    if (offset % IndexFileAlignment != 0 || offset > data.GetDataLength() || count > (data.GetDataLength() - offset) / sizeof(T))
+    {
+        return false;
+    }
+
+    out->m_Data = reinterpret_cast<T const*>(data.GetData() + offset);
+    out->m_Count = static_cast<std::size_t>(count);
+    return true;
+}
+
+}
+
+namespace FileFormats::Resource {
+
+class ResourceManager::Source
+{
+public:
+    enum class Kind : std::uint32_t
+    {
+        Key,
+        Erf,
+        Directory
+    };
+
+    // A resource in the source: which of the source's files it is in, and where in that file. A resource from a
+    // directory is the whole of its file, so the offset and size aren't used.
+    struct Entry
+    {
+        ResRef m_ResRef;
+        ResourceType m_Type;
+        std::uint16_t m_Padding;
+        std::uint32_t m_File;
+        std::uint32_t m_Offset;
+        std::uint32_t m_Size;
+    };
+
+    // A file resources are read from - one of the BIFs of a KEY, the ERF itself, or one of the files in a directory.
+    struct File
+    {
+        std::string m_Path;
+        FileStamp m_Stamp;
+
+        // The BIF or ERF in the manager's pool, which opens it when a resource in it is opened.
+        FileReaderPool::FileId m_PoolFile = 0;
+    };
+
+    Source(Kind kind, std::string path, FileStamp stamp)
+        : m_Kind(kind),
+          m_Path(std::move(path)),
+          m_Stamp(stamp)
+    { }
+
+    Kind GetKind() const
+    {
+        return m_Kind;
+    }
+
+    std::string const& GetPath() const
+    {
+        return m_Path;
+    }
+
+    FileStamp const& GetStamp() const
+    {
+        return m_Stamp;
+    }
+
+    std::vector<File> const& GetFiles() const
+    {
+        return m_Files;
+    }
+
+    // Sorted by name then type. Where a source has more than one copy of a resource, they stay in the order they
+    // were added in.
+    Span<Entry const> GetEntries() const
+    {
+        return m_Entries;
+    }
+
+    Span<std::uint64_t const> GetFilter() const
+    {
+        return m_Filter;
+    }
+
+    std::uint32_t AddFile(std::string path, FileStamp stamp)
+    {
+        m_Files.emplace_back();
+        m_Files.back().m_Path = std::move(path);
+        m_Files.back().m_Stamp = stamp;
+        return static_cast<std::uint32_t>(m_Files.size() - 1);
+    }
+
+    void AddEntry(ResRef const& resref, ResourceType type, std::uint32_t file, std::uint32_t offset, std::uint32_t size)
+    {
+        m_OwnedEntries.push_back({ resref, type, 0, file, offset, size });
+    }
+
+    // Sorts the entries and builds the filter. This is called once every entry has been added.
+    void Finalise()
+    {
+        std::stable_sort(std::begin(m_OwnedEntries), std::end(m_OwnedEntries),
+            [](Entry const& lhs, Entry const& rhs)
+            {
+                return EntryLess(lhs.m_ResRef, lhs.m_Type, rhs.m_ResRef, rhs.m_Type);
+            });
+
+        // Ten bits per entry with four probes gives about one false positive in a hundred.
+        std::size_t bitCount = 64;
+        while (bitCount < m_OwnedEntries.size() * 10)
+        {
+            bitCount *= 2;
+        }
+
+        m_OwnedFilter.assign(bitCount / 64, 0);
+
+        for (Entry const& entry : m_OwnedEntries)
+        {
+            std::uint64_t hash = HashResource(entry.m_ResRef, entry.m_Type);
+
+            for (std::uint64_t i = 0; i < FilterProbeCount; ++i)
+            {
+                std::uint64_t bit = GetFilterBit(hash, i, bitCount - 1);
+                m_OwnedFilter[bit / 64] |= 1ull << (bit % 64);
+            }
+        }
+
+        m_Entries = { m_OwnedEntries.data(), m_OwnedEntries.size() };
+        m_Filter = { m_OwnedFilter.data(), m_OwnedFilter.size() };
+    }
+
+    // Registers the archives with the pool, to be read with the given options. This is called once every file has
+    // been added, and again whenever the options change.
+    void RegisterFiles(FileReaderPool& pool, FileReadOptions const& options)
+    {
+        m_ReadOptions = options;
+
+        if (m_Kind == Kind::Directory)
+        {
+            // Each file is only ever read once, from start to end.
+            m_ReadOptions.m_Hints.m_Access = MemoryMapAccess::Sequential;
+            return;
+        }
+
+        for (File& file : m_Files)
+        {
+            file.m_PoolFile = pool.Register(file.m_Path, options);
+        }
+    }
+
+    // Uses entries and a filter built by an earlier Finalise, which the caller keeps alive, in place of building them.
+    void UseFinalised(Span<Entry const> entries, Span<std::uint64_t const> filter)
+    {
+        ASSERT(!filter.empty());
+        m_Entries = entries;
+        m_Filter = filter;
+    }
+
+    bool Contains(ResRef const& resref, ResourceType type, std::uint64_t hash) const
+    {
+        // Almost every source is missing almost every resource, so the filter turns most of these away before
+        // the search.
+        for (std::uint64_t i = 0; i < FilterProbeCount; ++i)
+        {
+            std::uint64_t bit = GetFilterBit(hash, i, m_Filter.size() * 64 - 1);
+
+            if (!(m_Filter[bit / 64] & (1ull << (bit % 64))))
+            {
+                return false;
+            }
+        }
+
+        auto entry = std::lower_bound(std::begin(m_Entries), std::end(m_Entries), std::make_pair(resref, type),
+            [](Entry const& lhs, std::pair<ResRef, ResourceType> const& rhs)
+            {
+                return EntryLess(lhs.m_ResRef, lhs.m_Type, rhs.first, rhs.second);
+            });
+
+        return entry != std::end(m_Entries) && entry->m_ResRef == resref && entry->m_Type == type;
+    }
+
+    bool IsArchive() const
+    {
+        return m_Kind != Kind::Directory;
+    }
+
+    std::unique_ptr<DataBlock> Open(std::uint32_t index, FileReaderPool& pool) const
+    {
+        Entry const& entry = m_Entries[index];
+
+        if (entry.m_File >= m_Files.size())
+        {
+            return nullptr;
+        }
+
+        if (m_Kind == Kind::Directory)
+        {
+            return FileReader::ReadRange(m_Files[entry.m_File].m_Path.c_str(), { 0, MemoryMappedFile::ToEndOfFile },
+                m_ReadOptions);
+        }
+
+        std::shared_ptr<FileReader const> archive = pool.Acquire(m_Files[entry.m_File].m_PoolFile);
+        return archive ? archive->Read({ entry.m_Offset, entry.m_Size }) : nullptr;
+    }
+
+    // Opens several resources in one archive file at once, putting the data of entries[i] in out[i]. The entries are
+    // best sorted by offset, which is the order they are read in where the backend doesn't reorder them itself.
+    void OpenBatch(std::uint32_t file, Span<std::uint32_t const> entries, FileReaderPool& pool,
+        std::unique_ptr<DataBlock>* out) const
+    {
+        ASSERT(IsArchive());
+
+        if (file >= m_Files.size())
+        {
+            return;
+        }
+
+        std::shared_ptr<FileReader const> archive = pool.Acquire(m_Files[file].m_PoolFile);
+
+        if (!archive)
+        {
+            return;
+        }
+
+        std::vector<FileReader::Range> ranges;
+        ranges.reserve(entries.size());
+
+        for (std::uint32_t index : entries)
+        {
+            ranges.push_back({ m_Entries[index].m_Offset, m_Entries[index].m_Size });
+        }
+
+        archive->ReadBatch({ ranges.data(), ranges.size() }, out);
+    }
+
+private:
+    static constexpr std::uint64_t FilterProbeCount = 4;
+
+    // The probes are spread by double hashing - the low half of the hash picks the first bit, and the high half
+    // (made odd, so it is coprime with the size) the step between bits.
+    static std::uint64_t GetFilterBit(std::uint64_t hash, std::uint64_t probe, std::uint64_t mask)
+    {
+        return (hash + probe * ((hash >> 32) | 1)) & mask;
+    }
+
+    Kind m_Kind;
+    std::string m_Path;
+    FileStamp m_Stamp;
+
+    std::vector<File> m_Files;
+    FileReadOptions m_ReadOptions;
+
+    // Either the owned vectors, or part of a mapped index file.
+    Span<Entry const> m_Entries;
+    Span<std::uint64_t const> m_Filter;
+
+    std::vector<Entry> m_OwnedEntries;
+    std::vector<std::uint64_t> m_OwnedFilter;
+};
+
+namespace {
+
+std::shared_ptr<FileReaderPool> CreateDefaultPool()
+{
+    // Resources are read a few KB at a time from all over an archive, so reading ahead only wastes memory.
+    FileReadOptions options;
+    options.m_Hints.m_Access = MemoryMapAccess::Random;
+    return std::make_shared<FileReaderPool>(FileReaderPool::DefaultMaxOpenFiles, FileReaderPool::DefaultMaxMappedBytes,
+        options);
+}
+
+}
+
+ResourceManager::ResourceManager() : ResourceManager(CreateDefaultPool())
+{ }
+
+ResourceManager::ResourceManager(std::shared_ptr<FileReaderPool> pool) : m_IndexCount(0), m_Pool(std::move(pool))
+{
+    ASSERT(m_Pool);
+}
+
+ResourceManager::~ResourceManager()
+{ }
+
+bool ResourceManager::AddKey(char const* keyPath, char const* rootDirectory)
+{
+    ASSERT(keyPath);
+    ASSERT(rootDirectory);
+
+    Key::Raw::Key rawKey;
+    FileStamp keyStamp;
+
+    if (!Key::Raw::Key::ReadFromFile(keyPath, &rawKey) || !ReadFileStamp(keyPath, &keyStamp))
+    {
+        return false;
+    }
+
+    Key::Friendly::Key key(rawKey);
+    std::unique_ptr<Source> source = std::make_unique<Source>(Source::Kind::Key, keyPath, keyStamp);
+
+    // Where each resource is in each BIF, sorted by the ID the KEY refers to it by.
+    struct BifLocation
+    {
+        std::uint32_t m_Id;
+        std::uint32_t m_Offset;
+        std::uint32_t m_Size;
+    };
+
+    std::vector<std::vector<BifLocation>> bifLocations;
+    bifLocations.reserve(key.GetReferencedBifs().size());
+
+    for (Key::Friendly::KeyBifReference const& bifReference : key.GetReferencedBifs())
+    {
+        std::string bifPath = std::string(rootDirectory) + "/" + bifReference.m_Path.c_str();
+
+        Bif::Raw::Bif rawBif;
+        FileStamp bifStamp;
+
+        if (!Bif::Raw::Bif::ReadTablesFromFile(bifPath.c_str(), &rawBif) || !ReadFileStamp(bifPath.c_str(), &bifStamp))
+        {
+            return false;
+        }
+
+        std::vector<BifLocation>& locations = bifLocations.emplace_back();
+        locations.reserve(rawBif.m_VariableResourceTable.size());
+
+        for (Bif::Raw::BifVariableResource const& rawResource : rawBif.m_VariableResourceTable)
+        {
+            // See Bif_Friendly.cpp for why only the bottom fourteen bits of the ID count.
+            locations.push_back({ rawResource.m_Id & 0x00003FFF, rawResource.m_Offset, rawResource.m_FileSize });
+        }
+
+        std::sort(std::begin(locations), std::end(locations),
+            [](BifLocation const& lhs, BifLocation const& rhs) { return lhs.m_Id < rhs.m_Id; });
+
+        source->AddFile(std::move(bifPath), bifStamp);
+    }
+
+    for (Key::Friendly::KeyBifReferencedResource const& resource : key.GetReferencedResources())
+    {
+        if (resource.m_ReferencedBifIndex >= bifLocations.size())
+        {
+            continue;
+        }
+
+        std::vector<BifLocation> const& locations = bifLocations[resource.m_ReferencedBifIndex];
+        auto location = std::lower_bound(std::begin(locations), std::end(locations), resource.m_ReferencedBifResId,
+            [](BifLocation const& lhs, std::uint32_t id) { return lhs.m_Id < id; });
+
+        if (location != std::end(locations) && location->m_Id == resource.m_ReferencedBifResId)
+        {
+            source->AddEntry(resource.m_ResRef, resource.m_ResType,
+                static_cast<std::uint32_t>(resource.m_ReferencedBifIndex), location->m_Offset, location->m_Size);
+        }
+    }
+
+    source->Finalise();
+    AddSource(std::move(source));
+    return true;
+}
+
+bool ResourceManager::AddErf(char const* path)
+{
+    ASSERT(path);
+
+    Erf::Raw::Erf rawErf;
+    FileStamp stamp;
+
+    if (!Erf::Raw::Erf::ReadFromFile(path, &rawErf) || !ReadFileStamp(path, &stamp))
+    {
+        return false;
+    }
+
+    std::unique_ptr<Source> source = std::make_unique<Source>(Source::Kind::Erf, path, stamp);
+    std::uint32_t file = source->AddFile(path, stamp);
+
+    for (std::size_t i = 0; i < rawErf.m_Keys.size(); ++i)
+    {
+        Erf::Raw::ErfKey const& rawKey = rawErf.m_Keys[i];
+        Erf::Raw::ErfResource const& rawResource = rawErf.m_Resources[i];
+        source->AddEntry(ResRef::FromRawResRef(rawKey.m_ResRef), rawKey.m_ResType, file,
+            rawResource.m_OffsetToResource, rawResource.m_ResourceSize);
+    }
+
+    source->Finalise();
+    AddSource(std::move(source));
+    return true;
+}
+
+bool ResourceManager::AddDirectory(char const* path)
+{
+    ASSERT(path);
+
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    fs::directory_iterator directory(path, error);
+    FileStamp stamp;
+
+    if (error || !ReadFileStamp(path, &stamp))
+    {
+        return false;
+    }
+
+    std::vector<std::string> files;
+
+    for (fs::directory_entry const& entry : directory)
+    {
+        if (entry.is_regular_file(error))
+        {
+            files.emplace_back(entry.path().string());
+        }
+    }
+
+    // The listing order depends on the file system - sort it so the same directory always resolves the same way
+    // when two files differ only in case.
+    std::sort(std::begin(files), std::end(files));
+
+    // Only adding or removing a file changes what the directory provides, and that changes the directory's own
+    // modification time, so the files themselves aren't stamped.
+    std::unique_ptr<Source> source = std::make_unique<Source>(Source::Kind::Directory, path, stamp);
+
+    for (std::string& file : files)
+    {
+        fs::path filePath(file);
+        std::string name = filePath.stem().string();
+        std::string extension = filePath.extension().string();
+
+        if (name.empty() || name.size() > 16 || extension.size() < 2)
+        {
+            continue;
+        }
+
+        ResourceType type = TryResourceTypeFromString(extension.c_str() + 1);
+
+        if (type != ResourceType::INVALID)
+        {
+            source->AddEntry(ResRef(name), type, source->AddFile(std::move(file), FileStamp { 0, 0 }), 0, 0);
+        }
+    }
+
+    source->Finalise();
+    AddSource(std::move(source));
+    return true;
+}
+
+bool ResourceManager::WriteIndexFile(char const* path) const
+{
+    ASSERT(path);
+
+    std::vector<IndexFileSource> sources;
+    std::vector<IndexFileFile> files;
+    std::string strings;
+
+    auto addString = [&strings](std::string const& str)
+    {
+        IndexFileString indexString { static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(str.size()) };
+        strings += str;
+        return indexString;
+    };
+
+    IndexFileHeader header = {};
+    std::memcpy(header.m_FileType, "RIDX", 4);
+    std::memcpy(header.m_Version, "V1.0", 4);
+    header.m_EntrySize = sizeof(Source::Entry);
+    header.m_IndexSlotSize = sizeof(IndexSlot);
+
+    for (std::unique_ptr<Source> const& source : m_Sources)
+    {
+        IndexFileSource indexSource = {};
+        indexSource.m_Kind = static_cast<std::uint32_t>(source->GetKind());
+        indexSource.m_Path = addString(source->GetPath());
+        indexSource.m_FirstFile = static_cast<std::uint32_t>(files.size());
+        indexSource.m_FileCount = static_cast<std::uint32_t>(source->GetFiles().size());
+        indexSource.m_FirstEntry = header.m_EntryCount;
+        indexSource.m_EntryCount = static_cast<std::uint32_t>(source->GetEntries().size());
+        indexSource.m_FirstFilterWord = header.m_FilterWordCount;
+        indexSource.m_FilterWordCount = static_cast<std::uint32_t>(source->GetFilter().size());
+        indexSource.m_Stamp = source->GetStamp();
+        sources.push_back(indexSource);
+
+        for (Source::File const& file : source->GetFiles())
+        {
+            files.push_back({ addString(file.m_Path), file.m_Stamp });
+        }
+
+        header.m_EntryCount += indexSource.m_EntryCount;
+        header.m_FilterWordCount += indexSource.m_FilterWordCount;
+    }
+
+    header.m_SourceCount = static_cast<std::uint32_t>(sources.size());
+    header.m_FileCount = static_cast<std::uint32_t>(files.size());
+    header.m_IndexSlotCount = static_cast<std::uint32_t>(m_Index.size());
+    header.m_ResourceCount = static_cast<std::uint32_t>(m_IndexCount);
+    header.m_StringsSize = static_cast<std::uint32_t>(strings.size());
+
+    header.m_OffsetToSources = AlignIndexFileOffset(sizeof(header));
+    header.m_OffsetToFiles = AlignIndexFileOffset(header.m_OffsetToSources + sources.size() * sizeof(IndexFileSource));
+    header.m_OffsetToEntries = AlignIndexFileOffset(header.m_OffsetToFiles + files.size() * sizeof(IndexFileFile));
+    header.m_OffsetToFilter = AlignIndexFileOffset(header.m_OffsetToEntries + header.m_EntryCount * sizeof(Source::Entry));
+    header.m_OffsetToIndex = AlignIndexFileOffset(header.m_OffsetToFilter + header.m_FilterWordCount * sizeof(std::uint64_t));
+    header.m_OffsetToStrings = AlignIndexFileOffset(header.m_OffsetToIndex + m_Index.size() * sizeof(IndexSlot));
+
+    // Each section is written straight from where it is held, with zeroes in between to align the next one.
+    static char const padding[IndexFileAlignment] = {};
+    std::vector<WriteBuffer> buffers;
+    std::uint64_t written = 0;
+
+    auto write = [&buffers, &written](std::uint64_t offset, void const* data, std::size_t length)
+    {
+        ASSERT(offset >= written && offset - written < IndexFileAlignment);
+
+        if (offset != written)
+        {
+            buffers.push_back({ padding, static_cast<std::size_t>(offset - written) });
+        }
+
+        if (length)
+        {
+            buffers.push_back({ data, length });
+        }
+
+        written = offset + length;
+    };
+
+    write(0, &header, sizeof(header));
+    write(header.m_OffsetToSources, sources.data(), sources.size() * sizeof(IndexFileSource));
+    write(header.m_OffsetToFiles, files.data(), files.size() * sizeof(IndexFileFile));
+
+    write(header.m_OffsetToEntries, nullptr, 0);
+
+    for (std::unique_ptr<Source> const& source : m_Sources)
+    {
+        Span<Source::Entry const> entries = source->GetEntries();
+        write(written, entries.data(), entries.size() * sizeof(Source::Entry));
+    }
+
+    write(header.m_OffsetToFilter, nullptr, 0);
+
+    for (std::unique_ptr<Source> const& source : m_Sources)
+    {
+        Span<std::uint64_t const> filter = source->GetFilter();
+        write(written, filter.data(), filter.size() * sizeof(std::uint64_t));
+    }
+
+    write(header.m_OffsetToIndex, m_Index.data(), m_Index.size() * sizeof(IndexSlot));
+    write(header.m_OffsetToStrings, strings.data(), strings.size());
+
+    // Other processes may have the old file mapped, so it is replaced rather than rewritten in place - they keep
+    // the old pages, and nothing ever maps a partly written file.
+    return ReplaceFileWithBuffers(path, buffers.data(), buffers.size());
+}
+
+bool ResourceManager::ReadIndexFile(char const* path, ResourceManager* out)
+{
+    ASSERT(path);
+    ASSERT(out);
+    ASSERT_MSG(out->m_Sources.empty(), "An index file replaces the sources, so it must be read into an empty manager.");
+
+    std::unique_ptr<MemoryMappedFile> indexFile = std::make_unique<MemoryMappedFile>();
+
+    // Nearly every page of the index and the filters is touched by the first few hundred lookups, so they are all
+    // read in now, while the sources are checked.
+    MemoryMapHints hints;
+    hints.m_Prefetch = MemoryMapPrefetch::Background;
+
+    if (!MemoryMappedFile::MemoryMap(path, indexFile.get(), hints))
+    {
+        return false;
+    }
+
+    DataBlock const& data = indexFile->GetDataBlock();
+    IndexFileHeader header;
+
+    if (data.GetDataLength() < sizeof(header))
+    {
+        return false;
+    }
+
+    std::memcpy(&header, data.GetData(), sizeof(header));
+
+    if (std::memcmp(header.m_FileType, "RIDX", 4) != 0 || std::memcmp(header.m_Version, "V1.0", 4) != 0 ||
+        header.m_EntrySize != sizeof(Source::Entry) || header.m_IndexSlotSize != sizeof(IndexSlot) ||
+        (header.m_IndexSlotCount & (header.m_IndexSlotCount - 1)) != 0)
+    {
+        return false;
+    }
+
+    Span<IndexFileSource const> sources;
+    Span<IndexFileFile const> files;
+    Span<Source::Entry const> entries;
+    Span<std::uint64_t const> filter;
+    Span<IndexSlot const> index;
+    Span<char const> strings;
+
+    if (!ReadIndexFileSection(data, header.m_OffsetToSources, header.m_SourceCount, &sources) ||
+        !ReadIndexFileSection(data, header.m_OffsetToFiles, header.m_FileCount, &files) ||
+        !ReadIndexFileSection(data, header.m_OffsetToEntries, header.m_EntryCount, &entries) ||
+        !ReadIndexFileSection(data, header.m_OffsetToFilter, header.m_FilterWordCount, &filter) ||
+        !ReadIndexFileSection(data, header.m_OffsetToIndex, header.m_IndexSlotCount, &index) ||
+        !ReadIndexFileSection(data, header.m_OffsetToStrings, header.m_StringsSize, &strings))
+    {
+        return false;
+    }
+
+    auto readString = [&strings](IndexFileString const& str, std::string* stringOut)
+    {
+        if (str.m_Offset > strings.size() || str.m_Length > strings.size() - str.m_Offset)
+        {
+            return false;
+        }
+
+        stringOut->assign(strings.data() + str.m_Offset, str.m_Length);
+        return true;
+    };
+
+    // The sources and their files are checked against the file system before anything is used - if an archive has
+    // changed since the index was written, so might the resources in it. The files of a directory aren't stamped.
+    std::vector<std::unique_ptr<Source>> readSources;
+
+    for (IndexFileSource const& indexSource : sources)
+    {
+        std::string sourcePath;
+        FileStamp stamp;
+
+        if (indexSource.m_Kind > static_cast<std::uint32_t>(Source::Kind::Directory) ||
+            indexSource.m_FirstFile > files.size() || indexSource.m_FileCount > files.size() - indexSource.m_FirstFile ||
+            indexSource.m_FirstEntry > entries.size() || indexSource.m_EntryCount > entries.size() - indexSource.m_FirstEntry ||
+            indexSource.m_FirstFilterWord > filter.size() || indexSource.m_FilterWordCount > filter.size() - indexSource.m_FirstFilterWord ||
+            indexSource.m_FilterWordCount == 0 || (indexSource.m_FilterWordCount & (indexSource.m_FilterWordCount - 1)) != 0 ||
+            !readString(indexSource.m_Path, &sourcePath) ||
+            !ReadFileStamp(sourcePath.c_str(), &stamp) || !(stamp == indexSource.m_Stamp))
+        {
+            return false;
+        }
+
+        Source::Kind kind = static_cast<Source::Kind>(indexSource.m_Kind);
+        std::unique_ptr<Source> source = std::make_unique<Source>(kind, std::move(sourcePath), stamp);
+
+        for (std::size_t i = indexSource.m_FirstFile; i < indexSource.m_FirstFile + indexSource.m_FileCount; ++i)
+        {
+            std::string filePath;
+            FileStamp fileStamp = files[i].m_Stamp;
+
+            if (!readString(files[i].m_Path, &filePath) ||
+                (kind != Source::Kind::Directory && (!ReadFileStamp(filePath.c_str(), &fileStamp) || !(fileStamp == files[i].m_Stamp))))
+            {
+                return false;
+            }
+
+            source->AddFile(std::move(filePath), fileStamp);
+        }
+
+        source->RegisterFiles(*out->m_Pool, out->m_Pool->GetDefaultOptions());
+        source->UseFinalised(
+            { entries.data() + indexSource.m_FirstEntry, indexSource.m_EntryCount },
+            { filter.data() + indexSource.m_FirstFilterWord, indexSource.m_FilterWordCount });
+
+        readSources.emplace_back(std::move(source));
+    }
+
+    // The slots are used as they are, so every one has to point at an entry which exists. The index is also held to
+    // the same load as one built in memory, which leaves empty slots for probes to stop at.
+    std::size_t occupiedSlots = 0;
+
+    for (IndexSlot const& slot : index)
+    {
+        if (slot.m_Source == EmptySlot)
+        {
+            continue;
+        }
+
+        if (slot.m_Source >= readSources.size() || slot.m_Entry >= readSources[slot.m_Source]->GetEntries().size())
+        {
+            return false;
+        }
+
+        ++occupiedSlots;
+    }
+
+    if (occupiedSlots != header.m_ResourceCount || occupiedSlots * 2 > index.size())
+    {
+        return false;
+    }
+
+    out->m_Sources = std::move(readSources);
+    out->m_Index = index;
+    out->m_IndexCount = header.m_ResourceCount;
+    out->m_IndexFile = std::move(indexFile);
+    return true;
+}
+
+std::size_t ResourceManager::GetSourceCount() const
+{
+    return m_Sources.size();
+}
+
+std::string const& ResourceManager::GetSourcePath(std::size_t source) const
+{
+    ASSERT(source < m_Sources.size());
+    return m_Sources[source]->GetPath();
+}
+
+std::size_t ResourceManager::GetResourceCount() const
+{
+    return m_IndexCount;
+}
+
+std::size_t ResourceManager::FindSource(ResRef const& resref, ResourceType type) const
+{
+    IndexSlot const* slot = Find(resref, type);
+    return slot ? slot->m_Source : NotFound;
+}
+
+bool ResourceManager::Contains(ResRef const& resref, ResourceType type) const
+{
+    return Find(resref, type) != nullptr;
+}
+
+FileReaderPool& ResourceManager::GetFileReaderPool() const
+{
+    return *m_Pool;
+}
+
+void ResourceManager::SetSourceReadOptions(std::size_t source, FileReadOptions const& options)
+{
+    ASSERT(source < m_Sources.size());
+    m_Sources[source]->RegisterFiles(*m_Pool, options);
+}
+
+std::vector<std::size_t> ResourceManager::FindAllSources(ResRef const& resref, ResourceType type) const
+{
+    std::vector<std::size_t> sources;
+    std::uint64_t hash = HashResource(resref, type);
+
+    for (std::size_t i = m_Sources.size(); i-- > 0;)
+    {
+        if (m_Sources[i]->Contains(resref, type, hash))
+        {
+            sources.push_back(i);
+        }
+    }
+
+    return sources;
+}
+
+std::unique_ptr<DataBlock> ResourceManager::Open(ResRef const& resref, ResourceType type) const
+{
+    IndexSlot const* slot = Find(resref, type);
+
+    if (!slot)
+    {
+        return nullptr;
+    }
+
+    return m_Sources[slot->m_Source]->Open(slot->m_Entry, *m_Pool);
+}
+
+std::vector<std::unique_ptr<DataBlock>> ResourceManager::OpenBatch(
+    Span<std::pair<ResRef, ResourceType> const> resources) const
+{
+    std::vector<std::unique_ptr<DataBlock>> blocks(resources.size());
+
+    struct Request
+    {
+        IndexSlot const* m_Slot;
+        std::uint32_t m_File;
+        std::uint32_t m_Offset;
+        std::size_t m_Position;
+    };
+
+    std::vector<Request> requests;
+    requests.reserve(resources.size());
+
+    for (std::size_t i = 0; i < resources.size(); ++i)
+    {
+        IndexSlot const* slot = Find(resources[i].first, resources[i].second);
+
+        if (!slot)
+        {
+            continue;
+        }
+
+        Source const& source = *m_Sources[slot->m_Source];
+
+        if (!source.IsArchive())
+        {
+            blocks[i] = source.Open(slot->m_Entry, *m_Pool);
+            continue;
+        }
+
+        Source::Entry const& entry = source.GetEntries()[slot->m_Entry];
+        requests.push_back({ slot, entry.m_File, entry.m_Offset, i });
+    }
+
+    // Grouped by the file they are in, and in the order they are on disk within each file.
+    std::sort(std::begin(requests), std::end(requests),
+        [](Request const& lhs, Request const& rhs)
+        {
+            if (lhs.m_Slot->m_Source != rhs.m_Slot->m_Source)
+            {
+                return lhs.m_Slot->m_Source < rhs.m_Slot->m_Source;
+            }
+
+            return lhs.m_File < rhs.m_File || (lhs.m_File == rhs.m_File && lhs.m_Offset < rhs.m_Offset);
+        });
+
+    std::vector<std::uint32_t> entries;
+    std::vector<std::unique_ptr<DataBlock>> groupBlocks;
+
+    for (std::size_t begin = 0, end; begin < requests.size(); begin = end)
+    {
+        std::uint32_t sourceIndex = requests[begin].m_Slot->m_Source;
+        std::uint32_t file = requests[begin].m_File;
+
+        entries.clear();
+
+        for (end = begin; end < requests.size() && requests[end].m_Slot->m_Source == sourceIndex &&
+            requests[end].m_File == file; ++end)
+        {
+            entries.push_back(requests[end].m_Slot->m_Entry);
+        }
+
+        groupBlocks.clear();
+        groupBlocks.resize(entries.size());
+        m_Sources[sourceIndex]->OpenBatch(file, { entries.data(), entries.size() }, *m_Pool, groupBlocks.data());
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            blocks[requests[i].m_Position] = std::move(groupBlocks[i - begin]);
+        }
+    }
+
+    return blocks;
+}
+
+void ResourceManager::AddSource(std::unique_ptr<Source> source)
+{
+    std::uint32_t sourceIndex = static_cast<std::uint32_t>(m_Sources.size());
+    source->RegisterFiles(*m_Pool, m_Pool->GetDefaultOptions());
+
+    Span<Source::Entry const> entries = source->GetEntries();
+
+    // Every entry could be new - if some shadow resources already in the index, this is a little generous.
+    Reserve(m_IndexCount + entries.size());
+
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        Source::Entry const& entry = entries[i];
+        IndexSlot& slot = m_OwnedIndex[FindSlot(entry.m_ResRef, entry.m_Type, HashResource(entry.m_ResRef, entry.m_Type))];
+
+        if (slot.m_Source == EmptySlot)
+        {
+            slot.m_ResRef = entry.m_ResRef;
+            slot.m_Type = entry.m_Type;
+            ++m_IndexCount;
+        }
+        else if (slot.m_Source == sourceIndex)
+        {
+            // A second copy within the same source - the first one wins.
+            continue;
+        }
+
+        slot.m_Source = sourceIndex;
+        slot.m_Entry = static_cast<std::uint32_t>(i);
+    }
+
+    m_Sources.emplace_back(std::move(source));
+}
+
+void ResourceManager::Reserve(std::size_t count)
+{
+    std::size_t capacity = 16;
+    while (capacity < count * 2 || capacity < m_Index.size())
+    {
+        capacity *= 2;
+    }
+
+    // An index read from a file is copied out before it is changed, even if it is already big enough.
+    if (capacity == m_Index.size() && m_Index.data() == m_OwnedIndex.data())
+    {
+        return;
+    }
+
+    std::vector<IndexSlot> index(capacity, IndexSlot { ResRef(), ResourceType::INVALID, 0, EmptySlot, 0, 0 });
+    Span<IndexSlot const> oldIndex = m_Index;
+    m_Index = { index.data(), index.size() };
+
+    for (IndexSlot const& oldSlot : oldIndex)
+    {
+        if (oldSlot.m_Source != EmptySlot)
+        {
+            index[FindSlot(oldSlot.m_ResRef, oldSlot.m_Type, HashResource(oldSlot.m_ResRef, oldSlot.m_Type))] = oldSlot;
+        }
+    }
+
+    // Moving the vector keeps its storage, so the span stays valid.
+    m_OwnedIndex = std::move(index);
+}
+
+std::size_t ResourceManager::FindSlot(ResRef const& resref, ResourceType type, std::uint64_t hash) const
+{
+    ASSERT(!m_Index.empty());
+
+    std::size_t mask = m_Index.size() - 1;
+
+    for (std::size_t i = static_cast<std::size_t>(hash) & mask;; i = (i + 1) & mask)
+    {
+        IndexSlot const& slot = m_Index[i];
+
+        if (slot.m_Source == EmptySlot || (slot.m_ResRef == resref && slot.m_Type == type))
+        {
+            return i;
+        }
+    }
+}
+
+ResourceManager::IndexSlot const* ResourceManager::Find(ResRef const& resref, ResourceType type) const
+{
+    if (m_Index.empty())
+    {
+        return nullptr;
+    }
+
+    IndexSlot const& slot = m_Index[FindSlot(resref, type, HashResource(resref, type))];
+    return slot.m_Source == EmptySlot ? nullptr : &slot;
+}
+
+}
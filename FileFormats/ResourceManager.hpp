@@ -0,0 +1,164 @@
+#pragma once
+
+#include "FileFormats/Resource.hpp"
+#include "FileFormats/ResRef.hpp"
+#include "Utility/DataBlock.hpp"
+#include "Utility/Span.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class FileReaderPool;
+class MemoryMappedFile;
+struct FileReadOptions;
+
+namespace FileFormats::Resource {
+
+// A stack of the places resources come from - KEY/BIF sets, ERFs (haks, modules, saves) and override directories -
+// which answers where a resource is found the way the game does.
+//
+// Sources added later take precedence over sources added earlier, so the stack is built from the bottom up. For the
+// game that means adding:
+// - The base KEYs, then any patch KEYs.
+// - The module.
+// - The module's haks, from the last in its list to the first.
+// - The override directory.
+//
+// Every resource in the stack is in one open addressing hash index from (ResRef, ResourceType) to the source it
+// comes from, so a lookup costs the same however many sources there are. Each source also keeps a Bloom filter of
+// its own resources, which FindAllSources uses to pass over the sources that can't have a resource.
+//
+// Adding a KEY reads the tables of every BIF it references, which for the game's KEYs takes a while. The result can
+// be saved with WriteIndexFile, and later processes can start from ReadIndexFile instead.
+//
+// BIFs and ERFs are read through a FileReaderPool, which bounds how many are open at once. Managers can share a pool,
+// so several modules loaded side by side open the base game's BIFs once between them. Archives are mapped by default,
+// but each source can be read with a backend of its own (see SetSourceReadOptions).
+//
+// Sources can't be removed - build a new manager to change modules. Lookups and Open can be called from any number
+// of threads at once, but adding a source mustn't overlap with anything else.
+class ResourceManager
+{
+public:
+    static constexpr std::size_t NotFound = static_cast<std::size_t>(-1);
+
+    // Reads archives through a pool of its own, with the default budgets, mapping them.
+    ResourceManager();
+
+    // Sources are read with the pool's default options until SetSourceReadOptions says otherwise.
+    explicit ResourceManager(std::shared_ptr<FileReaderPool> pool);
+
+    ~ResourceManager();
+
+    ResourceManager(ResourceManager const&) = delete;
+    ResourceManager& operator=(ResourceManager const&) = delete;
+
+    // Adds the resources referenced by a KEY. The BIF paths in the KEY are relative to rootDirectory, which is the
+    // install directory for the game's own KEYs. Fails if the KEY or any of its BIFs can't be read. The tables of
+    // every BIF are read now, but a BIF is only mapped to read resources out of it the first time one is opened.
+    bool AddKey(char const* keyPath, char const* rootDirectory);
+
+    // Adds the resources in an ERF. Like a BIF, the ERF is opened the first time a resource in it is opened.
+    bool AddErf(char const* path);
+
+    // Adds every file in the directory named as <resref>.<extension>, where the extension is a known resource type.
+    // Only the names are read now - each file is read when it is opened.
+    bool AddDirectory(char const* path);
+
+    // Sources are indexed in the order they were added.
+    std::size_t GetSourceCount() const;
+    std::string const& GetSourcePath(std::size_t source) const;
+
+    // The number of distinct resources across every source.
+    std::size_t GetResourceCount() const;
+
+    // Returns the index of the source the resource comes from, or NotFound.
+    std::size_t FindSource(ResRef const& resref, ResourceType type) const;
+
+    bool Contains(ResRef const& resref, ResourceType type) const;
+
+    // The pool the manager reads archives through - set its budgets here.
+    FileReaderPool& GetFileReaderPool() const;
+
+    // Changes how the files of a source - the BIFs of a KEY, an ERF, or the files in a directory - are read from
+    // now on. Blocks already opened are unaffected. Like adding a source, this mustn't overlap with anything else.
+    void SetSourceReadOptions(std::size_t source, FileReadOptions const& options);
+
+    // Returns every source which has a copy of the resource, highest precedence first. The first is the one
+    // FindSource returns and the rest are shadowed by it.
+    std::vector<std::size_t> FindAllSources(ResRef const& resref, ResourceType type) const;
+
+    // Returns the data of the resource, or nullptr if no source has it or it couldn't be read.
+    // With the MemoryMap backend nothing is copied: the data of a resource in a BIF or ERF points into the mapped
+    // archive, and a file from a directory is mapped by itself. Either way the block keeps the mapping alive, so it
+    // can outlive the manager. Other backends read the data into a block of its own.
+    std::unique_ptr<DataBlock> Open(ResRef const& resref, ResourceType type) const;
+
+    // Opens every resource, putting the result of resources[i] (as Open returns it) in the i-th block. The reads are
+    // grouped by archive and sorted by offset, and each group is handed to the archive's reader as one batch - which
+    // the Batched backend submits to the kernel together. Loading an area's worth of resources this way costs a
+    // handful of round trips rather than one per resource.
+    std::vector<std::unique_ptr<DataBlock>> OpenBatch(Span<std::pair<ResRef, ResourceType> const> resources) const;
+
+    // Writes the sources, the index and the filters - along with the modification time and size of every KEY, BIF,
+    // ERF and directory they were built from - to a file which ReadIndexFile maps in place of adding the sources
+    // again. The file is replaced rather than overwritten, so processes with the old one mapped are unaffected.
+    bool WriteIndexFile(char const* path) const;
+
+    // Maps an index file into an empty manager. Nothing is read out of it: the index, the filters and the source
+    // entries are used where they are mapped, so every process using the same file shares the same pages.
+    // Fails if the file isn't an index written by this build, or if anything it was built from has changed since -
+    // in which case add the sources again and rewrite it. Sources can still be added on top afterwards.
+    static bool ReadIndexFile(char const* path, ResourceManager* out);
+
+private:
+    class Source;
+    class KeySource;
+    class ErfSource;
+    class DirectorySource;
+
+    static constexpr std::uint32_t EmptySlot = 0xFFFFFFFF;
+
+    // This is written to index files as it is, so all of the padding is explicit and zeroed.
+    struct IndexSlot
+    {
+        ResRef m_ResRef;
+        ResourceType m_Type;
+        std::uint16_t m_Padding;
+
+        // The source the resource comes from, or EmptySlot.
+        std::uint32_t m_Source;
+
+        // The position of the resource in the source's sorted entries.
+        std::uint32_t m_Entry;
+
+        std::uint32_t m_Padding2;
+    };
+
+    void AddSource(std::unique_ptr<Source> source);
+    void Reserve(std::size_t count);
+
+    // Returns the position of the slot holding the resource, or of the empty slot it would go in.
+    std::size_t FindSlot(ResRef const& resref, ResourceType type, std::uint64_t hash) const;
+
+    IndexSlot const* Find(ResRef const& resref, ResourceType type) const;
+
+    std::vector<std::unique_ptr<Source>> m_Sources;
+
+    // The capacity is a power of two and kept at least twice the count, so probe sequences stay short.
+    // This is either m_OwnedIndex or the index in m_IndexFile.
+    Span<IndexSlot const> m_Index;
+    std::vector<IndexSlot> m_OwnedIndex;
+    std::size_t m_IndexCount;
+
+    // The index file this was read from, if it was. Its sections are used by the sources and the index.
+    std::unique_ptr<MemoryMappedFile> m_IndexFile;
+
+    std::shared_ptr<FileReaderPool> m_Pool;
+};
+
+}
@@ -12,6 +12,9 @@
 // - You can get entries via operator[].
 // - Use begin/end() (or ranged-based loop) to iterate all entries.
 //
+// Both the raw and friendly Tlk can allocate from a std::pmr::memory_resource given on construction - with an arena,
+// loading a talk table costs a handful of allocations rather than several per string.
+//
 // For further information refer to https://wiki.neverwintervault.org/pages/viewpage.action?pageId=327727
 // Specifically, https://wiki.neverwintervault.org/download/attachments/327727/Bioware_Aurora_TalkTable_Format.pdf?api=v2
 
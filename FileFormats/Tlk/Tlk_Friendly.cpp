@@ -6,7 +6,7 @@
 
 namespace FileFormats::Tlk::Friendly {
 
-Tlk::Tlk(Raw::Tlk const& rawTlk)
+Tlk::Tlk(Raw::Tlk const& rawTlk, std::pmr::memory_resource* resource) : m_TlkMap(resource)
 {
     m_LanguageId = rawTlk.m_Header.m_LanguageID;
 
@@ -19,12 +19,12 @@ Tlk::Tlk(Raw::Tlk const& rawTlk)
         if (data.m_Flags & Raw::TlkStringData::TEXT_PRESENT)
         {
             ASSERT(data.m_OffsetToString + data.m_StringSize <= rawTlk.m_StringEntries.size());
-            tlkEntry.m_String = std::string(reinterpret_cast<char const*>(rawTlk.m_StringEntries.data() + data.m_OffsetToString), data.m_StringSize);
+            tlkEntry.m_String.emplace(reinterpret_cast<char const*>(rawTlk.m_StringEntries.data() + data.m_OffsetToString), data.m_StringSize, resource);
         }
 
         if (data.m_Flags & Raw::TlkStringData::SND_PRESENT)
         {
-            tlkEntry.m_SoundResRef = std::string(data.m_SoundResRef, strnlen(data.m_SoundResRef, 16));
+            tlkEntry.m_SoundResRef = Resource::ResRef::FromRawResRef(data.m_SoundResRef);
         }
 
         if (data.m_Flags & Raw::TlkStringData::SNDLENGTH_PRESENT)
@@ -32,13 +32,14 @@ Tlk::Tlk(Raw::Tlk const& rawTlk)
             tlkEntry.m_SoundLength = data.m_SoundLength;
         }
 
-        m_TlkMap.insert(std::make_pair(static_cast<StrRef>(i), std::move(tlkEntry)));
+        // The strrefs are in order, so each entry goes at the end of the map.
+        m_TlkMap.emplace_hint(std::end(m_TlkMap), static_cast<StrRef>(i), std::move(tlkEntry));
     }
 }
 
-std::string const& Tlk::operator[](StrRef strref) const
+std::pmr::string const& Tlk::operator[](StrRef strref) const
 {
-    static const std::string s_EmptyString = "";
+    static const std::pmr::string s_EmptyString = "";
     auto entry = m_TlkMap.find(strref);
 
     if (entry == std::end(m_TlkMap) || !entry->second.m_String.has_value())
@@ -97,7 +98,7 @@ bool Tlk::WriteToFile(const char* path) const
         {
             flags |= Raw::TlkStringData::StringFlags::TEXT_PRESENT;
 
-            const std::string& str = entry.second.m_String.value();
+            const std::pmr::string& str = entry.second.m_String.value();
             stringData.m_OffsetToString = stringOffset;
             stringData.m_StringSize = static_cast<std::uint32_t>(str.size());
 
@@ -112,8 +113,7 @@ bool Tlk::WriteToFile(const char* path) const
         if (entry.second.m_SoundResRef.has_value())
         {
             flags |= Raw::TlkStringData::StringFlags::SND_PRESENT;
-            const char* str = entry.second.m_SoundResRef->c_str();
-            std::memcpy(stringData.m_SoundResRef, str, strnlen(str, 16));
+            entry.second.m_SoundResRef->ToRawResRef(stringData.m_SoundResRef);
         }
 
         stringData.m_SoundLength = 0;
@@ -1,9 +1,11 @@
 #pragma once
 
+#include "FileFormats/ResRef.hpp"
 #include "FileFormats/Tlk/Tlk_Raw.hpp"
 
 #include <cstddef>
 #include <map>
+#include <memory_resource>
 #include <optional>
 #include <string>
 
@@ -13,21 +15,22 @@ using StrRef = std::uint32_t;
 
 struct TlkEntry
 {
-    std::optional<std::string> m_String;
-    std::optional<std::string> m_SoundResRef;
+    std::optional<std::pmr::string> m_String;
+    std::optional<Resource::ResRef> m_SoundResRef;
     std::optional<float> m_SoundLength;
 };
 
 class Tlk
 {
 public:
-    Tlk(Raw::Tlk const& rawKey);
+    // The entries read from the raw Tlk, strings included, are allocated from the resource. It must outlive the Tlk.
+    Tlk(Raw::Tlk const& rawKey, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     // We use a map rather than unordered_map here because it's more user friendly to iterate from 0 -> max.
-    using TlkMapType = std::map<StrRef, TlkEntry>;
+    using TlkMapType = std::pmr::map<StrRef, TlkEntry>;
 
     // Returns the string associated with the strref, or empty string ("").
-    std::string const& operator[](StrRef strref) const;
+    std::pmr::string const& operator[](StrRef strref) const;
 
     TlkEntry* Get(StrRef strref) const;
     void Set(StrRef strref, TlkEntry value);
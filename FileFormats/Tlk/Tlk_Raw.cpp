@@ -1,13 +1,14 @@
 #include "FileFormats/Tlk/Tlk_Raw.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/FileReader.hpp"
 #include "Utility/MemoryMappedFile.hpp"
 
 #include <cstring>
 
 namespace {
 
-template <typename T>
-void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T>& out)
+template <typename T, typename Allocator>
+void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t count, std::vector<T, Allocator>& out)
 {
     out.resize(count);
     std::memcpy(out.data(), bytesWithInitialOffset, count * sizeof(T));
@@ -17,6 +18,11 @@ void ReadGenericOffsetable(std::byte const* bytesWithInitialOffset, std::size_t
 
 namespace FileFormats::Tlk::Raw {
 
+Tlk::Tlk(std::pmr::memory_resource* resource)
+    : m_StringData(resource),
+      m_StringEntries(resource)
+{ }
+
 bool Tlk::ReadFromBytes(std::byte const* bytes, std::size_t bytesCount, Tlk* out)
 {
     ASSERT(bytes);
@@ -31,13 +37,19 @@ bool Tlk::ReadFromByteVector(std::vector<std::byte>&& bytes, Tlk* out)
     return out->ConstructInternal(bytes.data(), bytes.size());
 }
 
-bool Tlk::ReadFromFile(char const* path, Tlk* out)
+bool Tlk::ReadFromFile(char const* path, Tlk* out, FileReadOptions const& options)
 {
     ASSERT(path);
     ASSERT(out);
 
+    if (options.m_Backend != FileReadBackend::MemoryMap)
+    {
+        std::vector<std::byte> bytes;
+        return ReadEntireFile(path, &bytes) && ReadFromByteVector(std::move(bytes), out);
+    }
+
     MemoryMappedFile memmap;
-    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap);
+    bool loaded = MemoryMappedFile::MemoryMap(path, &memmap, options.m_Hints);
 
     if (!loaded)
     {
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "Utility/FileReader.hpp"
+
 #include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 namespace FileFormats::Tlk::Raw {
@@ -67,9 +70,15 @@ using TlkStringEntry = std::byte;
 
 struct Tlk
 {
+    Tlk() = default;
+
+    // Reading into a Tlk constructed with a resource allocates the string data and entries from it. For the large
+    // talk tables, that is the bulk of the file. The resource must outlive the Tlk.
+    explicit Tlk(std::pmr::memory_resource* resource);
+
     TlkHeader m_Header;
-    std::vector<TlkStringData> m_StringData;
-    std::vector<TlkStringEntry> m_StringEntries;
+    std::pmr::vector<TlkStringData> m_StringData;
+    std::pmr::vector<TlkStringEntry> m_StringEntries;
 
     // Constructs an Tlk from a non-owning pointer.
     static bool ReadFromBytes(std::byte const* bytes, std::size_t bytesCount, Tlk* out);
@@ -78,7 +87,7 @@ struct Tlk
     static bool ReadFromByteVector(std::vector<std::byte>&& bytes, Tlk* out);
 
     // Constructs an Tlk from a file.
-    static bool ReadFromFile(char const* path, Tlk* out);
+    static bool ReadFromFile(char const* path, Tlk* out, FileReadOptions const& options = FileReadOptions());
 
     // Writes the raw Tlk to disk.
     bool WriteToFile(char const* path) const;
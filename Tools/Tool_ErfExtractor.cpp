@@ -1,5 +1,7 @@
 #include "FileFormats/Erf.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/FileExtractor.hpp"
+#include "Utility/ThreadPool.hpp"
 
 namespace
 {
@@ -17,27 +19,33 @@ int extract_erf(const char* out_path, const char* in_path)
         return 1;
     }
 
-    Friendly::Erf erf(std::move(erf_raw));
+    // Only the tables are read here - the data is copied straight from the ERF to the output files.
+    std::vector<ExtractRange> ranges;
+    ranges.reserve(erf_raw.m_Keys.size());
 
-    for (const Friendly::ErfResource& resource : erf.GetResources())
+    for (std::size_t i = 0; i < erf_raw.m_Keys.size(); ++i)
     {
-        char path[512];
-        sprintf(path, "%s/%s.%s", out_path, resource.m_ResRef.c_str(), FileFormats::Resource::StringFromResourceType(resource.m_ResType));
-
-        FILE* file = std::fopen(path, "wb");
-        if (file)
-        {
-            std::printf("Writing %s.\n", path);
-            std::fwrite(resource.m_DataBlock->GetData(), resource.m_DataBlock->GetDataLength(), 1, file);
-            std::fclose(file);
-        }
-        else
-        {
-            std::printf("Failed to open %s\n", path);
-        }
+        const Raw::ErfKey& key = erf_raw.m_Keys[i];
+        const Raw::ErfResource& resource = erf_raw.m_Resources[i];
+
+        FileFormats::Resource::ResRef resref = FileFormats::Resource::ResRef::FromRawResRef(key.m_ResRef);
+        std::string path = std::string(out_path) + "/" + std::string(resref.GetString()) + "." + FileFormats::Resource::StringFromResourceType(key.m_ResType);
+
+        ranges.push_back({ 0, resource.m_OffsetToResource, resource.m_ResourceSize, std::move(path) });
     }
 
-    return 0;
+    ThreadPool pool;
+    std::vector<std::size_t> failures;
+    std::size_t written = ExtractFileRanges({ in_path }, ranges, pool, &failures);
+
+    for (std::size_t failure : failures)
+    {
+        std::printf("Failed to write %s\n", ranges[failure].m_OutputPath.c_str());
+    }
+
+    std::printf("Wrote %zu resources from %s to %s.\n", written, in_path, out_path);
+
+    return failures.empty() ? 0 : 1;
 }
 
 }
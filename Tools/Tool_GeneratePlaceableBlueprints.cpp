@@ -42,15 +42,18 @@ int GeneratePlaceableBlueprints(const char* twoDAPath, const char* blueprintPath
         return 1;
     }
 
-    Gff::Raw::Gff rawGff;
-    if (!Gff::Raw::Gff::ReadFromFile(blueprintPath, &rawGff))
+    Gff::Raw::GffView rawGff;
+    if (!Gff::Raw::GffView::ReadFromFile(blueprintPath, &rawGff))
     {
         std::printf("Failed to load the GFF file from %s.\n", blueprintPath);
         return 1;
     }
 
     TwoDA::Friendly::TwoDA twoDA(std::move(twoDARaw));
-    Gff::Friendly::Gff gff(std::move(rawGff));
+
+    // Each variant below is a copy of the blueprint. Copies share everything they don't modify, and whatever
+    // nobody modifies is copied straight from the file when saving.
+    Gff::Friendly::Gff blueprint = Gff::Friendly::Gff::Lazy(std::move(rawGff));
 
     std::string blueprintPathAsStr = blueprintPath;
     std::size_t lastDot = blueprintPathAsStr.find_last_of('.');
@@ -130,6 +133,7 @@ int GeneratePlaceableBlueprints(const char* twoDAPath, const char* blueprintPath
         resref.m_Size = static_cast<std::uint32_t>(modelName.size());
         std::memcpy(resref.m_String, modelName.data(), resref.m_Size);
 
+        Gff::Friendly::Gff gff = blueprint;
         gff.GetTopLevelStruct().WriteField("Appearance", appearance);
         gff.GetTopLevelStruct().WriteField("LocName", locName);
         gff.GetTopLevelStruct().WriteField("TemplateResRef", resref);
@@ -0,0 +1,155 @@
+#include "FileFormats/Gff.hpp"
+#include "Utility/Assert.hpp"
+#include "Utility/FileWriter.hpp"
+#include "Utility/MemoryMappedFile.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace FileFormats::Gff;
+
+bool IsJsonPath(std::string const& path)
+{
+    return path.size() > 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+}
+
+// Converts a single file in whichever direction its extension implies. json is reused between calls.
+bool Convert(std::string const& inPath, std::string const& outPath, std::string* json)
+{
+    if (IsJsonPath(inPath))
+    {
+        MemoryMappedFile memmap;
+        if (!MemoryMappedFile::MemoryMap(inPath.c_str(), &memmap))
+        {
+            return false;
+        }
+
+        NonOwningDataBlock const& data = memmap.GetDataBlock();
+        std::string_view text(reinterpret_cast<char const*>(data.GetData()), data.GetDataLength());
+
+        Raw::Gff gff;
+        return Json::ReadGffFromJson(text, &gff) && gff.WriteToFile(outPath.c_str());
+    }
+
+    Raw::GffView gff;
+    if (!Raw::GffView::ReadFromFile(inPath.c_str(), &gff))
+    {
+        return false;
+    }
+
+    json->clear();
+    if (!Json::WriteGffToJson(gff, json))
+    {
+        return false;
+    }
+
+    WriteBuffer buffer = { json->data(), json->size() };
+    return WriteBuffersToFile(outPath.c_str(), &buffer, 1);
+}
+
+// Converts every file in inDir into outDir: GFFs to <name>.json, and <name>.json back to <name>.
+// The files are shared out between threadCount threads as they become free.
+int ConvertDirectory(char const* inDir, char const* outDir, unsigned threadCount)
+{
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    fs::create_directories(outDir, error);
+
+    std::vector<std::string> paths;
+    for (fs::directory_entry const& entry : fs::directory_iterator(inDir, error))
+    {
+        if (entry.is_regular_file())
+        {
+            paths.emplace_back(entry.path().string());
+        }
+    }
+
+    if (error)
+    {
+        std::printf("Failed to read %s: %s\n", inDir, error.message().c_str());
+        return 1;
+    }
+
+    std::atomic<std::size_t> nextPath = 0;
+    std::atomic<std::size_t> failures = 0;
+
+    auto worker = [&]()
+    {
+        std::string json;
+
+        for (std::size_t i = nextPath++; i < paths.size(); i = nextPath++)
+        {
+            fs::path inPath(paths[i]);
+            fs::path outPath = fs::path(outDir) / inPath.filename();
+
+            if (IsJsonPath(paths[i]))
+            {
+                outPath.replace_extension();
+            }
+            else
+            {
+                outPath += ".json";
+            }
+
+            if (!Convert(paths[i], outPath.string(), &json))
+            {
+                std::printf("Failed to convert %s.\n", paths[i].c_str());
+                ++failures;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::printf("Converted %zu of %zu files.\n", paths.size() - failures, paths.size());
+    return failures ? 1 : 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 3)
+    {
+        std::string json;
+        if (!Convert(argv[1], argv[2], &json))
+        {
+            std::printf("Failed to convert %s.\n", argv[1]);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if ((argc == 4 || argc == 5) && std::strcmp(argv[1], "--batch") == 0)
+    {
+        unsigned threadCount = argc == 5 ? static_cast<unsigned>(std::atoi(argv[4])) : std::thread::hardware_concurrency();
+        return ConvertDirectory(argv[2], argv[3], threadCount ? threadCount : 1);
+    }
+
+    std::printf("gff_json [in_path] [out_path]\n");
+    std::printf("gff_json --batch [in_dir] [out_dir] [thread_count]\n");
+    std::printf("Files ending in .json are converted to GFF, and anything else from GFF to JSON.\n");
+    return 1;
+}
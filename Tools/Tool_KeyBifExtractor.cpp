@@ -1,133 +1,136 @@
 #include "FileFormats/Bif.hpp"
 #include "FileFormats/Key.hpp"
 #include "Utility/Assert.hpp"
+#include "Utility/FileExtractor.hpp"
+#include "Utility/ThreadPool.hpp"
 
-#include <map>
-
-#if OS_WINDOWS
-    #include "Windows.h"
-#else
-    #include <sys/stat.h>
-#endif
+#include <algorithm>
 
 namespace {
 
-// Recursively make the provided directory.
-void RecursivelyEnsureDir(std::string const& dir)
-{
-    for (std::size_t slashIndex = dir.find_first_of("\\/");
-        slashIndex != std::string::npos;
-        slashIndex = dir.find_first_of("\\/", slashIndex + 1))
-    {
-        std::string dirToMake = dir.substr(0, slashIndex);
-
-#if OS_WINDOWS
-        CreateDirectoryA(dirToMake.c_str(), NULL);
-#else
-        mkdir(dirToMake.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
-#endif
-    }
-}
-
 int KeyBifExtractor(char* keyPath, char* basePath, char* outPath);
 
 int KeyBifExtractor(char* keyPath, char* basePath, char* outPath)
 {
     using namespace FileFormats;
 
-    // We need to iterate over each BIF in turn, over all resources, which will allow us to extract the data to the correct file name.
-    // The first step is to go over every referenced resource, and sort them into BIF buckets.
-    // We'll extract by BIF. This prevents us from having to open all BIFs up front.
-    std::map<std::size_t, std::vector<Key::Friendly::KeyBifReferencedResource>> resMap;
+    Key::Raw::Key rawKey;
+    bool loaded = Key::Raw::Key::ReadFromFile(keyPath, &rawKey);
+
+    if (!loaded)
+    {
+        std::printf("Failed to load the KEY file.\n");
+        return 1;
+    }
+
+    Key::Friendly::Key key(std::move(rawKey));
+
+    // Where each resource is in each BIF, sorted by the ID the KEY refers to it by. Only the resource tables of the
+    // BIFs are read here - the data is copied straight from the BIFs to the output files below.
+    struct BifLocation
+    {
+        std::uint32_t m_Id;
+        std::uint32_t m_Offset;
+        std::uint32_t m_Size;
+    };
 
-    // We also take a copy of the references bifs for use later.
-    std::vector<Key::Friendly::KeyBifReference> bifRefs;
+    std::vector<std::string> bifPaths;
+    std::vector<std::string> bifFolders;
+    std::vector<std::vector<BifLocation>> bifLocations;
 
+    for (Key::Friendly::KeyBifReference const& bifref : key.GetReferencedBifs())
     {
-        Key::Raw::Key rawKey;
-        bool loaded = Key::Raw::Key::ReadFromFile(keyPath, &rawKey);
+        std::string bifPath = std::string(basePath) + "/" + bifref.m_Path.c_str();
 
-        if (!loaded)
+        // Infer the file name from the path.
+        std::string bifFileName = bifPath;
+        std::size_t lastSlash = bifFileName.find_last_of("\\/");
+        if (lastSlash != std::string::npos)
         {
-            std::printf("Failed to load the KEY file.\n");
-            return 1;
+            bifFileName.erase(0, lastSlash + 1);
         }
 
-        Key::Friendly::Key key(std::move(rawKey));
+        std::vector<BifLocation>& locations = bifLocations.emplace_back();
+
+        Bif::Raw::Bif rawBif;
+        loaded = Bif::Raw::Bif::ReadTablesFromFile(bifPath.c_str(), &rawBif);
+
+        if (loaded)
+        {
+            locations.reserve(rawBif.m_VariableResourceTable.size());
+
+            for (Bif::Raw::BifVariableResource const& rawRes : rawBif.m_VariableResourceTable)
+            {
+                // See Bif_Friendly.cpp for why only the bottom fourteen bits of the ID count.
+                locations.push_back({ rawRes.m_Id & 0x00003FFF, rawRes.m_Offset, rawRes.m_FileSize });
+            }
 
-        for (Key::Friendly::KeyBifReferencedResource const& res : key.GetReferencedResources())
+            std::sort(std::begin(locations), std::end(locations),
+                [](BifLocation const& lhs, BifLocation const& rhs) { return lhs.m_Id < rhs.m_Id; });
+        }
+        else
         {
-            resMap[res.m_ReferencedBifIndex].emplace_back(res);
+            std::printf("Failed to load the BIF file %s.\n", bifPath.c_str());
         }
 
-        bifRefs = key.GetReferencedBifs();
+        bifPaths.emplace_back(std::move(bifPath));
+        bifFolders.emplace_back(std::string(outPath) + "/" + bifFileName + "/");
     }
 
-    // At this point, we have every resource we care about. Now we iterate over every BIF that the KEY references,
-    // load it up, then extract all the referenced materials to the output path.
-    std::size_t totalExtractedResources = 0;
+    std::vector<ExtractRange> ranges;
+    ranges.reserve(key.GetReferencedResources().size());
 
-    for (std::size_t i = 0; i < bifRefs.size(); ++i)
+    for (Key::Friendly::KeyBifReferencedResource const& bifRefRes : key.GetReferencedResources())
     {
-        Key::Friendly::KeyBifReference const& bifref = bifRefs[i];
-        std::string bifPath = std::string(basePath) + "/" + bifref.m_Path;
-
-        Bif::Raw::Bif rawBif;
-        bool loaded = Bif::Raw::Bif::ReadFromFile(bifPath.c_str(), &rawBif);
-        ASSERT(loaded);
-
-        if (!loaded)
+        if (bifRefRes.m_ReferencedBifIndex >= bifLocations.size())
         {
-            std::printf("Failed to load the BIF file %s.\n", bifPath.c_str());
             continue;
         }
 
-        // Infer the file name from the path.
-        std::string bifFileName = bifPath;
-        std::size_t lastSlash = bifFileName.find_last_of("\\/");
-        if (lastSlash != std::string::npos)
+        std::vector<BifLocation> const& locations = bifLocations[bifRefRes.m_ReferencedBifIndex];
+        auto location = std::lower_bound(std::begin(locations), std::end(locations), bifRefRes.m_ReferencedBifResId,
+            [](BifLocation const& lhs, std::uint32_t id) { return lhs.m_Id < id; });
+
+        if (location == std::end(locations) || location->m_Id != bifRefRes.m_ReferencedBifResId)
         {
-            bifFileName.erase(0, lastSlash + 1);
+            continue;
         }
 
-        // Grab the directory for this bif. This will be used later.
-        std::string bifFolder = std::string(outPath) + "/" + bifFileName + "/";
-        RecursivelyEnsureDir(bifFolder);
+        std::string resourcePath = bifFolders[bifRefRes.m_ReferencedBifIndex] +
+            std::string(bifRefRes.m_ResRef.GetString()) + "." + Resource::StringFromResourceType(bifRefRes.m_ResType);
 
-        Bif::Friendly::Bif bif(std::move(rawBif));
-        std::size_t extractedResources = 0;
-
-        Bif::Friendly::Bif::BifResourceMap const& bifResMap = bif.GetResources();
+        ranges.push_back({ bifRefRes.m_ReferencedBifIndex, location->m_Offset, location->m_Size, std::move(resourcePath) });
+    }
 
-        // We're iterating over every resource that KEY calls out and that we've assigned to this BIF's bucket.
-        for (Key::Friendly::KeyBifReferencedResource const& bifRefRes : resMap[i])
-        {
-            auto resInBif = bifResMap.find(bifRefRes.m_ReferencedBifResId);
-            ASSERT(resInBif != std::end(bifResMap));
-            std::string resourcePath = bifFolder + bifRefRes.m_ResRef + "." + Resource::StringFromResourceType(bifRefRes.m_ResType);
+    ThreadPool pool;
+    std::vector<std::size_t> failures;
+    std::size_t totalExtractedResources = ExtractFileRanges(bifPaths, ranges, pool, &failures);
 
-            FILE* resFile = std::fopen(resourcePath.c_str(), "wb");
-            ASSERT(resFile);
+    for (std::size_t failure : failures)
+    {
+        std::printf("Failed to write %s.\n", ranges[failure].m_OutputPath.c_str());
+    }
 
-            if (!resFile)
-            {
-                std::printf("Failed to open %s for write.\n", resourcePath.c_str());
-                continue;
-            }
+    std::vector<std::size_t> extractedResources(bifPaths.size());
 
-            std::fwrite(resInBif->second.m_DataBlock->GetData(), resInBif->second.m_DataBlock->GetDataLength(), 1, resFile);
-            std::fclose(resFile);
+    for (ExtractRange const& range : ranges)
+    {
+        ++extractedResources[range.m_Source];
+    }
 
-            ++extractedResources;
-        }
+    for (std::size_t failure : failures)
+    {
+        --extractedResources[ranges[failure].m_Source];
+    }
 
-        std::printf("Extracted %zu resources from BIF %s to %s\n", extractedResources, bifPath.c_str(), bifFolder.c_str());
-        totalExtractedResources += extractedResources;
+    for (std::size_t i = 0; i < bifPaths.size(); ++i)
+    {
+        std::printf("Extracted %zu resources from BIF %s to %s\n", extractedResources[i], bifPaths[i].c_str(), bifFolders[i].c_str());
     }
 
     std::printf("Extracted %zu resources total referenced by KEY %s\n", totalExtractedResources, keyPath);
 
-    return 0;
+    return failures.empty() ? 0 : 1;
 }
 
 }
@@ -0,0 +1,268 @@
+#include "Utility/FileExtractor.hpp"
+#include "Utility/Assert.hpp"
+#include "Utility/FileWriter.hpp"
+#include "Utility/MemoryMappedFile.hpp"
+#include "Utility/ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <unordered_set>
+
+#if OS_LINUX
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/sendfile.h>
+    #include <unistd.h>
+
+    // glibc only wraps copy_file_range from 2.27 - older builds go straight to sendfile.
+    #if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+        #define HAS_COPY_FILE_RANGE 1
+    #else
+        #define HAS_COPY_FILE_RANGE 0
+    #endif
+#endif
+
+namespace {
+
+// Each thread takes this many consecutive ranges at a time. Most resources are a few KB, so this keeps a thread on
+// one stretch of one source for a while without leaving the last few threads idle while one finishes a long run.
+constexpr std::size_t RangesPerTask = 32;
+
+struct ExtractSource
+{
+    MemoryMappedFile m_Mapping;
+    NonOwningDataBlock m_Data = {};
+    bool m_Mapped = false;
+
+#if OS_LINUX
+    int m_FileDescriptor = -1;
+#endif
+};
+
+#if OS_LINUX
+
+// Set the first time the kernel turns down a way of copying, so the rest of the files go straight to the next one.
+struct KernelCopySupport
+{
+    std::atomic<bool> m_CopyFileRange { true };
+    std::atomic<bool> m_SendFile { true };
+};
+
+bool IsUnsupportedCopy(int error)
+{
+    return error == ENOSYS || error == EXDEV || error == EINVAL || error == EOPNOTSUPP;
+}
+
+bool WriteRange(ExtractSource const& source, ExtractRange const& range, KernelCopySupport& support)
+{
+    int fd = open(range.m_OutputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    // The source offset is passed explicitly to every call rather than kept in the descriptor, so one descriptor
+    // can be shared by every thread. The output is written at its own file position, so the methods can be mixed.
+    off_t sourceOffset = static_cast<off_t>(range.m_Offset);
+    std::uint64_t remaining = range.m_Length;
+    bool success = true;
+
+    while (remaining)
+    {
+        ssize_t copied;
+
+    #if HAS_COPY_FILE_RANGE
+        if (support.m_CopyFileRange)
+        {
+            copied = copy_file_range(source.m_FileDescriptor, &sourceOffset, fd, nullptr, remaining, 0);
+
+            if (copied == -1 && IsUnsupportedCopy(errno))
+            {
+                support.m_CopyFileRange = false;
+                continue;
+            }
+        }
+        else
+    #endif
+        if (support.m_SendFile)
+        {
+            copied = sendfile(fd, source.m_FileDescriptor, &sourceOffset, remaining);
+
+            if (copied == -1 && IsUnsupportedCopy(errno))
+            {
+                support.m_SendFile = false;
+                continue;
+            }
+        }
+        else
+        {
+            copied = write(fd, source.m_Data.GetData() + sourceOffset, remaining);
+
+            if (copied > 0)
+            {
+                sourceOffset += copied;
+            }
+        }
+
+        if (copied == -1 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (copied <= 0)
+        {
+            success = false;
+            break;
+        }
+
+        remaining -= static_cast<std::uint64_t>(copied);
+    }
+
+    return close(fd) == 0 && success;
+}
+
+#endif
+
+}
+
+std::size_t ExtractFileRanges(std::vector<std::string> const& sourcePaths, std::vector<ExtractRange>& ranges,
+    ThreadPool& pool, std::vector<std::size_t>* failures)
+{
+    namespace fs = std::filesystem;
+
+    // Two threads writing the same file at once would interleave, so only the last range for each path is kept -
+    // the one which would have been left on disk had they been written in order.
+    {
+        std::unordered_set<std::string> outputPaths;
+        std::vector<bool> keep(ranges.size());
+
+        for (std::size_t i = ranges.size(); i-- > 0;)
+        {
+            keep[i] = outputPaths.insert(ranges[i].m_OutputPath).second;
+        }
+
+        std::size_t kept = 0;
+
+        for (std::size_t i = 0; i < ranges.size(); ++i)
+        {
+            if (keep[i])
+            {
+                if (kept != i)
+                {
+                    ranges[kept] = std::move(ranges[i]);
+                }
+
+                ++kept;
+            }
+        }
+
+        ranges.resize(kept);
+    }
+
+    std::sort(std::begin(ranges), std::end(ranges),
+        [](ExtractRange const& lhs, ExtractRange const& rhs)
+        {
+            return lhs.m_Source < rhs.m_Source || (lhs.m_Source == rhs.m_Source && lhs.m_Offset < rhs.m_Offset);
+        });
+
+    {
+        std::unordered_set<std::string> directories;
+
+        for (ExtractRange const& range : ranges)
+        {
+            directories.insert(fs::path(range.m_OutputPath).parent_path().string());
+        }
+
+        for (std::string const& directory : directories)
+        {
+            std::error_code error;
+            fs::create_directories(directory, error);
+        }
+    }
+
+    std::vector<ExtractSource> sources(sourcePaths.size());
+
+    for (std::size_t i = 0; i < sourcePaths.size(); ++i)
+    {
+        ExtractSource& source = sources[i];
+
+        MemoryMapHints hints;
+        hints.m_Access = MemoryMapAccess::Sequential;
+        source.m_Mapped = MemoryMappedFile::MemoryMap(sourcePaths[i].c_str(), &source.m_Mapping, hints);
+
+        if (source.m_Mapped)
+        {
+            source.m_Data = source.m_Mapping.GetDataBlock();
+
+#if OS_LINUX
+            source.m_FileDescriptor = open(sourcePaths[i].c_str(), O_RDONLY | O_CLOEXEC);
+            source.m_Mapped = source.m_FileDescriptor != -1;
+
+            // The kernel copies read through the descriptor rather than the mapping, so it gets the hint as well.
+            if (source.m_Mapped)
+            {
+                posix_fadvise(source.m_FileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+            }
+#endif
+        }
+    }
+
+#if OS_LINUX
+    KernelCopySupport support;
+#endif
+
+    // Each range is only ever touched by the thread which took it, so the results need no locking.
+    std::vector<char> written(ranges.size(), 0);
+
+    pool.ParallelFor(ranges.size(), RangesPerTask, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            ExtractRange const& range = ranges[i];
+            ASSERT(range.m_Source < sources.size());
+
+            ExtractSource const& source = sources[range.m_Source];
+
+            if (!source.m_Mapped || range.m_Offset > source.m_Data.GetDataLength() ||
+                range.m_Length > source.m_Data.GetDataLength() - range.m_Offset)
+            {
+                continue;
+            }
+
+#if OS_LINUX
+            written[i] = WriteRange(source, range, support);
+#else
+            WriteBuffer buffer = { source.m_Data.GetData() + range.m_Offset, static_cast<std::size_t>(range.m_Length) };
+            written[i] = WriteBuffersToFile(range.m_OutputPath.c_str(), &buffer, 1);
+#endif
+        }
+    });
+
+#if OS_LINUX
+    for (ExtractSource const& source : sources)
+    {
+        if (source.m_FileDescriptor != -1)
+        {
+            close(source.m_FileDescriptor);
+        }
+    }
+#endif
+
+    std::size_t writtenCount = 0;
+
+    for (std::size_t i = 0; i < ranges.size(); ++i)
+    {
+        if (written[i])
+        {
+            ++writtenCount;
+        }
+        else if (failures)
+        {
+            failures->push_back(i);
+        }
+    }
+
+    return writtenCount;
+}
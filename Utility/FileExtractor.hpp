@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// A range of bytes in one of the source files, to be written out as a file of its own.
+struct ExtractRange
+{
+    // The index of the source file in the paths given to ExtractFileRanges.
+    std::size_t m_Source;
+
+    std::uint64_t m_Offset;
+    std::uint64_t m_Length;
+
+    std::string m_OutputPath;
+};
+
+// Writes each range to its output path, spread across the pool, and returns the number written. The position in the
+// sorted ranges of every range which couldn't be written (its source couldn't be opened, it runs past the end of its
+// source, or the output couldn't be written) is appended to failures, if given.
+//
+// This is meant for extracting whole archives, so it does the work in the order the disk would like:
+// - The ranges are sorted by source and offset, in place, and threads take them in runs of consecutive ranges, so
+//   each thread reads forward through one source at a time.
+// - Every output directory is created once, up front.
+// - On Linux the bytes are copied file to file by the kernel (copy_file_range, or sendfile where that isn't
+//   supported) rather than passing through user space. Elsewhere they are written from a mapping of the source.
+//
+// Where two ranges share an output path, only the one which came last is kept in ranges and written.
+std::size_t ExtractFileRanges(std::vector<std::string> const& sourcePaths, std::vector<ExtractRange>& ranges,
+    ThreadPool& pool, std::vector<std::size_t>* failures = nullptr);
@@ -0,0 +1,725 @@
+#include "Utility/FileReader.hpp"
+#include "Utility/Assert.hpp"
+#include "Utility/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#if OS_WINDOWS
+    #include "Windows.h"
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#if OS_LINUX
+    #include <sys/syscall.h>
+
+    // The ring is driven with the raw system calls, so all that's needed is a kernel header new enough to have them.
+    #if defined(__NR_io_uring_setup) && defined(__has_include)
+        #if __has_include(<linux/io_uring.h>)
+            #define HAS_IO_URING 1
+            #include <linux/io_uring.h>
+            #include <sys/mman.h>
+        #endif
+    #endif
+#endif
+
+#if !defined(HAS_IO_URING)
+    #define HAS_IO_URING 0
+#endif
+
+namespace {
+
+// Returns the length of the range within a file of the given size, or false if it runs past the end.
+bool ResolveRange(FileReader::Range const& range, std::uint64_t size, std::uint64_t* length)
+{
+    if (range.m_Offset > size)
+    {
+        return false;
+    }
+
+    if (range.m_Length == MemoryMappedFile::ToEndOfFile)
+    {
+        *length = size - range.m_Offset;
+        return true;
+    }
+
+    *length = range.m_Length;
+    return range.m_Length <= size - range.m_Offset;
+}
+
+// A file opened for reads at explicit offsets, which any number of threads can make at once.
+class ReadHandle
+{
+public:
+    ReadHandle() = default;
+    ReadHandle(ReadHandle const&) = delete;
+    ReadHandle& operator=(ReadHandle const&) = delete;
+
+    ~ReadHandle()
+    {
+#if OS_WINDOWS
+        if (m_File != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_File);
+        }
+#else
+        if (m_FileDescriptor != -1)
+        {
+            close(m_FileDescriptor);
+        }
+#endif
+    }
+
+    bool Open(char const* path, std::uint64_t* size)
+    {
+#if OS_WINDOWS
+        m_File = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        LARGE_INTEGER fileSize;
+
+        if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &fileSize))
+        {
+            return false;
+        }
+
+        *size = static_cast<std::uint64_t>(fileSize.QuadPart);
+#else
+        m_FileDescriptor = open(path, O_RDONLY | O_CLOEXEC);
+        struct stat statBuffer;
+
+        if (m_FileDescriptor == -1 || fstat(m_FileDescriptor, &statBuffer) == -1)
+        {
+            return false;
+        }
+
+        *size = static_cast<std::uint64_t>(statBuffer.st_size);
+#endif
+        return true;
+    }
+
+    // Reads exactly length bytes. Fails if the file ends first.
+    bool ReadAt(std::uint64_t offset, std::byte* data, std::uint64_t length) const
+    {
+        while (length)
+        {
+#if OS_WINDOWS
+            // ReadFile takes a 32 bit length, so large reads are made in pieces.
+            DWORD chunk = static_cast<DWORD>((std::min)(length, static_cast<std::uint64_t>(1) << 30));
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+            DWORD read = 0;
+            if (!ReadFile(m_File, data, chunk, &read, &overlapped) || read == 0)
+            {
+                return false;
+            }
+#else
+            ssize_t read = pread(m_FileDescriptor, data, static_cast<std::size_t>(length), static_cast<off_t>(offset));
+
+            if (read == -1 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (read <= 0)
+            {
+                return false;
+            }
+#endif
+
+            offset += static_cast<std::uint64_t>(read);
+            data += read;
+            length -= static_cast<std::uint64_t>(read);
+        }
+
+        return true;
+    }
+
+#if !OS_WINDOWS
+    int GetFileDescriptor() const
+    {
+        return m_FileDescriptor;
+    }
+#endif
+
+private:
+#if OS_WINDOWS
+    HANDLE m_File = INVALID_HANDLE_VALUE;
+#else
+    int m_FileDescriptor = -1;
+#endif
+};
+
+std::unique_ptr<DataBlock> ReadIntoBlock(ReadHandle const& handle, std::uint64_t offset, std::uint64_t length)
+{
+    std::unique_ptr<OwningDataBlock> block = std::make_unique<OwningDataBlock>();
+    block->m_Data.resize(static_cast<std::size_t>(length));
+
+    if (!handle.ReadAt(offset, block->m_Data.data(), length))
+    {
+        return nullptr;
+    }
+
+    return block;
+}
+
+struct SharedMapping
+{
+    MemoryMappedFile m_File;
+    NonOwningDataBlock m_Data;
+};
+
+// Part of a mapping, which keeps the mapping alive for as long as the block.
+struct MappedDataBlock : public DataBlock
+{
+    MappedDataBlock(std::shared_ptr<SharedMapping const> mapping, std::byte const* data, std::size_t dataLength)
+        : m_Mapping(std::move(mapping)),
+          m_Data(data),
+          m_DataLength(dataLength)
+    { }
+
+    virtual std::byte const* GetData() const override { return m_Data; }
+    virtual std::size_t GetDataLength() const override { return m_DataLength; }
+
+    std::shared_ptr<SharedMapping const> m_Mapping;
+    std::byte const* m_Data;
+    std::size_t m_DataLength;
+};
+
+class MemoryMapFileReader : public FileReader
+{
+public:
+    explicit MemoryMapFileReader(std::shared_ptr<SharedMapping const> mapping)
+        : FileReader(FileReadBackend::MemoryMap),
+          m_Mapping(std::move(mapping))
+    {
+        m_Size = m_Mapping->m_Data.GetDataLength();
+    }
+
+    virtual std::uint64_t GetMappedByteCount() const override
+    {
+        return m_Size;
+    }
+
+    virtual bool HasBlocksInUse() const override
+    {
+        return m_Mapping.use_count() > 1;
+    }
+
+    virtual std::unique_ptr<DataBlock> Read(Range const& range) const override
+    {
+        std::uint64_t length;
+
+        if (!ResolveRange(range, m_Size, &length))
+        {
+            return nullptr;
+        }
+
+        return std::make_unique<MappedDataBlock>(m_Mapping, m_Mapping->m_Data.GetData() + range.m_Offset,
+            static_cast<std::size_t>(length));
+    }
+
+private:
+    std::shared_ptr<SharedMapping const> m_Mapping;
+};
+
+class ReadFileReader : public FileReader
+{
+public:
+    explicit ReadFileReader(FileReadBackend backend = FileReadBackend::Read) : FileReader(backend)
+    { }
+
+    bool OpenFile(char const* path)
+    {
+        return m_Handle.Open(path, &m_Size);
+    }
+
+    virtual std::unique_ptr<DataBlock> Read(Range const& range) const override
+    {
+        std::uint64_t length;
+
+        if (!ResolveRange(range, m_Size, &length))
+        {
+            return nullptr;
+        }
+
+        return ReadIntoBlock(m_Handle, range.m_Offset, length);
+    }
+
+protected:
+    ReadHandle m_Handle;
+};
+
+#if HAS_IO_URING
+
+// A read for the ring to make. m_Done counts the bytes read so far, however they were read.
+struct RingRead
+{
+    std::uint64_t m_Offset;
+    std::byte* m_Data;
+    std::uint64_t m_Length;
+    std::uint64_t m_Done;
+};
+
+// Just enough of io_uring to submit a batch of reads and wait for them.
+class IoUring
+{
+public:
+    IoUring() = default;
+    IoUring(IoUring const&) = delete;
+    IoUring& operator=(IoUring const&) = delete;
+
+    ~IoUring()
+    {
+        Unmap(m_SqRing, m_SqRingSize);
+        Unmap(m_CqRing, m_CqRingSize);
+        Unmap(m_Sqes, m_SqesSize);
+
+        if (m_RingFileDescriptor != -1)
+        {
+            close(m_RingFileDescriptor);
+        }
+    }
+
+    bool Initialise(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        m_RingFileDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+
+        if (m_RingFileDescriptor < 0)
+        {
+            m_RingFileDescriptor = -1;
+            return false;
+        }
+
+        m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        m_SqRing = Map(m_SqRingSize, IORING_OFF_SQ_RING);
+        m_CqRing = Map(m_CqRingSize, IORING_OFF_CQ_RING);
+        m_Sqes = static_cast<io_uring_sqe*>(Map(m_SqesSize, IORING_OFF_SQES));
+
+        if (!m_SqRing || !m_CqRing || !m_Sqes)
+        {
+            return false;
+        }
+
+        std::byte* sq = static_cast<std::byte*>(m_SqRing);
+        m_SqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_SqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_SqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        std::byte* cq = static_cast<std::byte*>(m_CqRing);
+        m_CqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_CqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_CqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_Cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        m_Entries = params.sq_entries;
+        return true;
+    }
+
+    // Makes one attempt at every read, with as many in flight at once as the ring holds. Reads which fail or come
+    // up short - the ring has no obligation to read everything asked of it - are left for the caller to finish.
+    // Returns false if the ring stopped working, in which case it shouldn't be used again.
+    bool Read(int fileDescriptor, std::vector<RingRead>& reads)
+    {
+        std::size_t next = 0;
+        unsigned queued = 0; // In the submission queue, but not yet taken by the kernel.
+        unsigned inFlight = 0; // Taken by the kernel, but not yet completed.
+        bool working = true;
+
+        while (inFlight || queued || (working && next < reads.size()))
+        {
+            unsigned tail = *m_SqTail;
+
+            while (working && next < reads.size() && queued + inFlight < m_Entries)
+            {
+                RingRead& read = reads[next];
+                unsigned index = tail & m_SqMask;
+
+                io_uring_sqe* sqe = &m_Sqes[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = fileDescriptor;
+                sqe->off = read.m_Offset;
+                sqe->addr = reinterpret_cast<std::uint64_t>(read.m_Data);
+                sqe->len = static_cast<std::uint32_t>(std::min<std::uint64_t>(read.m_Length, MaxReadLength));
+                sqe->user_data = next;
+
+                m_SqArray[index] = index;
+                ++tail;
+                ++queued;
+                ++next;
+            }
+
+            __atomic_store_n(m_SqTail, tail, __ATOMIC_RELEASE);
+
+            long submitted = syscall(__NR_io_uring_enter, m_RingFileDescriptor, working ? queued : 0, 1,
+                IORING_ENTER_GETEVENTS, nullptr, 0);
+
+            if (submitted < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                {
+                    continue;
+                }
+
+                // Whatever is in flight still has to be waited for - it's reading into the caller's buffers. If even
+                // waiting fails there's nothing safe left to do.
+                if (!working || !inFlight)
+                {
+                    ASSERT_MSG(!inFlight, "io_uring stopped responding with %u reads in flight.", inFlight);
+                    return false;
+                }
+
+                working = false;
+                queued = 0;
+                continue;
+            }
+
+            queued -= static_cast<unsigned>(submitted);
+            inFlight += static_cast<unsigned>(submitted);
+
+            unsigned head = *m_CqHead;
+            unsigned completed = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+
+            for (; head != completed; ++head)
+            {
+                io_uring_cqe const& cqe = m_Cqes[head & m_CqMask];
+
+                if (cqe.res > 0)
+                {
+                    reads[cqe.user_data].m_Done = static_cast<std::uint64_t>(cqe.res);
+                }
+
+                --inFlight;
+            }
+
+            __atomic_store_n(m_CqHead, head, __ATOMIC_RELEASE);
+        }
+
+        return working;
+    }
+
+private:
+    // The largest read made in one go. Anything left over is finished by the caller.
+    static constexpr std::uint64_t MaxReadLength = 1u << 30;
+
+    void* Map(std::size_t size, off_t offset)
+    {
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFileDescriptor, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    static void Unmap(void* ptr, std::size_t size)
+    {
+        if (ptr)
+        {
+            munmap(ptr, size);
+        }
+    }
+
+    int m_RingFileDescriptor = -1;
+    unsigned m_Entries = 0;
+
+    void* m_SqRing = nullptr;
+    std::size_t m_SqRingSize = 0;
+    unsigned* m_SqTail = nullptr;
+    unsigned m_SqMask = 0;
+    unsigned* m_SqArray = nullptr;
+
+    void* m_CqRing = nullptr;
+    std::size_t m_CqRingSize = 0;
+    unsigned* m_CqHead = nullptr;
+    unsigned* m_CqTail = nullptr;
+    unsigned m_CqMask = 0;
+    io_uring_cqe* m_Cqes = nullptr;
+
+    io_uring_sqe* m_Sqes = nullptr;
+    std::size_t m_SqesSize = 0;
+};
+
+// The one ring every batched reader in the process shares. A ring costs a descriptor and three mappings of its own,
+// which count against the same limits as the files being read, and a ring only takes one batch at a time anyway.
+class SharedRing
+{
+public:
+    static SharedRing& Get()
+    {
+        static SharedRing ring;
+        return ring;
+    }
+
+    // The ring is only made the first time it's asked for, and only kept once it's known to work, so a kernel or
+    // sandbox without io_uring costs nothing more than one failed setup call.
+    bool IsWorking()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (!m_Initialised)
+        {
+            m_Initialised = true;
+            std::unique_ptr<IoUring> ring = std::make_unique<IoUring>();
+
+            if (ring->Initialise(RingEntries))
+            {
+                m_Ring = std::move(ring);
+            }
+        }
+
+        return m_Ring != nullptr;
+    }
+
+    // See IoUring::Read. If the ring has stopped working since IsWorking, nothing is read.
+    void Read(int fileDescriptor, std::vector<RingRead>& reads)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_Ring && !m_Ring->Read(fileDescriptor, reads))
+        {
+            m_Ring.reset();
+        }
+    }
+
+private:
+    static constexpr unsigned RingEntries = 64;
+
+    std::mutex m_Mutex;
+    bool m_Initialised = false;
+    std::unique_ptr<IoUring> m_Ring;
+};
+
+#endif
+
+class BatchedFileReader : public ReadFileReader
+{
+public:
+    explicit BatchedFileReader(ThreadPool* pool) : ReadFileReader(FileReadBackend::Batched), m_Pool(pool)
+    { }
+
+    virtual void ReadBatch(Span<Range const> ranges, std::unique_ptr<DataBlock>* out) const override
+    {
+#if HAS_IO_URING
+        if (ReadBatchWithRing(ranges, out))
+        {
+            return;
+        }
+#endif
+
+        if (!m_Pool)
+        {
+            FileReader::ReadBatch(ranges, out);
+            return;
+        }
+
+        // Each read blocks its thread, so they're handed out one at a time.
+        m_Pool->ParallelFor(ranges.size(), 1, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                out[i] = Read(ranges[i]);
+            }
+        });
+    }
+
+private:
+#if HAS_IO_URING
+    bool ReadBatchWithRing(Span<Range const> ranges, std::unique_ptr<DataBlock>* out) const
+    {
+        SharedRing& ring = SharedRing::Get();
+
+        if (!ring.IsWorking())
+        {
+            return false;
+        }
+
+        std::vector<std::unique_ptr<OwningDataBlock>> blocks(ranges.size());
+        std::vector<RingRead> reads;
+        std::vector<std::size_t> readRanges;
+        reads.reserve(ranges.size());
+        readRanges.reserve(ranges.size());
+
+        for (std::size_t i = 0; i < ranges.size(); ++i)
+        {
+            std::uint64_t length;
+
+            if (!ResolveRange(ranges[i], m_Size, &length))
+            {
+                continue;
+            }
+
+            blocks[i] = std::make_unique<OwningDataBlock>();
+            blocks[i]->m_Data.resize(static_cast<std::size_t>(length));
+
+            if (length)
+            {
+                reads.push_back({ ranges[i].m_Offset, blocks[i]->m_Data.data(), length, 0 });
+                readRanges.push_back(i);
+            }
+        }
+
+        ring.Read(m_Handle.GetFileDescriptor(), reads);
+
+        // Whatever the ring didn't read - a short read, a failed one, or all of it if the kernel doesn't know
+        // IORING_OP_READ or the ring stopped working - is read the ordinary way.
+        for (std::size_t i = 0; i < reads.size(); ++i)
+        {
+            RingRead const& read = reads[i];
+
+            if (read.m_Done < read.m_Length &&
+                !m_Handle.ReadAt(read.m_Offset + read.m_Done, read.m_Data + read.m_Done, read.m_Length - read.m_Done))
+            {
+                blocks[readRanges[i]].reset();
+            }
+        }
+
+        for (std::size_t i = 0; i < ranges.size(); ++i)
+        {
+            out[i] = std::move(blocks[i]);
+        }
+
+        return true;
+    }
+#endif
+
+    ThreadPool* m_Pool;
+};
+
+}
+
+FileReader::FileReader(FileReadBackend backend) : m_Size(0), m_Backend(backend)
+{ }
+
+FileReader::~FileReader()
+{ }
+
+std::unique_ptr<FileReader> FileReader::Open(char const* path, FileReadOptions const& options)
+{
+    ASSERT(path);
+
+    switch (options.m_Backend)
+    {
+        case FileReadBackend::MemoryMap:
+        {
+            std::shared_ptr<SharedMapping> mapping = std::make_shared<SharedMapping>();
+
+            if (!MemoryMappedFile::MemoryMap(path, &mapping->m_File, options.m_Hints))
+            {
+                return nullptr;
+            }
+
+            mapping->m_Data = mapping->m_File.GetDataBlock();
+            return std::make_unique<MemoryMapFileReader>(std::move(mapping));
+        }
+
+        case FileReadBackend::Read:
+        {
+            std::unique_ptr<ReadFileReader> reader = std::make_unique<ReadFileReader>();
+            return reader->OpenFile(path) ? std::move(reader) : nullptr;
+        }
+
+        case FileReadBackend::Batched:
+        {
+            std::unique_ptr<BatchedFileReader> reader = std::make_unique<BatchedFileReader>(options.m_ThreadPool);
+            return reader->OpenFile(path) ? std::move(reader) : nullptr;
+        }
+    }
+
+    ASSERT_FAIL_MSG("Unknown FileReadBackend %d.", static_cast<int>(options.m_Backend));
+    return nullptr;
+}
+
+std::unique_ptr<DataBlock> FileReader::ReadRange(char const* path, Range const& range, FileReadOptions const& options)
+{
+    ASSERT(path);
+
+    // An empty range can't be mapped, so it's read the same way as with the other backends - checked against the
+    // size of the file, with nothing read.
+    if (options.m_Backend == FileReadBackend::MemoryMap && range.m_Length != 0)
+    {
+        std::shared_ptr<SharedMapping> mapping = std::make_shared<SharedMapping>();
+
+        if (!MemoryMappedFile::MemoryMapRange(path, range.m_Offset, range.m_Length, &mapping->m_File, options.m_Hints))
+        {
+            return nullptr;
+        }
+
+        mapping->m_Data = mapping->m_File.GetDataBlock();
+
+        // The mapping is clamped to the end of the file, where a read fails instead.
+        if (range.m_Length != MemoryMappedFile::ToEndOfFile && mapping->m_Data.GetDataLength() != range.m_Length)
+        {
+            return nullptr;
+        }
+
+        std::byte const* data = mapping->m_Data.GetData();
+        std::size_t dataLength = mapping->m_Data.GetDataLength();
+        return std::make_unique<MappedDataBlock>(std::move(mapping), data, dataLength);
+    }
+
+    // Batching is no help with a single read.
+    ReadHandle handle;
+    std::uint64_t size;
+    std::uint64_t length;
+
+    if (!handle.Open(path, &size) || !ResolveRange(range, size, &length))
+    {
+        return nullptr;
+    }
+
+    return ReadIntoBlock(handle, range.m_Offset, length);
+}
+
+FileReadBackend FileReader::GetBackend() const
+{
+    return m_Backend;
+}
+
+std::uint64_t FileReader::GetSize() const
+{
+    return m_Size;
+}
+
+std::uint64_t FileReader::GetMappedByteCount() const
+{
+    return 0;
+}
+
+bool FileReader::HasBlocksInUse() const
+{
+    return false;
+}
+
+void FileReader::ReadBatch(Span<Range const> ranges, std::unique_ptr<DataBlock>* out) const
+{
+    for (std::size_t i = 0; i < ranges.size(); ++i)
+    {
+        out[i] = Read(ranges[i]);
+    }
+}
+
+bool ReadEntireFile(char const* path, std::vector<std::byte>* out)
+{
+    ASSERT(path);
+    ASSERT(out);
+
+    ReadHandle handle;
+    std::uint64_t size;
+
+    if (!handle.Open(path, &size) || size == 0)
+    {
+        return false;
+    }
+
+    out->resize(static_cast<std::size_t>(size));
+    return handle.ReadAt(0, out->data(), size);
+}
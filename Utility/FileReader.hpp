@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Utility/DataBlock.hpp"
+#include "Utility/MemoryMappedFile.hpp"
+#include "Utility/Span.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+// How a file is read.
+enum class FileReadBackend
+{
+    // The file is mapped, and reads return views into the mapping. Nothing is copied, and nothing is read from disk
+    // until it is touched - the best choice for local disks, and the default.
+    MemoryMap,
+
+    // Reads copy the bytes into a buffer of their own with pread (ReadFile on Windows). This uses no address space,
+    // and only reads what is asked for when it is asked for - which suits network file systems, where page faults
+    // are slow, and containers with tight limits on virtual memory.
+    Read,
+
+    // As Read, except that batches of reads are submitted to the kernel together with io_uring, rather than read
+    // one after another. Where io_uring isn't available (older kernels, other platforms, or where a sandbox forbids
+    // it) the batch is spread across the ThreadPool given in the options instead. Every batched reader in the process
+    // shares one ring, which takes one batch at a time.
+    Batched
+};
+
+struct FileReadOptions
+{
+    FileReadBackend m_Backend = FileReadBackend::MemoryMap;
+
+    // Passed on to the mapping if the file is mapped, and ignored otherwise.
+    MemoryMapHints m_Hints;
+
+    // Batched reads fall back to this when io_uring isn't available. With no pool they are read one at a time.
+    ThreadPool* m_ThreadPool = nullptr;
+};
+
+// Random access to the bytes of a file through one of the backends above. Every function can be called from any
+// number of threads at once.
+class FileReader
+{
+public:
+    struct Range
+    {
+        std::uint64_t m_Offset;
+
+        // MemoryMappedFile::ToEndOfFile reads everything from the offset onwards.
+        std::uint64_t m_Length;
+    };
+
+    // Returns nullptr if the file can't be opened (or, with the MemoryMap backend, mapped).
+    static std::unique_ptr<FileReader> Open(char const* path, FileReadOptions const& options = FileReadOptions());
+
+    // Reads one range of a file without keeping it open. With the MemoryMap backend only the range is mapped.
+    static std::unique_ptr<DataBlock> ReadRange(char const* path, Range const& range,
+        FileReadOptions const& options = FileReadOptions());
+
+    virtual ~FileReader();
+
+    FileReadBackend GetBackend() const;
+    std::uint64_t GetSize() const;
+
+    // How much address space the reader holds - the size of the file if it is mapped, and nothing otherwise.
+    virtual std::uint64_t GetMappedByteCount() const;
+
+    // Whether any block read from the reader still holds on to what the reader holds - which only mapped blocks do.
+    // Closing the reader wouldn't release its mapping until they are gone.
+    virtual bool HasBlocksInUse() const;
+
+    // Returns the bytes in the range, or nullptr if the range runs past the end of the file or couldn't be read.
+    // The block doesn't depend on the reader, so it can be kept after the reader is destroyed.
+    virtual std::unique_ptr<DataBlock> Read(Range const& range) const = 0;
+
+    // Reads every range, putting the result of ranges[i] (as Read returns it) in out[i].
+    virtual void ReadBatch(Span<Range const> ranges, std::unique_ptr<DataBlock>* out) const;
+
+protected:
+    explicit FileReader(FileReadBackend backend);
+
+    // Set by the backend once it has opened the file.
+    std::uint64_t m_Size;
+
+private:
+    FileReadBackend m_Backend;
+};
+
+// Reads the whole of a file into memory with the Read backend. Fails for an empty file, as mapping one does.
+// This is what the ReadFromFile functions of the formats use for any backend other than MemoryMap - a format read
+// from a file as a whole gains nothing from batching.
+bool ReadEntireFile(char const* path, std::vector<std::byte>* out);
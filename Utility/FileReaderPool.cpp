@@ -0,0 +1,150 @@
+#include "Utility/FileReaderPool.hpp"
+#include "Utility/Assert.hpp"
+
+#include <filesystem>
+
+namespace {
+
+bool SameOptions(FileReadOptions const& lhs, FileReadOptions const& rhs)
+{
+    return lhs.m_Backend == rhs.m_Backend &&
+        lhs.m_Hints.m_Access == rhs.m_Hints.m_Access &&
+        lhs.m_Hints.m_Prefetch == rhs.m_Hints.m_Prefetch &&
+        lhs.m_Hints.m_HugePages == rhs.m_Hints.m_HugePages &&
+        lhs.m_ThreadPool == rhs.m_ThreadPool;
+}
+
+}
+
+FileReaderPool::FileReaderPool(std::size_t maxOpenFiles, std::uint64_t maxMappedBytes,
+    FileReadOptions const& defaultOptions)
+    : m_MaxOpenFiles(maxOpenFiles),
+      m_MaxMappedBytes(maxMappedBytes),
+      m_MappedBytes(0),
+      m_DefaultOptions(defaultOptions)
+{ }
+
+void FileReaderPool::SetBudgets(std::size_t maxOpenFiles, std::uint64_t maxMappedBytes)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaxOpenFiles = maxOpenFiles;
+    m_MaxMappedBytes = maxMappedBytes;
+    Trim(m_MaxOpenFiles, m_MaxMappedBytes);
+}
+
+FileReadOptions const& FileReaderPool::GetDefaultOptions() const
+{
+    return m_DefaultOptions;
+}
+
+FileReaderPool::FileId FileReaderPool::Register(std::string const& path)
+{
+    return Register(path, m_DefaultOptions);
+}
+
+FileReaderPool::FileId FileReaderPool::Register(std::string const& path, FileReadOptions const& options)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::vector<FileId>& ids = m_FileIds[path];
+
+    for (FileId id : ids)
+    {
+        if (SameOptions(m_Files[id].m_Options, options))
+        {
+            return id;
+        }
+    }
+
+    ids.push_back(m_Files.size());
+    m_Files.emplace_back();
+    m_Files.back().m_Path = path;
+    m_Files.back().m_Options = options;
+    return ids.back();
+}
+
+std::shared_ptr<FileReader const> FileReaderPool::Acquire(FileId id)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ASSERT(id < m_Files.size());
+
+    File& file = m_Files[id];
+
+    if (file.m_Reader)
+    {
+        m_LeastRecentlyUsed.splice(std::begin(m_LeastRecentlyUsed), m_LeastRecentlyUsed, file.m_Use);
+
+        // Files released since the last Acquire may have left the pool over its budgets with nothing to close them,
+        // so this trims too. The reader is held past Trim, as below.
+        std::shared_ptr<FileReader> reader = file.m_Reader;
+        Trim(m_MaxOpenFiles, m_MaxMappedBytes);
+        return reader;
+    }
+
+    if (file.m_Missing)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<FileReader> reader = FileReader::Open(file.m_Path.c_str(), file.m_Options);
+
+    if (!reader && !m_LeastRecentlyUsed.empty())
+    {
+        // Running out of descriptors or address space is the likeliest reason for a file which is there to fail to
+        // open, so close every file which isn't in use and try once more.
+        Trim(0, 0);
+        reader = FileReader::Open(file.m_Path.c_str(), file.m_Options);
+    }
+
+    if (!reader)
+    {
+        // Only a file which isn't there is remembered - anything else may well open next time.
+        std::error_code error;
+        file.m_Missing = !std::filesystem::exists(file.m_Path, error) && !error;
+        return nullptr;
+    }
+
+    file.m_Reader = reader;
+    file.m_Use = m_LeastRecentlyUsed.insert(std::begin(m_LeastRecentlyUsed), id);
+    m_MappedBytes += reader->GetMappedByteCount();
+
+    // The new reader is held below until after Trim, so it is in use and Trim leaves it alone.
+    Trim(m_MaxOpenFiles, m_MaxMappedBytes);
+    return reader;
+}
+
+std::size_t FileReaderPool::GetOpenFileCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_LeastRecentlyUsed.size();
+}
+
+std::uint64_t FileReaderPool::GetMappedByteCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_MappedBytes;
+}
+
+void FileReaderPool::Trim(std::size_t maxOpenFiles, std::uint64_t maxMappedBytes)
+{
+    auto use = std::end(m_LeastRecentlyUsed);
+
+    while (use != std::begin(m_LeastRecentlyUsed) &&
+        (m_LeastRecentlyUsed.size() > maxOpenFiles || m_MappedBytes > maxMappedBytes))
+    {
+        --use;
+        File& file = m_Files[*use];
+
+        // New references to the reader are only made under the lock, and blocks are only read from it through one,
+        // so if the pool holds the only reference and no blocks are left, it's safe to drop. One released on another
+        // thread since this was checked is just left for next time.
+        if (file.m_Reader.use_count() > 1 || file.m_Reader->HasBlocksInUse())
+        {
+            continue;
+        }
+
+        m_MappedBytes -= file.m_Reader->GetMappedByteCount();
+        file.m_Reader.reset();
+        use = m_LeastRecentlyUsed.erase(use);
+    }
+}
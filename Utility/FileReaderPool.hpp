@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Utility/FileReader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Open readers for a set of files - the archives resources are read from - shared by everything reading them.
+// A file is opened the first time it is acquired and stays open afterwards, so reading from it again costs no more
+// than the read itself, until the pool has more files open or more bytes mapped than its budgets allow. Then the
+// files used least recently are closed until it is back within them.
+//
+// A file which is in use - one which an acquired reader, or a mapped block read from one, still refers to - is never
+// closed to make room, so the budgets are only exceeded while more is in use at once than they allow - and once it
+// is released, until the next file is acquired. Every function can be called from any number of threads at once.
+class FileReaderPool
+{
+public:
+    using FileId = std::size_t;
+
+    // Files read with the Read and Batched backends - and on Windows, mapped files too - hold a descriptor for as long
+    // as they are open, and every process has its own limit on those (often 1024).
+    static constexpr std::size_t DefaultMaxOpenFiles = 256;
+
+    // Address space is only scarce in 32 bit processes, but a budget still keeps the page tables in check. Only files
+    // read with the MemoryMap backend count against it.
+    static constexpr std::uint64_t DefaultMaxMappedBytes = sizeof(void*) >= 8 ? 64ull << 30 : 1ull << 30;
+
+    // Files registered without options of their own are read with defaultOptions.
+    explicit FileReaderPool(std::size_t maxOpenFiles = DefaultMaxOpenFiles,
+        std::uint64_t maxMappedBytes = DefaultMaxMappedBytes, FileReadOptions const& defaultOptions = FileReadOptions());
+
+    FileReaderPool(FileReaderPool const&) = delete;
+    FileReaderPool& operator=(FileReaderPool const&) = delete;
+
+    // Changing the budgets closes whatever no longer fits straight away.
+    void SetBudgets(std::size_t maxOpenFiles, std::uint64_t maxMappedBytes);
+
+    FileReadOptions const& GetDefaultOptions() const;
+
+    // Returns the ID to acquire the file with. Nothing is opened until then. Registering the same path with the same
+    // options more than once returns the same ID, so everything reading the file the same way shares one reader.
+    // Registering it with different options - even just different hints - gives it a reader of its own.
+    FileId Register(std::string const& path);
+    FileId Register(std::string const& path, FileReadOptions const& options);
+
+    // Returns a reader for the file, opening it first if it isn't already. Returns nullptr if the file can't be
+    // opened. A file which doesn't exist is remembered, so it isn't opened again every time it is asked for - any
+    // other failure is tried again the next time.
+    // The reader stays open for as long as it is held, even past the pool.
+    std::shared_ptr<FileReader const> Acquire(FileId file);
+
+    std::size_t GetOpenFileCount() const;
+    std::uint64_t GetMappedByteCount() const;
+
+private:
+    struct File
+    {
+        std::string m_Path;
+        FileReadOptions m_Options;
+        std::shared_ptr<FileReader> m_Reader;
+        bool m_Missing = false;
+
+        // This file's position in m_LeastRecentlyUsed - only valid while it is open.
+        std::list<FileId>::iterator m_Use;
+    };
+
+    // Closes the least recently used files which aren't in use until the pool is within the given budgets, or only
+    // files in use are left.
+    void Trim(std::size_t maxOpenFiles, std::uint64_t maxMappedBytes);
+
+    mutable std::mutex m_Mutex;
+
+    std::vector<File> m_Files;
+    // Every file registered with each path, one for each set of options.
+    std::map<std::string, std::vector<FileId>> m_FileIds;
+
+    // The open files, most recently used first.
+    std::list<FileId> m_LeastRecentlyUsed;
+
+    std::size_t m_MaxOpenFiles;
+    std::uint64_t m_MaxMappedBytes;
+    std::uint64_t m_MappedBytes;
+
+    FileReadOptions m_DefaultOptions;
+};
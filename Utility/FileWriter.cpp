@@ -0,0 +1,129 @@
+#include "Utility/FileWriter.hpp"
+#include "Utility/Assert.hpp"
+
+#include <filesystem>
+#include <random>
+#include <string>
+
+#if OS_LINUX
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <limits.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+
+    #include <algorithm>
+    #include <vector>
+#else
+    #include <cstdio>
+#endif
+
+bool WriteBuffersToFile(char const* path, WriteBuffer const* buffers, std::size_t bufferCount)
+{
+    ASSERT(path);
+    ASSERT(buffers || !bufferCount);
+
+#if OS_LINUX
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    std::vector<iovec> iovecs;
+    iovecs.reserve(bufferCount);
+
+    for (std::size_t i = 0; i < bufferCount; ++i)
+    {
+        if (buffers[i].m_Length)
+        {
+            iovecs.push_back({ const_cast<void*>(buffers[i].m_Data), buffers[i].m_Length });
+        }
+    }
+
+    // writev may write less than asked for (and is limited to IOV_MAX buffers per call), so keep going until
+    // everything has been consumed.
+    iovec* next = iovecs.data();
+    iovec* end = iovecs.data() + iovecs.size();
+    bool success = true;
+
+    while (next != end)
+    {
+        int count = static_cast<int>(std::min<std::ptrdiff_t>(end - next, IOV_MAX));
+        ssize_t written = writev(fd, next, count);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            success = false;
+            break;
+        }
+
+        std::size_t remaining = static_cast<std::size_t>(written);
+
+        while (next != end && remaining >= next->iov_len)
+        {
+            remaining -= next->iov_len;
+            ++next;
+        }
+
+        if (next != end)
+        {
+            next->iov_base = static_cast<char*>(next->iov_base) + remaining;
+            next->iov_len -= remaining;
+        }
+    }
+
+    return close(fd) == 0 && success;
+#else
+    FILE* outFile = std::fopen(path, "wb");
+
+    if (!outFile)
+    {
+        return false;
+    }
+
+    bool success = true;
+
+    for (std::size_t i = 0; i < bufferCount; ++i)
+    {
+        if (buffers[i].m_Length && std::fwrite(buffers[i].m_Data, buffers[i].m_Length, 1, outFile) != 1)
+        {
+            success = false;
+            break;
+        }
+    }
+
+    return std::fclose(outFile) == 0 && success;
+#endif
+}
+
+bool ReplaceFileWithBuffers(char const* path, WriteBuffer const* buffers, std::size_t bufferCount)
+{
+    ASSERT(path);
+
+    std::string temporaryPath = std::string(path) + "." + std::to_string(std::random_device()()) + ".tmp";
+
+    if (!WriteBuffersToFile(temporaryPath.c_str(), buffers, bufferCount))
+    {
+        std::error_code error;
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+// A buffer to be written as part of WriteBuffersToFile.
+struct WriteBuffer
+{
+    void const* m_Data;
+    std::size_t m_Length;
+};
+
+// Creates (or truncates) the file at path and writes each of the buffers to it, in order.
+// Where the platform supports it, this is a single vectored write (writev) rather than one write per buffer.
+// Returns false if the file could not be opened or fully written.
+bool WriteBuffersToFile(char const* path, WriteBuffer const* buffers, std::size_t bufferCount);
+
+// As WriteBuffersToFile, except that the buffers are written to a temporary file next to path, which is then renamed
+// over it. Anything with the old file open or mapped keeps seeing the old contents, and nothing ever sees a partly
+// written file - so this is safe to use when the buffers point into a mapping of the file being replaced.
+bool ReplaceFileWithBuffers(char const* path, WriteBuffer const* buffers, std::size_t bufferCount);
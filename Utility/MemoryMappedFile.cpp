@@ -3,16 +3,42 @@
 #include "Utility/MemoryMappedFile_impl.hpp"
 
 MemoryMappedFile::MemoryMappedFile() { }
-MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs) : m_DataBlock(std::move(rhs.m_DataBlock)), m_PlatformImpl(std::move(rhs.m_PlatformImpl)) { }
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs) : m_DataBlock(std::move(rhs.m_DataBlock)), m_Writable(rhs.m_Writable), m_PlatformImpl(std::move(rhs.m_PlatformImpl)) { }
 MemoryMappedFile::~MemoryMappedFile() { }
 
-bool MemoryMappedFile::MemoryMap(char const* path, MemoryMappedFile* out)
+bool MemoryMappedFile::MemoryMap(char const* path, MemoryMappedFile* out, MemoryMapHints const& hints)
+{
+    return MemoryMapRange(path, 0, ToEndOfFile, out, hints);
+}
+
+bool MemoryMappedFile::MemoryMapRange(char const* path, std::uint64_t offset, std::uint64_t length,
+    MemoryMappedFile* out, MemoryMapHints const& hints)
+{
+    out->m_PlatformImpl = std::make_unique<MemoryMappedFile_impl>();
+    out->m_Writable = false;
+    return out->m_PlatformImpl->Map(path, false, offset, length, hints, &out->m_DataBlock);
+}
+
+bool MemoryMappedFile::MemoryMapWritable(char const* path, MemoryMappedFile* out)
 {
     out->m_PlatformImpl = std::make_unique<MemoryMappedFile_impl>();
-    return out->m_PlatformImpl->Map(path, &out->m_DataBlock);
+    out->m_Writable = true;
+    return out->m_PlatformImpl->Map(path, true, 0, ToEndOfFile, MemoryMapHints(), &out->m_DataBlock);
 }
 
 NonOwningDataBlock const& MemoryMappedFile::GetDataBlock()
 {
     return m_DataBlock;
 }
+
+std::byte* MemoryMappedFile::GetWritableData()
+{
+    // The data block is const because it's shared with the read only path - the mapping itself is writable.
+    return m_Writable ? const_cast<std::byte*>(m_DataBlock.m_Data) : nullptr;
+}
+
+bool MemoryMappedFile::Flush()
+{
+    ASSERT(m_PlatformImpl);
+    return !m_Writable || m_PlatformImpl->Flush();
+}
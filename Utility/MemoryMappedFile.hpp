@@ -3,24 +3,75 @@
 #include "Utility/DataBlock.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 
 class MemoryMappedFile_impl;
 
-// This class wraps memory-mapped read only access to a file.
-// This will map the entire range of the file (0 -> fileSize) into a memory rage represented by GetDataBlock().
-// This can later be expanded to support spans within the file and writing too.
+// How a mapping is going to be read, so the OS can read ahead of it (or not) to suit.
+enum class MemoryMapAccess
+{
+    Normal,
+    Sequential, // Read from front to back once, as when extracting an archive.
+    Random // Read in small pieces from all over, as when looking resources up.
+};
+
+enum class MemoryMapPrefetch
+{
+    None, // Pages are read from disk as they are first touched.
+    Background, // Reading the whole range starts straight away, without waiting for it to finish.
+    Now // The whole range is read before the mapping is returned.
+};
+
+// Hints which change how a mapping performs, but never what is read through it. Any the OS doesn't support are
+// ignored.
+struct MemoryMapHints
+{
+    MemoryMapAccess m_Access = MemoryMapAccess::Normal;
+    MemoryMapPrefetch m_Prefetch = MemoryMapPrefetch::None;
+
+    // Back the mapping with huge pages, where the OS can do so for files. This saves on TLB misses when a large
+    // mapping is read all over.
+    bool m_HugePages = false;
+};
+
+// This class wraps memory-mapped access to a file.
+// By default this will map the entire range of the file (0 -> fileSize) into a memory rage represented by
+// GetDataBlock(). MemoryMapRange maps only part of it, in which case GetDataBlock() covers just that part.
+// The mapping is read only unless it was created with MemoryMapWritable, in which case writes through
+// GetWritableData() go straight to the file.
 class MemoryMappedFile
 {
 public:
+    // Passed as the length to MemoryMapRange to map everything from the offset onwards.
+    static constexpr std::uint64_t ToEndOfFile = ~0ull;
+
     MemoryMappedFile();
     MemoryMappedFile(MemoryMappedFile&& rhs);
     ~MemoryMappedFile();
 
-    static bool MemoryMap(char const* path, MemoryMappedFile* out);
+    static bool MemoryMap(char const* path, MemoryMappedFile* out, MemoryMapHints const& hints = MemoryMapHints());
+
+    // Maps length bytes of the file from offset - the tables at the front of an archive, say, or a single resource.
+    // The length is clamped to the end of the file. Fails if the offset is past the end, or the range is empty.
+    // The offset needn't be aligned to anything: the mapping is widened to the page below it internally.
+    static bool MemoryMapRange(char const* path, std::uint64_t offset, std::uint64_t length, MemoryMappedFile* out,
+        MemoryMapHints const& hints = MemoryMapHints());
+
+    // Maps the file for reading and writing. The mapping is shared with the file, so the size can't change, but any
+    // byte within it can be modified in place.
+    static bool MemoryMapWritable(char const* path, MemoryMappedFile* out);
+
     NonOwningDataBlock const& GetDataBlock();
 
+    // Returns the start of the mapping, or nullptr if the file was mapped read only.
+    std::byte* GetWritableData();
+
+    // Blocks until every write made through GetWritableData() has reached the disk.
+    bool Flush();
+
 private:
     NonOwningDataBlock m_DataBlock;
+    bool m_Writable = false;
     std::unique_ptr<MemoryMappedFile_impl> m_PlatformImpl;
 };
@@ -1,6 +1,8 @@
 #include "MemoryMappedFile_impl.hpp"
 #include "Utility/Assert.hpp"
 
+#include <algorithm>
+
 #if OS_LINUX
     #include <fcntl.h>
     #include <sys/mman.h>
@@ -12,7 +14,7 @@ MemoryMappedFile_impl::MemoryMappedFile_impl()
 #if OS_WINDOWS
     : m_File(INVALID_HANDLE_VALUE), m_MemoryMap(INVALID_HANDLE_VALUE), m_Ptr(NULL)
 #else
-    : m_FileDescriptor(-1), m_Ptr(nullptr), m_PtrLength(0)
+    : m_Ptr(nullptr), m_PtrLength(0)
 #endif
 { }
 
@@ -34,68 +36,159 @@ MemoryMappedFile_impl::~MemoryMappedFile_impl()
         CloseHandle(m_File);
     }
 #else
-    if (m_Ptr == MAP_FAILED)
+    if (m_Ptr && m_Ptr != MAP_FAILED)
     {
         munmap(m_Ptr, m_PtrLength);
     }
-
-    if (m_FileDescriptor != -1)
-    {
-        close(m_FileDescriptor);
-    }
 #endif
 }
 
-bool MemoryMappedFile_impl::Map(char const* path, NonOwningDataBlock* out)
+bool MemoryMappedFile_impl::Map(char const* path, bool writable, std::uint64_t offset, std::uint64_t length,
+    MemoryMapHints const& hints, NonOwningDataBlock* out)
 {
     ASSERT(path);
     ASSERT(out);
 
+    // Nothing can be mapped for an empty range, wherever it starts.
+    if (length == 0)
+    {
+        return false;
+    }
+
 #if OS_WINDOWS
-    m_File = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    DWORD access = writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    DWORD attributes = FILE_ATTRIBUTE_NORMAL;
+
+    if (hints.m_Access == MemoryMapAccess::Sequential)
+    {
+        attributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+    }
+    else if (hints.m_Access == MemoryMapAccess::Random)
+    {
+        attributes |= FILE_FLAG_RANDOM_ACCESS;
+    }
+
+    m_File = CreateFile(path, access, FILE_SHARE_READ, NULL, OPEN_EXISTING, attributes, NULL);
     if (m_File == INVALID_HANDLE_VALUE)
     {
         return false;
     }
 
-    m_MemoryMap = CreateFileMapping(m_File, NULL, PAGE_READONLY, 0, 0, NULL);
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_File, &fileSize) || offset >= static_cast<std::uint64_t>(fileSize.QuadPart))
+    {
+        return false;
+    }
+
+    length = (std::min)(length, static_cast<std::uint64_t>(fileSize.QuadPart) - offset);
+
+    // Views have to start on a multiple of the allocation granularity.
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    std::uint64_t alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+    std::size_t viewLength = static_cast<std::size_t>(length + (offset - alignedOffset));
+
+    m_MemoryMap = CreateFileMapping(m_File, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
     if (m_MemoryMap == INVALID_HANDLE_VALUE)
     {
         return false;
     }
 
-    m_Ptr = MapViewOfFile(m_MemoryMap, FILE_MAP_READ, 0, 0, 0);
+    m_Ptr = MapViewOfFile(m_MemoryMap, writable ? FILE_MAP_WRITE : FILE_MAP_READ,
+        static_cast<DWORD>(alignedOffset >> 32), static_cast<DWORD>(alignedOffset), viewLength);
     if (!m_Ptr)
     {
         return false;
     }
 
-    out->m_Data = static_cast<std::byte*>(m_Ptr);
-    out->m_DataLength = GetFileSize(m_File, NULL);
+    // Windows has no way to wait for a prefetch, so both kinds start one in the background.
+    if (hints.m_Prefetch != MemoryMapPrefetch::None)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range = { m_Ptr, viewLength };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    out->m_Data = static_cast<std::byte*>(m_Ptr) + (offset - alignedOffset);
+    out->m_DataLength = static_cast<std::size_t>(length);
 #else
-    m_FileDescriptor = open(path, O_RDONLY);
-    if (m_FileDescriptor == -1)
+    int fileDescriptor = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fileDescriptor == -1)
     {
         return false;
     }
 
     struct stat statBuffer;
-    if (stat(path, &statBuffer) == -1)
+    if (fstat(fileDescriptor, &statBuffer) == -1 || offset >= static_cast<std::uint64_t>(statBuffer.st_size))
     {
+        close(fileDescriptor);
         return false;
     }
 
-    m_PtrLength = statBuffer.st_size;
-    m_Ptr = mmap(nullptr, m_PtrLength, PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0);
+    length = std::min(length, static_cast<std::uint64_t>(statBuffer.st_size) - offset);
+
+    // Mappings have to start on a page boundary.
+    std::uint64_t pageSize = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+    std::uint64_t alignedOffset = offset - offset % pageSize;
+    m_PtrLength = static_cast<std::size_t>(length + (offset - alignedOffset));
+
+    // Writable mappings are shared so that writes land in the file rather than in a private copy.
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    int flags = writable ? MAP_SHARED : MAP_PRIVATE;
+
+    #if defined(MAP_POPULATE)
+    if (hints.m_Prefetch == MemoryMapPrefetch::Now)
+    {
+        flags |= MAP_POPULATE;
+    }
+    #endif
+
+    m_Ptr = mmap(nullptr, m_PtrLength, protection, flags, fileDescriptor, static_cast<off_t>(alignedOffset));
+
+    // The mapping keeps its own reference to the file - msync doesn't need the descriptor either - so there's no
+    // reason to hold on to one for as long as the mapping lives.
+    close(fileDescriptor);
 
     if (m_Ptr == MAP_FAILED)
     {
         return false;
     }
 
-    out->m_Data = static_cast<std::byte*>(m_Ptr);
-    out->m_DataLength = m_PtrLength;
+    // These are only hints, so a kernel which turns them down has done nothing wrong.
+    if (hints.m_Access == MemoryMapAccess::Sequential)
+    {
+        madvise(m_Ptr, m_PtrLength, MADV_SEQUENTIAL);
+    }
+    else if (hints.m_Access == MemoryMapAccess::Random)
+    {
+        madvise(m_Ptr, m_PtrLength, MADV_RANDOM);
+    }
+
+    if (hints.m_Prefetch == MemoryMapPrefetch::Background)
+    {
+        madvise(m_Ptr, m_PtrLength, MADV_WILLNEED);
+    }
+
+    #if defined(MADV_HUGEPAGE)
+    // Only takes for files where the kernel has huge page support for the page cache (CONFIG_READ_ONLY_THP_FOR_FS),
+    // and only for the parts of the mapping which are aligned to a huge page.
+    if (hints.m_HugePages)
+    {
+        madvise(m_Ptr, m_PtrLength, MADV_HUGEPAGE);
+    }
+    #endif
+
+    out->m_Data = static_cast<std::byte*>(m_Ptr) + (offset - alignedOffset);
+    out->m_DataLength = static_cast<std::size_t>(length);
 #endif
 
     return true;
 }
+
+bool MemoryMappedFile_impl::Flush()
+{
+#if OS_WINDOWS
+    return FlushViewOfFile(m_Ptr, 0) && FlushFileBuffers(m_File);
+#else
+    return msync(m_Ptr, m_PtrLength, MS_SYNC) == 0;
+#endif
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Utility/DataBlock.hpp"
+#include "Utility/MemoryMappedFile.hpp"
 
 #if OS_WINDOWS
     #include "Windows.h"
@@ -18,7 +19,10 @@ public:
     MemoryMappedFile_impl();
     ~MemoryMappedFile_impl();
 
-    bool Map(char const* path, NonOwningDataBlock* out);
+    // Maps [offset, offset + length) of the file, clamping the length to the end of the file.
+    bool Map(char const* path, bool writable, std::uint64_t offset, std::uint64_t length, MemoryMapHints const& hints,
+        NonOwningDataBlock* out);
+    bool Flush();
 
 private:
 
@@ -27,7 +31,6 @@ private:
     HANDLE m_MemoryMap;
     LPVOID m_Ptr;
 #else
-    int m_FileDescriptor;
     void* m_Ptr;
     std::size_t m_PtrLength;
 #endif
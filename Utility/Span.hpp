@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+// This describes a typed, non-owning range of contiguous elements - a stand-in for std::span<T> until we move to C++20.
+// Like NonOwningDataBlock, whoever hands one of these out is responsible for keeping the memory alive.
+//
+// The accessors deliberately mirror std::vector (data / size / operator[] / begin / end) so that code which
+// only reads a section can be written once and used against either a vector or a span.
+template <typename T>
+struct Span
+{
+    // The first element. This is a NON-OWNING pointer.
+    T* m_Data = nullptr;
+
+    // The number of elements (not bytes).
+    std::size_t m_Count = 0;
+
+    T* data() const { return m_Data; }
+    std::size_t size() const { return m_Count; }
+    bool empty() const { return m_Count == 0; }
+
+    T& operator[](std::size_t index) const { return m_Data[index]; }
+
+    T* begin() const { return m_Data; }
+    T* end() const { return m_Data + m_Count; }
+};
@@ -0,0 +1,153 @@
+#include "Utility/ThreadPool.hpp"
+#include "Utility/Assert.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+// Shared between the caller of ParallelFor and the tasks it submits. A task may not start until after the caller has
+// returned, so the state is reference counted - but by then every range has been claimed, so the task never
+// touches the body.
+struct ParallelForState
+{
+    std::size_t m_Count;
+    std::size_t m_GrainSize;
+    std::function<void(std::size_t, std::size_t)> const* m_Body;
+
+    std::atomic<std::size_t> m_NextBegin { 0 };
+    std::atomic<std::size_t> m_Completed { 0 };
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Done;
+};
+
+void RunRanges(ParallelForState& state)
+{
+    while (true)
+    {
+        std::size_t begin = state.m_NextBegin.fetch_add(state.m_GrainSize);
+        if (begin >= state.m_Count)
+        {
+            return;
+        }
+
+        std::size_t end = std::min(begin + state.m_GrainSize, state.m_Count);
+        (*state.m_Body)(begin, end);
+
+        if (state.m_Completed.fetch_add(end - begin) + (end - begin) == state.m_Count)
+        {
+            std::lock_guard<std::mutex> lock(state.m_Mutex);
+            state.m_Done.notify_all();
+        }
+    }
+}
+
+}
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    m_Threads.reserve(threadCount);
+
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        m_Threads.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+
+    m_TaskAvailable.notify_all();
+
+    for (std::thread& thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+unsigned ThreadPool::GetThreadCount() const
+{
+    return static_cast<unsigned>(m_Threads.size());
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    ASSERT(task);
+
+    if (m_Threads.empty())
+    {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tasks.emplace_back(std::move(task));
+    }
+
+    m_TaskAvailable.notify_one();
+}
+
+void ThreadPool::ParallelFor(std::size_t count, std::size_t grainSize, std::function<void(std::size_t, std::size_t)> const& body)
+{
+    ASSERT(grainSize);
+
+    std::size_t rangeCount = (count + grainSize - 1) / grainSize;
+
+    if (rangeCount <= 1 || m_Threads.empty())
+    {
+        if (count)
+        {
+            body(0, count);
+        }
+
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->m_Count = count;
+    state->m_GrainSize = grainSize;
+    state->m_Body = &body;
+
+    // The calling thread takes ranges too, so one helper fewer than there are ranges is enough.
+    std::size_t helperCount = std::min<std::size_t>(m_Threads.size(), rangeCount - 1);
+
+    for (std::size_t i = 0; i < helperCount; ++i)
+    {
+        Submit([state]() { RunRanges(*state); });
+    }
+
+    RunRanges(*state);
+
+    std::unique_lock<std::mutex> lock(state->m_Mutex);
+    state->m_Done.wait(lock, [&state]() { return state->m_Completed.load() == state->m_Count; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_TaskAvailable.wait(lock, [this]() { return m_Stopping || !m_Tasks.empty(); });
+
+            if (m_Tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(m_Tasks.front());
+            m_Tasks.pop_front();
+        }
+
+        task();
+    }
+}
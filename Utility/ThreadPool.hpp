@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads which run queued tasks in the order they were submitted.
+// The pool is meant to be created once and shared - starting threads costs far more than most of the work given to them.
+class ThreadPool
+{
+public:
+    // Starts threadCount workers. A pool with no workers runs everything on the calling thread.
+    explicit ThreadPool(unsigned threadCount = std::thread::hardware_concurrency());
+
+    // Runs any tasks still queued, then joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    unsigned GetThreadCount() const;
+
+    // Queues the task to run on a worker, or runs it immediately if there are no workers.
+    void Submit(std::function<void()> task);
+
+    // Calls body(begin, end) for consecutive ranges of at most grainSize covering [0, count), spread across the
+    // workers and the calling thread, and returns once every range is done. Which thread runs which range is not
+    // fixed, so body must only write to state belonging to its own range.
+    //
+    // This can be called from within a task, including from within another ParallelFor: the calling thread works
+    // through any ranges no worker has picked up, so it never waits on a task that hasn't started.
+    void ParallelFor(std::size_t count, std::size_t grainSize, std::function<void(std::size_t, std::size_t)> const& body);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_Threads;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_TaskAvailable;
+    std::deque<std::function<void()>> m_Tasks;
+    bool m_Stopping = false;
+};